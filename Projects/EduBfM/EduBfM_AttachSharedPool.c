@@ -0,0 +1,344 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_AttachSharedPool.c
+ *
+ * Description :
+ *  Place the buffer pools in a named POSIX shared memory segment.
+ *
+ * Exports:
+ *  Four EduBfM_AttachSharedPool(char *)
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* how long an attaching process waits for the creator to initialize the segment */
+#define BFM_SHAREDSEGMENT_WAIT_NSEC     1000000     /* 1 msec */
+#define BFM_SHAREDSEGMENT_WAIT_COUNT    5000
+
+/* Macro: BFM_ALIGN_UP(x, a)
+ * Description: round 'x' up to the multiple of 'a'
+ */
+#define BFM_ALIGN_UP(x, a)      ((((x) + (a) - 1) / (a)) * (a))
+
+
+/*@================================
+ * edubfm_InitSharedSegment()
+ *================================*/
+/*
+ * Function: static Four edubfm_InitSharedSegment(BfMSharedSegment*, size_t)
+ *
+ * Description :
+ *  Initialize a newly created shared segment; the latches are made
+ *  process-shared and robust, and all the buffer elements are emptied.
+ *  The magic number is set last so that the attaching processes can
+ *  see when the initialization is done.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXINITFAILED_BFM - latch initialization failed
+ */
+static Four edubfm_InitSharedSegment(
+    BfMSharedSegment    *seg,           /* IN segment to initialize */
+    size_t              size)           /* IN size of the segment */
+{
+    pthread_mutexattr_t attr;           /* attribute of the latches */
+    BfMSharedPoolHdr    *hdr;           /* header for a buffer type */
+    BufferTable         *bufTable;      /* buffer table in the segment */
+    Two                 *hashTable;     /* hash table in the segment */
+    pthread_mutex_t     *frameLatch;    /* frame latches in the segment */
+    Four                type;           /* buffer type */
+    Four                i;              /* index */
+
+
+    if (pthread_mutexattr_init(&attr) != 0) ERR(eMUTEXINITFAILED_BFM);
+    if (pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) != 0 ||
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) != 0) {
+        pthread_mutexattr_destroy(&attr);
+        ERR(eMUTEXINITFAILED_BFM);
+    }
+
+    seg->nAttached = 0;
+    seg->suspect = FALSE;
+    seg->size = size;
+    if (pthread_mutex_init(&(seg->attachLatch), &attr) != 0) {
+        pthread_mutexattr_destroy(&attr);
+        ERR(eMUTEXINITFAILED_BFM);
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        hdr = &(seg->pool[type]);
+        if (pthread_mutex_init(&(hdr->poolLatch), &attr) != 0) {
+            pthread_mutexattr_destroy(&attr);
+            ERR(eMUTEXINITFAILED_BFM);
+        }
+        hdr->nextVictim = 0;
+
+        bufTable = (BufferTable*)((char*)seg + hdr->bufTableOffset);
+        frameLatch = (pthread_mutex_t*)((char*)seg + hdr->frameLatchOffset);
+        for (i = 0; i < hdr->nBufs; i++) {
+            SET_NILBFMHASHKEY(bufTable[i].key);
+            bufTable[i].fixed = 0;
+            bufTable[i].bits = ALL_0;
+            bufTable[i].generation = 0;
+            bufTable[i].nextHashEntry = NIL;
+            if (pthread_mutex_init(&frameLatch[i], &attr) != 0) {
+                pthread_mutexattr_destroy(&attr);
+                ERR(eMUTEXINITFAILED_BFM);
+            }
+        }
+
+        hashTable = (Two*)((char*)seg + hdr->hashTableOffset);
+        for (i = 0; i < HASHTABLESIZE_TO_NBUFS(hdr->nBufs); i++)
+            hashTable[i] = NIL;
+    }
+
+    pthread_mutexattr_destroy(&attr);
+
+    __atomic_store_n(&(seg->magic), BFM_SHAREDSEGMENT_MAGIC, __ATOMIC_RELEASE);
+
+    return(eNOERROR);
+
+}  /* edubfm_InitSharedSegment() */
+
+
+
+/*@================================
+ * EduBfM_AttachSharedPool()
+ *================================*/
+/*
+ * Function: Four EduBfM_AttachSharedPool(char*)
+ *
+ * Description :
+ *  Place the buffer table, the hash table and the buffer pool of every
+ *  buffer type in the POSIX shared memory segment named 'name'
+ *  (e.g. "/educosmos_bfm"). The first process creates and initializes the
+ *  segment; the others attach the existing one, so all processes on a host
+ *  which use the same name share one cache of the volumes.
+ *  The private buffer pools of the process are flushed and set aside; they
+ *  are used again after EduBfM_DetachSharedPool().
+ *  This function must be called while no train is fixed, and
+ *  EduBfM_DetachSharedPool() must be called before the storage system is
+ *  finalized. The pages written to the RAM backend would never be seen
+ *  by the other processes, so the pool cannot be shared while it is used.
+ *
+ * Returns:
+ *  error code
+ *    eBADSHAREDPOOLNAME_EDUBFM - bad segment name
+ *    eSHAREDPOOLATTACHED_EDUBFM - the shared segment is already attached
+ *    eSHAREDPOOLMISMATCH_EDUBFM - the segment was created with other pool sizes
+ *    eRAMSTORAGEUSED_EDUBFM - the RAM backend is used
+ *    eFLUSHFIXEDBUF_BFM - some train is fixed in the private buffer pool
+ *    eSHMGETFAILED_BFM - shm_open() failed
+ *    eSHMCTLFAILED_BFM - sizing the segment failed
+ *    eSHMATFAILED_BFM - mapping the segment failed
+ *    some errors caused by function calls
+ */
+Four EduBfM_AttachSharedPool(
+    char                *name)          /* IN name of the shared segment */
+{
+    Four                e;              /* for error */
+    Four                fd;             /* file descriptor of the segment */
+    Boolean             isCreator;      /* TRUE if this process created the segment */
+    BfMSharedSegment    layout;         /* expected layout of the segment */
+    BfMSharedSegment    *seg;           /* mapped segment */
+    size_t              size;           /* size of the segment */
+    struct stat         st;             /* status of the segment */
+    struct timespec     wait;           /* time to wait for the creator */
+    Four                type;           /* buffer type */
+    Four                i;              /* index */
+
+
+    /*@ check the parameters */
+    if (name == NULL || name[0] != '/' || strlen(name) >= BFM_SHAREDSEGMENT_NAMELEN)
+        ERR(eBADSHAREDPOOLNAME_EDUBFM);
+
+    if (IS_SHARED_BUFFERPOOL()) ERR(eSHAREDPOOLATTACHED_EDUBFM);
+
+    if (edubfm_IsRamStorage()) ERR(eRAMSTORAGEUSED_EDUBFM);
+
+    /*@ no pointer to the private buffers may be alive; the buffers read ahead are unfixed once completed */
+    edubfm_DrainReadAhead();
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) ERR(eFLUSHFIXEDBUF_BFM);
+
+    e = EduBfM_FlushAll();
+    if (e < 0) ERR(e);
+
+    /*@ compute the layout of the segment */
+    size = BFM_ALIGN_UP(sizeof(BfMSharedSegment), PAGESIZE);
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        layout.pool[type].nBufs = BI_NBUFS(type);
+        layout.pool[type].bufSize = BI_BUFSIZE(type);
+
+        layout.pool[type].bufTableOffset = size;
+        size += BFM_ALIGN_UP(sizeof(BufferTable) * BI_NBUFS(type), sizeof(long));
+        layout.pool[type].hashTableOffset = size;
+        size += BFM_ALIGN_UP(sizeof(Two) * HASHTABLESIZE(type), sizeof(long));
+        layout.pool[type].frameLatchOffset = size;
+        size += sizeof(pthread_mutex_t) * BI_NBUFS(type);
+        layout.pool[type].versionTableOffset = size;
+        size += BFM_ALIGN_UP(sizeof(UFour) * BI_NBUFS(type), sizeof(long));
+
+        size = BFM_ALIGN_UP(size, PAGESIZE);
+        layout.pool[type].bufferPoolOffset = size;
+        size += (size_t)PAGESIZE * BI_BUFSIZE(type) * BI_NBUFS(type);
+    }
+
+    /*@ create or open the segment */
+    isCreator = TRUE;
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        isCreator = FALSE;
+        fd = shm_open(name, O_RDWR, 0600);
+    }
+    if (fd < 0) ERR(eSHMGETFAILED_BFM);
+
+    wait.tv_sec = 0;
+    wait.tv_nsec = BFM_SHAREDSEGMENT_WAIT_NSEC;
+
+    if (isCreator) {
+        if (ftruncate(fd, size) < 0) {
+            close(fd);
+            shm_unlink(name);
+            ERR(eSHMCTLFAILED_BFM);
+        }
+    }
+    else {
+        /* the creator may not have sized the segment yet */
+        for (i = 0; ; i++) {
+            if (fstat(fd, &st) < 0) {
+                close(fd);
+                ERR(eSHMCTLFAILED_BFM);
+            }
+            if (st.st_size > 0) break;
+            if (i == BFM_SHAREDSEGMENT_WAIT_COUNT) {
+                close(fd);
+                ERR(eSHMATFAILED_BFM);
+            }
+            nanosleep(&wait, NULL);
+        }
+        if ((size_t)st.st_size != size) {
+            close(fd);
+            ERR(eSHAREDPOOLMISMATCH_EDUBFM);
+        }
+    }
+
+    seg = (BfMSharedSegment*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        if (isCreator) shm_unlink(name);
+        ERR(eSHMATFAILED_BFM);
+    }
+
+    if (isCreator) {
+        for (type = 0; type < NUM_BUF_TYPES; type++)
+            seg->pool[type] = layout.pool[type];
+
+        e = edubfm_InitSharedSegment(seg, size);
+        if (e < 0) {
+            munmap(seg, size);
+            shm_unlink(name);
+            ERR(e);
+        }
+    }
+    else {
+        for (i = 0; __atomic_load_n(&(seg->magic), __ATOMIC_ACQUIRE) != BFM_SHAREDSEGMENT_MAGIC; i++) {
+            if (i == BFM_SHAREDSEGMENT_WAIT_COUNT) {
+                munmap(seg, size);
+                ERR(eSHMATFAILED_BFM);
+            }
+            nanosleep(&wait, NULL);
+        }
+
+        for (type = 0; type < NUM_BUF_TYPES; type++) {
+            if (seg->pool[type].nBufs != layout.pool[type].nBufs ||
+                seg->pool[type].bufSize != layout.pool[type].bufSize ||
+                seg->pool[type].bufferPoolOffset != layout.pool[type].bufferPoolOffset) {
+                munmap(seg, size);
+                ERR(eSHAREDPOOLMISMATCH_EDUBFM);
+            }
+        }
+    }
+
+    /*@ register this process */
+    if (pthread_mutex_lock(&(seg->attachLatch)) == EOWNERDEAD)
+        pthread_mutex_consistent(&(seg->attachLatch));
+    seg->nAttached++;
+    pthread_mutex_unlock(&(seg->attachLatch));
+
+    /*@ set the private buffer pools aside and use the shared ones */
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        edubfm_privateBufInfo[type] = bufInfo[type];
+
+        bufInfo[type].bufTable = (BufferTable*)((char*)seg + seg->pool[type].bufTableOffset);
+        bufInfo[type].hashTable = (Two*)((char*)seg + seg->pool[type].hashTableOffset);
+        bufInfo[type].bufferPool = (char*)seg + seg->pool[type].bufferPoolOffset;
+        edubfm_versionTable[type] = (UFour*)((char*)seg + seg->pool[type].versionTableOffset);
+    }
+
+    strcpy(edubfm_sharedSegmentName, name);
+    edubfm_sharedSegment = seg;
+    edubfm_poolEpoch++;
+
+    return(eNOERROR);
+
+}  /* EduBfM_AttachSharedPool() */
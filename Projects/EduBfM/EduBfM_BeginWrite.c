@@ -0,0 +1,113 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_BeginWrite.c
+ *
+ * Description: 
+ *  Tell the optimistic readers that a train is about to be modified.
+ * 
+ * Exports:
+ *  Four EduBfM_BeginWrite(TrainID*, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_BeginWrite()
+ *================================*/
+/*
+ * Function: Four EduBfM_BeginWrite(TrainID*, Four)
+ *
+ * Description: 
+ *  Make the version of the buffer holding the train odd before the caller
+ *  modifies the train, so that the optimistic readers of the train (see
+ *  EduBfM_GetTrainOptimistic()) do not get it and those already reading it
+ *  fail their validation. The caller must have the train fixed, and must
+ *  call EduBfM_EndWrite() when the modification is done; the writers of a
+ *  train are serialized by the caller.
+ *  Merely fixing a train does not keep the optimistic readers away.
+ * 
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eNOTFOUND_BFM - the train is not in the buffer pool
+ *    some errors caused by function calls
+ */
+Four EduBfM_BeginWrite(
+    TrainID             *trainId,               /* IN train to be modified */
+    Four                type )                  /* IN buffer type */
+{
+    Four                index;                  /* an index of the buffer table & pool */
+    Four                e;                      /* for error */
+
+
+    /*@ Is the paramter valid? */
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    e = edubfm_LatchPool(type);
+    if ( e < 0 ) ERR( e );
+
+    index = edubfm_LookUp(trainId, type);
+    if ( index == NOTFOUND_IN_HTABLE ) {
+        edubfm_UnlatchPool(type);
+        ERR( eNOTFOUND_BFM );
+    }
+
+    BI_BEGINCHANGE(type, index);
+
+    e = edubfm_UnlatchPool(type);
+    if ( e < 0 ) ERR( e );
+
+    return( eNOERROR );
+
+}  /* EduBfM_BeginWrite */
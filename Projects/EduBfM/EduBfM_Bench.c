@@ -0,0 +1,796 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Bench.c
+ *
+ * Description : 
+ *  Benchmarks of the extensions of EduBfM. The program is built by
+ *  'make bench' by linking this module in place of EduBfM_Test.o, and
+ *  prints one table per benchmark.
+ *  - striping: sequential reads of long trains with read-ahead on an
+ *    emulated HDD, from the volume and striped over 1, 2 and 4 device
+ *    files, with and without the worker threads of the I/O engine.
+ *    The delay backend emulates one device queue for the volume and one
+ *    for each device file, so the reads of the workers overlap only
+ *    across devices: the throughput grows with the number of devices
+ *    when the workers are used, and not without them.
+ *  - file I/O: the same reads from device files on the disk, without the
+ *    delay backend and with the page cache of the host dropped, done by
+ *    preadv() one at a time, through an io_uring, and by the workers.
+ *  - compression: the compression ratio of trains of table-like lines,
+ *    the disk space they take in the volume and in the side file, and
+ *    the throughput of scanning them from the file without the delay
+ *    backend, i.e. mostly from the page cache of the host, so that the
+ *    cost of decompressing the pages shows against plain reads.
+ *  - optimistic reads: reads of a few hot trains in a shared buffer pool
+ *    by 1, 2 and 4 threads, each fixing and freeing the trains, and each
+ *    reading them by EduBfM_GetTrainOptimistic() without the pool latch.
+ *
+ * Exports:
+ *  Four EduBfM_Test(Four)
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+#include "EduBfM_basictypes.h"
+#include "EduBfM_TestModule.h"
+
+
+/*@ Constant definitions */
+#define BENCH_NTRAINS           64      /* # of trains read by the striping benchmark */
+#define BENCH_READAHEAD         64      /* read-ahead window (unit: # of trains) */
+#define BENCH_NTHREADS          4       /* # of worker threads of the I/O engine */
+#define BENCH_NSCANS            20      /* # of scans of the compression benchmark */
+#define BENCH_NFILEREADS        5       /* # of reads of each mode of the file I/O benchmark */
+#define BENCH_SIDEFILE          "bench_compress.side"   /* side file of the compression benchmark */
+#define BENCH_SHMNAME           "/edubfm_bench"         /* shared segment of the optimistic read benchmark */
+#define BENCH_NHOTTRAINS        4       /* # of trains read by the optimistic read benchmark */
+#define BENCH_NHOTREADS         1000000 /* # of reads of each thread of the optimistic read benchmark */
+#define BENCH_MAXREADERS        4       /* max. # of threads of the optimistic read benchmark */
+
+
+/* device files of the striping benchmark */
+static char *bench_devices[] = { "bench_stripe0.dev", "bench_stripe1.dev", "bench_stripe2.dev", "bench_stripe3.dev" };
+
+/* values of a field of the lines written by the compression benchmark */
+static char *bench_nations[] = { "ALGERIA", "ARGENTINA", "BRAZIL", "CANADA", "EGYPT", "FRANCE", "GERMANY", "INDIA",
+                                 "JAPAN", "KENYA", "MOROCCO", "PERU", "ROMANIA", "RUSSIA", "VIETNAM", "UNITED STATES" };
+
+/* trains allocated for the benchmarks */
+static PageID bench_tid[BENCH_NTRAINS];
+
+/* TRUE if the reader threads of the optimistic read benchmark read optimistically */
+static Boolean bench_optimistic;
+
+
+
+/*@================================
+ * bench_Now()
+ *================================*/
+/*
+ * Function: static double bench_Now(void)
+ *
+ * Description:
+ *  Return the time of the monotonic clock.
+ *
+ * Returns:
+ *  time in seconds
+ */
+static double bench_Now(void)
+{
+    struct timespec     ts;             /* current time */
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec + ts.tv_nsec / 1e9);
+
+}  /* bench_Now() */
+
+
+
+/*@================================
+ * bench_AllocTrains()
+ *================================*/
+/*
+ * Function: static Four bench_AllocTrains(Four)
+ *
+ * Description:
+ *  Allocate the trains used by the benchmarks, adjacent to each other.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_AllocTrains(
+    Four        volId)                  /* IN volume of the trains */
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        firstExtNo;             /* first extent number */
+    PageID      nearPid;                /* near pageID */
+
+
+    e = RDsM_CreateSegment(volId, &firstExtNo);
+    if (e < eNOERROR) ERR(e);
+    e = RDsM_ExtNoToPageId(volId, firstExtNo, &nearPid);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < BENCH_NTRAINS; i++) {
+        e = RDsM_AllocTrains(volId, firstExtNo, &nearPid, 100, 1, BI_BUFSIZE(LOT_LEAF_BUF), &bench_tid[i]);
+        if (e < eNOERROR) ERR(e);
+        nearPid = bench_tid[i];
+    }
+
+    return(eNOERROR);
+
+}  /* bench_AllocTrains() */
+
+
+
+/*@================================
+ * bench_WriteTrains()
+ *================================*/
+/*
+ * Function: static Four bench_WriteTrains(void)
+ *
+ * Description:
+ *  Store a distinct number in each train and flush them.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_WriteTrains(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    char        *atrain;                /* pointer to the buffer of a train */
+
+
+    for (i = 0; i < BENCH_NTRAINS; i++) {
+        e = EduBfM_GetTrain(&bench_tid[i], &atrain, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        sprintf(&atrain[PAGESIZE/2], "%ld", (long)(1000 + i));
+        EduBfM_SetDirty(&bench_tid[i], LOT_LEAF_BUF);
+        EduBfM_FreeTrain(&bench_tid[i], LOT_LEAF_BUF);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_WriteTrains() */
+
+
+
+/*@================================
+ * bench_ReadTrains()
+ *================================*/
+/*
+ * Function: static Four bench_ReadTrains(Four, Four, double *)
+ *
+ * Description:
+ *  Read the trains sequentially through the file backend with the given
+ *  delay, after discarding all buffers, and check the number stored in
+ *  each by bench_WriteTrains().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - a train was read back wrong
+ *    some errors caused by function calls
+ */
+static Four bench_ReadTrains(
+    Four        latency,                /* IN latency per I/O (usec); 0 for none */
+    Four        bandwidth,              /* IN bandwidth (KB/sec); 0 for unlimited */
+    double      *seconds)               /* OUT time taken */
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    char        *atrain;                /* pointer to the buffer of a train */
+    double      start;                  /* start time */
+
+
+    e = EduBfM_SetStorage(BFM_STORAGE_FILE, latency, bandwidth);
+    if (e < eNOERROR) ERR(e);
+
+    start = bench_Now();
+    for (i = 0; i < BENCH_NTRAINS; i++) {
+        e = EduBfM_GetTrain(&bench_tid[i], &atrain, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        if (atoi(&atrain[PAGESIZE/2]) != 1000 + i) e = eBADPARAMETER_EDUBFM;
+        EduBfM_FreeTrain(&bench_tid[i], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+    *seconds = bench_Now() - start;
+
+    e = EduBfM_SetStorage(BFM_STORAGE_FILE, 0, 0);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_ReadTrains() */
+
+
+
+/*@================================
+ * bench_Striping()
+ *================================*/
+/*
+ * Function: static Four bench_Striping(void)
+ *
+ * Description:
+ *  For each number of device files, write the trains, then read them
+ *  back with 0 and BENCH_NTHREADS worker threads, and print the time
+ *  and the throughput. The volume is striped last over 0 devices, i.e.
+ *  the pages are written back to it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Striping(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        d;                      /* index of the # of devices */
+    Four        t;                      /* index of the # of threads */
+    Four        nDevices[] = { 0, 1, 2, 4 };        /* # of devices benchmarked */
+    Four        nThreads[] = { 0, BENCH_NTHREADS }; /* # of threads benchmarked */
+    double      seconds;                /* time taken */
+    VolNo       volNo = bench_tid[0].volNo;         /* volume striped */
+
+
+    printf("striping: %ld sequential reads of %ld-page trains, read-ahead %ld, HDD delay\n",
+           (long)BENCH_NTRAINS, (long)BI_BUFSIZE(LOT_LEAF_BUF), (long)BENCH_READAHEAD);
+    printf("    %8s %8s %10s %10s\n", "devices", "threads", "seconds", "MB/s");
+
+    e = EduBfM_SetReadAhead(BENCH_READAHEAD);
+    if (e < eNOERROR) ERR(e);
+
+    for (d = 0; d < sizeof(nDevices) / sizeof(nDevices[0]); d++) {
+        for (i = 0; i < nDevices[d]; i++) unlink(bench_devices[i]);
+
+        if (nDevices[d] > 0) {
+            e = EduBfM_SetStriping(volNo, nDevices[d], bench_devices);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        e = bench_WriteTrains();
+        if (e < eNOERROR) ERR(e);
+
+        for (t = 0; t < sizeof(nThreads) / sizeof(nThreads[0]); t++) {
+            e = EduBfM_SetIOEngine(nThreads[t]);
+            if (e < eNOERROR) ERR(e);
+
+            e = bench_ReadTrains(BFM_HDD_LATENCY, BFM_HDD_BANDWIDTH, &seconds);
+            if (e < eNOERROR) ERR(e);
+
+            printf("    %8ld %8ld %10.3f %10.2f\n", (long)nDevices[d], (long)nThreads[t], seconds,
+                   (double)BENCH_NTRAINS * BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE / seconds / (1024*1024));
+        }
+
+        e = EduBfM_SetIOEngine(0);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_SetStriping(volNo, 0, NULL);
+    if (e < eNOERROR) ERR(e);
+    for (i = 0; i < sizeof(bench_devices) / sizeof(bench_devices[0]); i++) unlink(bench_devices[i]);
+
+    e = EduBfM_SetReadAhead(0);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_Striping() */
+
+
+
+/*@================================
+ * bench_DropCache()
+ *================================*/
+/*
+ * Function: static void bench_DropCache(Four)
+ *
+ * Description:
+ *  Write the device files to the disk and drop them from the page cache
+ *  of the host, so that the next reads go to the disk.
+ *
+ * Returns:
+ *  None
+ */
+static void bench_DropCache(
+    Four        nDevices)               /* IN # of device files */
+{
+    int         fd;                     /* device file */
+    Four        i;                      /* loop index */
+
+
+    for (i = 0; i < nDevices; i++) {
+        fd = open(bench_devices[i], O_RDONLY);
+        if (fd < 0) continue;
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+}  /* bench_DropCache() */
+
+
+
+/*@================================
+ * bench_FileIO()
+ *================================*/
+/*
+ * Function: static Four bench_FileIO(void)
+ *
+ * Description:
+ *  Stripe the volume over all the device files, write the trains, then
+ *  read them back from the disk, without delay, by preadv() one at a
+ *  time, through an io_uring, and with BENCH_NTHREADS worker threads, and
+ *  print the time and the throughput. The page cache is dropped before
+ *  each read; each is repeated BENCH_NFILEREADS times and the best time
+ *  is kept.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_FileIO(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, r;                   /* loop indexes */
+    Four        m;                      /* index of the mode */
+    char        *mode[] = { "preadv", "io_uring", "threads" };      /* modes benchmarked */
+    Four        uring[] = { FALSE, TRUE, TRUE };                    /* io_uring of each mode */
+    Four        nThreads[] = { 0, 0, BENCH_NTHREADS };              /* # of threads of each mode */
+    Four        nDevices = sizeof(bench_devices) / sizeof(bench_devices[0]);  /* # of devices */
+    double      seconds;                /* time taken */
+    double      best;                   /* best time taken */
+    VolNo       volNo = bench_tid[0].volNo;         /* volume striped */
+
+
+    printf("file I/O: %ld sequential reads of %ld-page trains, read-ahead %ld, %ld device files, no page cache\n",
+           (long)BENCH_NTRAINS, (long)BI_BUFSIZE(LOT_LEAF_BUF), (long)BENCH_READAHEAD, (long)nDevices);
+    printf("    %8s %8s %10s %10s\n", "I/O", "threads", "seconds", "MB/s");
+
+    for (i = 0; i < nDevices; i++) unlink(bench_devices[i]);
+    e = EduBfM_SetStriping(volNo, nDevices, bench_devices);
+    if (e < eNOERROR) ERR(e);
+
+    e = bench_WriteTrains();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_SetReadAhead(BENCH_READAHEAD);
+    if (e < eNOERROR) ERR(e);
+
+    for (m = 0; m < sizeof(mode) / sizeof(mode[0]); m++) {
+        edubfm_uringEnabled = uring[m];
+        e = EduBfM_SetIOEngine(nThreads[m]);
+        if (e < eNOERROR) ERR(e);
+
+        for (best = 0, r = 0; r < BENCH_NFILEREADS; r++) {
+            bench_DropCache(nDevices);
+            e = bench_ReadTrains(0, 0, &seconds);
+            if (e < eNOERROR) ERR(e);
+            if (r == 0 || seconds < best) best = seconds;
+        }
+
+        printf("    %8s %8ld %10.4f %10.2f\n", mode[m], (long)nThreads[m], best,
+               (double)BENCH_NTRAINS * BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE / best / (1024*1024));
+    }
+    edubfm_uringEnabled = TRUE;
+
+    e = EduBfM_SetIOEngine(0);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_SetReadAhead(0);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_SetStriping(volNo, 0, NULL);
+    if (e < eNOERROR) ERR(e);
+    for (i = 0; i < nDevices; i++) unlink(bench_devices[i]);
+
+    return(eNOERROR);
+
+}  /* bench_FileIO() */
+
+
+
+/*@================================
+ * bench_FillTrain()
+ *================================*/
+/*
+ * Function: static void bench_FillTrain(char *, Four)
+ *
+ * Description:
+ *  Fill the i-th train with lines of a table of customers, as a data page
+ *  of a heap file would hold them: the same fields in each line, with the
+ *  values varying.
+ *
+ * Returns:
+ *  None
+ */
+static void bench_FillTrain(
+    char        *atrain,                /* OUT buffer of the train */
+    Four        i)                      /* IN position of the train in bench_tid */
+{
+    Four        size;                   /* size of the train */
+    Four        n;                      /* # of bytes filled */
+    Four        row;                    /* row number */
+    char        line[128];              /* a line */
+    UFour       x;                      /* pseudo-random number */
+
+
+    size = BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE;
+    x = 12345 + i;
+    for (n = 0, row = i * 1000; n < size; n += strlen(line), row++) {
+        x = x * 1103515245 + 12345;
+        sprintf(line, "%08ld|Customer#%09ld|%s|%5ld.%02ld|%s\n", (long)row, (long)(x >> 8) % 150000,
+                bench_nations[(x >> 4) % (sizeof(bench_nations) / sizeof(bench_nations[0]))],
+                (long)(x >> 12) % 10000, (long)(x >> 3) % 100, ((x >> 20) & 1) ? "BUILDING" : "MACHINERY");
+        memcpy(atrain + n, line, (n + strlen(line) <= size) ? strlen(line) : size - n);
+    }
+
+}  /* bench_FillTrain() */
+
+
+
+/*@================================
+ * bench_ScanTrains()
+ *================================*/
+/*
+ * Function: static Four bench_ScanTrains(double *)
+ *
+ * Description:
+ *  Read all the trains BENCH_NSCANS times, discarding all buffers before
+ *  each scan, then check them against bench_FillTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - a train was read back wrong
+ *    some errors caused by function calls
+ */
+static Four bench_ScanTrains(
+    double      *seconds)               /* OUT time taken */
+{
+    Four        e;                      /* for errors */
+    Four        i, s;                   /* loop indexes */
+    char        *atrain;                /* pointer to the buffer of a train */
+    static char expected[PAGESIZE * BFM_CLUSTER_MAXPAGES];  /* train written */
+    double      start;                  /* start time */
+
+
+    *seconds = 0;
+    for (s = 0; s < BENCH_NSCANS; s++) {
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        start = bench_Now();
+        for (i = 0; i < BENCH_NTRAINS; i++) {
+            e = EduBfM_GetTrain(&bench_tid[i], &atrain, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            EduBfM_FreeTrain(&bench_tid[i], LOT_LEAF_BUF);
+        }
+        *seconds += bench_Now() - start;
+    }
+
+    for (i = 0; i < BENCH_NTRAINS; i++) {
+        e = EduBfM_GetTrain(&bench_tid[i], &atrain, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        bench_FillTrain(expected, i);
+        if (memcmp(atrain, expected, BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE) != 0) e = eBADPARAMETER_EDUBFM;
+        EduBfM_FreeTrain(&bench_tid[i], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* bench_ScanTrains() */
+
+
+
+/*@================================
+ * bench_Compression()
+ *================================*/
+/*
+ * Function: static Four bench_Compression(void)
+ *
+ * Description:
+ *  Write the trains with table-like lines to the volume, then to a
+ *  compressed volume, and print for each the bytes stored per byte of the
+ *  trains, the disk space taken, and the time and throughput of scanning
+ *  the trains from the file. The compression is stopped last, i.e. the
+ *  pages are written back to the volume.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Compression(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        c;                      /* 1 if the volume is compressed */
+    char        *atrain;                /* pointer to the buffer of a train */
+    double      seconds;                /* time taken */
+    double      nBytes;                 /* # of bytes of the trains */
+    BfMCompressionStat compressStat;    /* statistics of the compression */
+    struct stat st;                     /* status of the side file */
+    VolNo       volNo = bench_tid[0].volNo;         /* volume compressed */
+
+
+    nBytes = (double)BENCH_NTRAINS * BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE;
+    printf("compression: %ld trains of %ld pages of table lines, %ld scans from the file\n",
+           (long)BENCH_NTRAINS, (long)BI_BUFSIZE(LOT_LEAF_BUF), (long)BENCH_NSCANS);
+    printf("    %10s %8s %10s %10s %10s\n", "storage", "ratio", "disk KB", "seconds", "MB/s");
+
+    for (c = 0; c < 2; c++) {
+        if (c == 1) {
+            unlink(BENCH_SIDEFILE);
+            e = EduBfM_SetCompression(volNo, BENCH_SIDEFILE);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_GetCompressionStat(&compressStat, TRUE);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        for (i = 0; i < BENCH_NTRAINS; i++) {
+            e = EduBfM_GetTrain(&bench_tid[i], &atrain, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            bench_FillTrain(atrain, i);
+            EduBfM_SetDirty(&bench_tid[i], LOT_LEAF_BUF);
+            EduBfM_FreeTrain(&bench_tid[i], LOT_LEAF_BUF);
+        }
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+
+        e = bench_ScanTrains(&seconds);
+        if (e < eNOERROR) ERR(e);
+
+        if (c == 0) {
+            printf("    %10s %8.2f %10.0f", "volume", 1.0, nBytes / 1024);
+        }
+        else {
+            e = EduBfM_GetCompressionStat(&compressStat, FALSE);
+            if (e < eNOERROR) ERR(e);
+            if (stat(BENCH_SIDEFILE, &st) < 0) ERR(eFILEIOFAILED_EDUBFM);
+            printf("    %10s %8.2f %10.0f", "compressed", compressStat.nBytesIn / compressStat.nBytesOut, (double)st.st_blocks * 512 / 1024);
+        }
+        printf(" %10.3f %10.2f\n", seconds, nBytes * BENCH_NSCANS / seconds / (1024*1024));
+    }
+
+    e = EduBfM_SetCompression(volNo, NULL);
+    if (e < eNOERROR) ERR(e);
+    unlink(BENCH_SIDEFILE);
+
+    return(eNOERROR);
+
+}  /* bench_Compression() */
+
+
+
+/*@================================
+ * bench_HotReader()
+ *================================*/
+/*
+ * Function: static void *bench_HotReader(void *)
+ *
+ * Description:
+ *  Reader thread of bench_Optimistic(). Read the number stored in each of
+ *  the hot trains by bench_WriteTrains() in turn, BENCH_NHOTREADS times,
+ *  either fixing the train, or optimistically, falling back to fixing it
+ *  if the validation fails.
+ *
+ * Returns:
+ *  error code, cast to a pointer
+ */
+static void *bench_HotReader(
+    void        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    PageID      *tid;                   /* train read */
+    char        *atrain;                /* pointer to the buffer of the train */
+    UFour       version;                /* version of the buffer */
+    Four        number;                 /* number read from the train */
+
+
+    for (i = 0; i < BENCH_NHOTREADS; i++) {
+        tid = &bench_tid[i % BENCH_NHOTTRAINS];
+
+        if (bench_optimistic) {
+            e = EduBfM_GetTrainOptimistic(tid, &atrain, &version, LOT_LEAF_BUF);
+            if (e == eNOERROR) {
+                number = atoi(&atrain[PAGESIZE/2]);
+                if (EduBfM_ValidateOptimistic(tid, atrain, version, LOT_LEAF_BUF) == TRUE) {
+                    if (number != 1000 + i % BENCH_NHOTTRAINS) return((void *)(long)eBADPARAMETER_EDUBFM);
+                    continue;
+                }
+            }
+            else if (e != eNOTFOUND_BFM) return((void *)(long)e);
+        }
+
+        e = EduBfM_GetTrain(tid, &atrain, LOT_LEAF_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+        number = atoi(&atrain[PAGESIZE/2]);
+        EduBfM_FreeTrain(tid, LOT_LEAF_BUF);
+        if (number != 1000 + i % BENCH_NHOTTRAINS) return((void *)(long)eBADPARAMETER_EDUBFM);
+    }
+
+    return((void *)(long)eNOERROR);
+
+}  /* bench_HotReader() */
+
+
+
+/*@================================
+ * bench_Optimistic()
+ *================================*/
+/*
+ * Function: static Four bench_Optimistic(void)
+ *
+ * Description:
+ *  Read BENCH_NHOTTRAINS hot trains in a shared buffer pool by 1, 2 and
+ *  BENCH_MAXREADERS threads, fixing them and reading them optimistically,
+ *  and print the time and the reads per second. The pool latch is a real
+ *  mutex only in a shared pool, so the fixing readers contend on it there.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Optimistic(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        nThreads;               /* # of reader threads */
+    pthread_t   readers[BENCH_MAXREADERS];          /* reader threads */
+    void        *status;                /* error code of a reader */
+    double      start;                  /* start time */
+    double      seconds;                /* time taken */
+
+
+    printf("optimistic reads: %ld reads of %ld hot trains by each thread, shared buffer pool\n",
+           (long)BENCH_NHOTREADS, (long)BENCH_NHOTTRAINS);
+    printf("    %10s %8s %10s %12s\n", "read", "threads", "seconds", "reads/s");
+
+    e = bench_WriteTrains();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_AttachSharedPool(BENCH_SHMNAME);
+    if (e < eNOERROR) ERR(e);
+
+    for (bench_optimistic = FALSE; ; bench_optimistic = TRUE) {
+        for (nThreads = 1; nThreads <= BENCH_MAXREADERS; nThreads *= 2) {
+            start = bench_Now();
+            for (i = 0; i < nThreads; i++)
+                pthread_create(&readers[i], NULL, bench_HotReader, NULL);
+            for (e = eNOERROR, i = 0; i < nThreads; i++) {
+                pthread_join(readers[i], &status);
+                if ((long)status < eNOERROR) e = (Four)(long)status;
+            }
+            seconds = bench_Now() - start;
+            if (e < eNOERROR) {
+                EduBfM_DetachSharedPool();
+                ERR(e);
+            }
+
+            printf("    %10s %8ld %10.4f %12.0f\n", bench_optimistic ? "optimistic" : "fix", (long)nThreads,
+                   seconds, (double)nThreads * BENCH_NHOTREADS / seconds);
+        }
+        if (bench_optimistic) break;
+    }
+
+    e = EduBfM_DetachSharedPool();
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_Optimistic() */
+
+
+
+/*@================================
+ * EduBfM_Test()
+ *================================*/
+/*
+ * Function: Four EduBfM_Test(Four)
+ *
+ * Description:
+ *  Run the benchmarks and print their results. If some benchmark failed,
+ *  the process exits with status 1 so that 'make bench' fails.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduBfM_Test(Four volId)
+{
+    Four        e;                      /* for errors */
+
+
+    e = bench_AllocTrains(volId);
+    if (e < eNOERROR) ERR(e);
+
+    e = bench_Striping();
+    if (e < eNOERROR) {
+        printf("striping benchmark failed: %ld\n", (long)e);
+        exit(1);
+    }
+
+    e = bench_FileIO();
+    if (e < eNOERROR) {
+        printf("file I/O benchmark failed: %ld\n", (long)e);
+        exit(1);
+    }
+
+    e = bench_Compression();
+    if (e < eNOERROR) {
+        printf("compression benchmark failed: %ld\n", (long)e);
+        exit(1);
+    }
+
+    e = bench_Optimistic();
+    if (e < eNOERROR) {
+        printf("optimistic read benchmark failed: %ld\n", (long)e);
+        exit(1);
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_Test() */
@@ -0,0 +1,145 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_DetachSharedPool.c
+ *
+ * Description :
+ *  Detach the shared segment holding the buffer pools.
+ *
+ * Exports:
+ *  Four EduBfM_DetachSharedPool(void)
+ */
+
+
+#include <errno.h>
+#include <sys/mman.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_DetachSharedPool()
+ *================================*/
+/*
+ * Function: Four EduBfM_DetachSharedPool(void)
+ *
+ * Description :
+ *  Detach the shared segment attached by EduBfM_AttachSharedPool() and
+ *  go back to the private buffer pools of the process, which are emptied.
+ *  No train may be fixed by the process, since its buffer is unmapped.
+ *  The last process detaching the segment flushes all the dirty trains
+ *  in it and removes the segment; if the segment is suspect, i.e. some
+ *  process died holding one of its latches, the trains are not flushed
+ *  since they may be half changed.
+ *
+ * Returns:
+ *  error code
+ *    eSHAREDPOOLNOTATTACHED_EDUBFM - the shared segment is not attached
+ *    eFLUSHFIXEDBUF_BFM - some train is fixed by the process
+ *    some errors caused by function calls
+ */
+Four EduBfM_DetachSharedPool(void)
+{
+    Four                e;              /* for error */
+    BfMSharedSegment    *seg;           /* attached segment */
+    Boolean             isLast;         /* TRUE if this process is the last one */
+    Four                type;           /* buffer type */
+    Four                i;              /* index */
+
+
+    if (!IS_SHARED_BUFFERPOOL()) ERR(eSHAREDPOOLNOTATTACHED_EDUBFM);
+
+    if (__atomic_load_n(&edubfm_nFixed, __ATOMIC_RELAXED) > 0) ERR(eFLUSHFIXEDBUF_BFM);
+
+    seg = edubfm_sharedSegment;
+
+    if (pthread_mutex_lock(&(seg->attachLatch)) == EOWNERDEAD)
+        pthread_mutex_consistent(&(seg->attachLatch));
+
+    isLast = (--seg->nAttached == 0) ? TRUE : FALSE;
+    if (isLast && !seg->suspect) {
+        e = EduBfM_FlushAll();
+        if (e < 0) {
+            seg->nAttached++;
+            pthread_mutex_unlock(&(seg->attachLatch));
+            ERR(e);
+        }
+    }
+    if (isLast) shm_unlink(edubfm_sharedSegmentName);
+
+    pthread_mutex_unlock(&(seg->attachLatch));
+
+    /*@ go back to the private buffer pools */
+    edubfm_sharedSegment = NULL;
+    edubfm_poolEpoch++;
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        bufInfo[type].bufTable = edubfm_privateBufInfo[type].bufTable;
+        bufInfo[type].hashTable = edubfm_privateBufInfo[type].hashTable;
+        bufInfo[type].bufferPool = edubfm_privateBufInfo[type].bufferPool;
+        edubfm_versionTable[type] = edubfm_privateVersionTable[type];
+        BI_NEXTVICTIM(type) = 0;
+
+        for (i = 0; i < BI_NBUFS(type); i++) {
+            SET_NILBFMHASHKEY(BI_KEY(type, i));
+            BI_FIXED(type, i) = 0;
+            BI_BITS(type, i) = ALL_0;
+            BI_NEXTHASHENTRY(type, i) = NIL;
+        }
+    }
+
+    e = edubfm_DeleteAll();
+    if (e < 0) ERR(e);
+
+    munmap(seg, seg->size);
+
+    return(eNOERROR);
+
+}  /* EduBfM_DetachSharedPool() */
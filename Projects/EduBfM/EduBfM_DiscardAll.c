@@ -73,6 +73,7 @@
  *  For ODYSSEUS/EduCOSMOS EduBfM, refer to the EduBfM project manual.)
  *
  *  Discard all buffers.
+ *  The reads left in flight by the read-ahead are completed first.
  *
  * Returns:
  *  error code
@@ -85,15 +86,35 @@ Four EduBfM_DiscardAll(void)
     Four 	type;			/* buffer type */
     //page_num
 
+    edubfm_DrainReadAhead();
+
+    /* the pool latches are acquired in the increasing order of the buffer type */
+    for (type=0; type < NUM_BUF_TYPES; type++) {
+        e = edubfm_LatchPool(type);
+        if ( e < 0 ) {
+            while (--type >= 0) edubfm_UnlatchPool(type);
+            ERR( e );
+        }
+    }
+
     for (type=0; type < NUM_BUF_TYPES; type++) {
         for (i=0; i < BI_NBUFS(type); i++) {
+            if ( BI_BITS(type, i) & PREFETCH ) edubfm_raStat.nWasted++;
             BI_BITS(type, i) = ALL_0;
             BI_FIXED(type, i) = 0;
+            BI_BEGINCHANGE(type, i);
+            BI_ENDCHANGE(type, i);
             SET_NILBFMHASHKEY(BI_KEY(type, i));
         }
     }
     
+    __atomic_store_n(&edubfm_nFixed, 0, __ATOMIC_RELAXED);
+
     e = edubfm_DeleteAll();
+
+    for (type=NUM_BUF_TYPES-1; type >= 0; type--)
+        edubfm_UnlatchPool(type);
+
     if ( e < 0 ) ERR ( e );
 
     return(e);
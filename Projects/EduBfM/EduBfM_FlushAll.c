@@ -74,6 +74,8 @@
  *
  *  Flush dirty buffers holding trains.
  *  A dirty buffer is one with the dirty bit set.
+ *  The dirty buffers are written in batches through the I/O engine,
+ *  after the reads left in flight by the read-ahead are completed.
  *
  * Returns:
  *  error code
@@ -84,14 +86,32 @@ Four EduBfM_FlushAll(void)
     Four        e;                      /* error */
     Two         i;                      /* index */
     Four        type;                   /* buffer type */
+    Four        index[BFM_IO_MAXBATCH]; /* dirty buffers of a batch */
+    Four        nTrains;                /* # of dirty buffers in the batch */
+
+    edubfm_DrainReadAhead();
 
     for (type=0; type < NUM_BUF_TYPES; type++) {
-        for (i=0; i < BI_NBUFS(type); i++) {
-            if ( BI_BITS(type, i) & DIRTY ) {
-                e = edubfm_FlushTrain(&BI_KEY(type, i), type);
-                if ( e < 0 ) ERR( e );
+        e = edubfm_LatchPool(type);
+        if ( e < 0 ) ERR( e );
+
+        nTrains = 0;
+        for (i=0; i <= BI_NBUFS(type); i++) {
+            if ( i < BI_NBUFS(type) && (BI_BITS(type, i) & DIRTY) )
+                index[nTrains++] = i;
+
+            if ( nTrains == BFM_IO_MAXBATCH || (i == BI_NBUFS(type) && nTrains > 0) ) {
+                e = edubfm_FlushTrains(type, index, nTrains);
+                if ( e < 0 ) {
+                    edubfm_UnlatchPool(type);
+                    ERR( e );
+                }
+                nTrains = 0;
             }
         }
+
+        e = edubfm_UnlatchPool(type);
+        if ( e < 0 ) ERR( e );
     }
 
     return( eNOERROR );
@@ -87,20 +87,30 @@ Four EduBfM_FreeTrain(
 	/* These local variables are used in the solution code. However, you dont have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four                index;          /* index on buffer holding the train */
     Two 		        fixed_num;		/* fixed count */
+    Four                e;              /* for error */
 
     /*@ check if the parameter is valid. */
     if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
 
+    e = edubfm_LatchPool(type);
+    if ( e < 0 ) ERR( e );
+
     index = edubfm_LookUp(trainId, type);    
-    if ( index == NOTFOUND_IN_HTABLE ) ERR( eNOTFOUND_BFM );
+    if ( index == NOTFOUND_IN_HTABLE ) {
+        edubfm_UnlatchPool(type);
+        ERR( eNOTFOUND_BFM );
+    }
     
     fixed_num = BI_FIXED(type, index);
-    if ( fixed_num > 0 )
-        fixed_num -= 1;
+    if ( fixed_num > 0 ) {
+        BI_FIXED(type, index)--;
+        __atomic_sub_fetch(&edubfm_nFixed, 1, __ATOMIC_RELAXED);
+    }
     else
         PRINT_TRAINID("fixed_num is less than zero: trainID", &BI_KEY(type, index));
- 
-    BI_FIXED(type, index) = fixed_num;
+
+    e = edubfm_UnlatchPool(type);
+    if ( e < 0 ) ERR( e );
 
     return( eNOERROR );
     
@@ -0,0 +1,104 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetCompressionStat.c
+ *
+ * Description : 
+ *  Return the statistics of the page compression.
+ *
+ * Exports:
+ *  Four EduBfM_GetCompressionStat(BfMCompressionStat *, Boolean)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetCompressionStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetCompressionStat(BfMCompressionStat*, Boolean)
+ *
+ * Description : 
+ *  Return the number of trains this process wrote to compressed volumes,
+ *  how many of them did not compress and were stored as is, and the
+ *  number of bytes of the trains and of what was stored for them; their
+ *  quotient is the compression ratio. If 'reset' is TRUE, the counters
+ *  are cleared.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stat is NULL
+ *
+ * Side effects:
+ *  1) parameter stat
+ *     statistics of the page compression
+ */
+Four EduBfM_GetCompressionStat(
+    BfMCompressionStat  *stat,                  /* OUT compression statistics */
+    Boolean             reset)                  /* IN clear the counters if TRUE */
+{
+    /*@ Check the validity of given parameters */
+    if (stat == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    *stat = edubfm_compressStat;
+
+    if (reset) {
+        edubfm_compressStat.nTrainsWritten = 0;
+        edubfm_compressStat.nTrainsRaw = 0;
+        edubfm_compressStat.nBytesIn = 0;
+        edubfm_compressStat.nBytesOut = 0;
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetCompressionStat() */
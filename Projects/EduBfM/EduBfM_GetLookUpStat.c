@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetLookUpStat.c
+ *
+ * Description : 
+ *  Return the lookup statistics of the calling thread.
+ *
+ * Exports:
+ *  Four EduBfM_GetLookUpStat(BfMLookUpStat *, Boolean)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetLookUpStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetLookUpStat(BfMLookUpStat*, Boolean)
+ *
+ * Description : 
+ *  Return the number of buffer table lookups done by the calling thread
+ *  and the number of them served by the thread-local lookup cache.
+ *  The difference of the two is the number of hash table walks; taking
+ *  the statistics before and after an operation gives the lookups saved
+ *  for the operation. If 'reset' is TRUE, the counters are cleared.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stat is NULL
+ *
+ * Side effects:
+ *  1) parameter stat
+ *     statistics of the calling thread
+ */
+Four EduBfM_GetLookUpStat(
+    BfMLookUpStat       *stat,                  /* OUT lookup statistics */
+    Boolean             reset)                  /* IN clear the counters if TRUE */
+{
+    /*@ Check the validity of given parameters */
+    if (stat == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    *stat = edubfm_lookUpStat;
+
+    if (reset) {
+        edubfm_lookUpStat.nLookUps = 0;
+        edubfm_lookUpStat.nCacheHits = 0;
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetLookUpStat() */
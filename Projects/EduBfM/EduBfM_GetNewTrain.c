@@ -0,0 +1,153 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetNewTrain.c
+ *
+ * Description : 
+ *  Return a zero-filled buffer for a newly allocated train without reading it.
+ *
+ * Exports:
+ *  Four EduBfM_GetNewTrain(TrainID *, char **, Four)
+ */
+
+
+#include <string.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetNewTrain()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetNewTrain(TrainID*, char**, Four)
+ *
+ * Description : 
+ *  Return a buffer for the train indicated by `trainId', which has just
+ *  been allocated (e.g. by RDsM_AllocTrains()) and will be initialized by
+ *  the caller. Unlike EduBfM_GetTrain(), the disk train is not read; a
+ *  buffer is allocated, filled with zeros and fixed.
+ *  If the train is already in the buffer pool, it is simply fixed and
+ *  returned as EduBfM_GetTrain() does.
+ *  The buffer is not marked dirty; the caller sets the dirty bit after
+ *  initializing it.
+ *  The modes recorded in the volume are checked first, as on a miss of
+ *  EduBfM_GetTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - Invalid Buffer
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter retBuf
+ *     pointer to buffer for the train indicated by `trainId'
+ */
+Four EduBfM_GetNewTrain(
+    TrainID             *trainId,               /* IN train to be used */
+    char                **retBuf,               /* OUT pointer to the returned buffer */
+    Four                type )                  /* IN buffer type */
+{
+    Four                e;                      /* for error */
+    Four                index;                  /* index of the buffer pool */
+
+
+    /*@ Check the validity of given parameters */
+    if (retBuf == NULL) ERR(eBADBUFFER_BFM);
+
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    e = edubfm_CheckVolumeMode(trainId->volNo);
+    if ( e < 0 ) ERR( e );
+
+    e = edubfm_LatchPool(type);
+    if ( e < 0 ) ERR( e );
+
+    index = edubfm_LookUp((BfMHashKey*)trainId, type);
+    if ( index != NOTFOUND_IN_HTABLE ) {
+        e = edubfm_UnlatchPool(type);
+        if ( e < 0 ) ERR( e );
+
+        return( EduBfM_GetTrain(trainId, retBuf, type) );
+    }
+
+    index = edubfm_AllocTrain(type);
+    if ( index < 0 ) {
+        edubfm_UnlatchPool(type);
+        ERR( index );
+    }
+
+    BI_BEGINCHANGE(type, index);
+    BI_KEY(type, index) = *((BfMHashKey*)trainId);
+    e = edubfm_Insert((BfMHashKey*)trainId, index, type);
+    if ( e < 0 ) {
+        SET_NILBFMHASHKEY(BI_KEY(type, index));
+        BI_ENDCHANGE(type, index);
+        edubfm_UnlatchPool(type);
+        ERR( e );
+    }
+
+    /* no I/O is needed, so the buffer is filled under the pool latch */
+    memset(BI_BUFFER(type, index), 0, PAGESIZE*BI_BUFSIZE(type));
+    BI_FIXED(type, index)++;
+    BI_BITS(type, index) = REFER;
+    BI_ENDCHANGE(type, index);
+
+    e = edubfm_UnlatchPool(type);
+    if ( e < 0 ) ERR( e );
+
+    *retBuf = BI_BUFFER(type, index);
+    __atomic_add_fetch(&edubfm_nFixed, 1, __ATOMIC_RELAXED);
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetNewTrain() */
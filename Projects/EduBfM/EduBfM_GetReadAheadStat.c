@@ -0,0 +1,104 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetReadAheadStat.c
+ *
+ * Description : 
+ *  Return the statistics of the sequential read-ahead.
+ *
+ * Exports:
+ *  Four EduBfM_GetReadAheadStat(BfMReadAheadStat *, Boolean)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetReadAheadStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetReadAheadStat(BfMReadAheadStat*, Boolean)
+ *
+ * Description : 
+ *  Return the number of trains read ahead by this process, and how many
+ *  of them were referenced afterwards (used) or replaced or discarded
+ *  without being referenced (wasted). The trains still in the buffer pool
+ *  with the PREFETCH bit are counted in neither. If 'reset' is TRUE, the
+ *  counters are cleared.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stat is NULL
+ *
+ * Side effects:
+ *  1) parameter stat
+ *     statistics of the read-ahead
+ */
+Four EduBfM_GetReadAheadStat(
+    BfMReadAheadStat    *stat,                  /* OUT read-ahead statistics */
+    Boolean             reset)                  /* IN clear the counters if TRUE */
+{
+    /*@ Check the validity of given parameters */
+    if (stat == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    *stat = edubfm_raStat;
+
+    if (reset) {
+        edubfm_raStat.nPrefetched = 0;
+        edubfm_raStat.nUsed = 0;
+        edubfm_raStat.nWasted = 0;
+        edubfm_raStat.nAsync = 0;
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetReadAheadStat() */
@@ -80,6 +80,15 @@
  *  pool, allocate a buffer (a buffer selected as victim may be forced out
  *  by the buffer replacement algorithm), read a disk train into the 
  *  selected buffer train, and return it.
+ *  When the buffer pool is shared by several processes, the buffer is fixed
+ *  under the pool latch and the disk train is read under the frame latch;
+ *  a process finding the train in the pool waits on the frame latch until
+ *  the read is done.
+ *  A miss, or the first reference of a train read ahead, is passed to the
+ *  sequential read-ahead (see EduBfM_SetReadAhead()). A train whose read
+ *  ahead is still in flight is completed first (see edubfm_ReadAhead()).
+ *  On a miss, the modes recorded in the volume are checked before a buffer
+ *  is allocated (see edubfm_CheckVolumeMode()).
  *
  * Returns:
  *  error code
@@ -99,6 +108,8 @@ Four EduBfM_GetTrain(
 	/* These local variables are used in the solution code. However, you dont have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four                e;                      /* for error */
     Four                index;                  /* index of the buffer pool */
+    Boolean             readAhead = FALSE;      /* TRUE if the access is passed to the read-ahead */
+    Boolean             modeChecked = FALSE;    /* TRUE if the modes of the volume are checked */
     
 
     /*@ Check the validity of given parameters */
@@ -108,20 +119,126 @@ Four EduBfM_GetTrain(
     /* Is the buffer type valid? */
     if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
+  retry:
+    e = edubfm_LatchPool(type);
+    if ( e < 0 ) ERR( e );
+
     index = edubfm_LookUp((BfMHashKey*)trainId, type);
-    if ( index == NOTFOUND_IN_HTABLE ) {
+    if ( index == NOTFOUND_IN_HTABLE && !modeChecked ) {
+        /* the check may read the volume, so it is done out of the pool latch */
+        e = edubfm_UnlatchPool(type);
+        if ( e < 0 ) ERR( e );
+
+        e = edubfm_CheckVolumeMode(trainId->volNo);
+        if ( e < 0 ) ERR( e );
+
+        modeChecked = TRUE;
+        goto retry;
+    }
+    else if ( index == NOTFOUND_IN_HTABLE ) {
         index = edubfm_AllocTrain(type);
+        if ( index < 0 ) {
+            edubfm_UnlatchPool(type);
+            ERR( index );
+        }
+        /* optimistic readers of the old train must fail their validation */
+        BI_BEGINCHANGE(type, index);
         BI_KEY(type, index) = *((BfMHashKey*)trainId);
         e = edubfm_Insert((BfMHashKey*)trainId, index, type);
+        if ( e < 0 ) {
+            SET_NILBFMHASHKEY(BI_KEY(type, index));
+            BI_ENDCHANGE(type, index);
+            edubfm_UnlatchPool(type);
+            ERR( e );
+        }
+        BI_FIXED(type, index)++;
+
+        /* other processes must not see the buffer until the read is done */
+        e = edubfm_LatchFrame(type, index);
+        if ( e < 0 ) {
+            edubfm_UnlatchPool(type);
+            ERR( e );
+        }
+        e = edubfm_UnlatchPool(type);
         if ( e < 0 ) ERR( e );
+
         e = edubfm_ReadTrain(trainId, BI_BUFFER(type, index), type);
-        if ( e < 0 ) ERR( e );
+        if ( e < 0 ) {
+            /* give the buffer back; waiters will not find the train any more */
+            edubfm_LatchPool(type);
+            edubfm_Delete((BfMHashKey*)trainId, type);
+            SET_NILBFMHASHKEY(BI_KEY(type, index));
+            BI_ENDCHANGE(type, index);
+            BI_FIXED(type, index)--;
+            edubfm_UnlatchPool(type);
+            edubfm_UnlatchFrame(type, index);
+            ERR( e );
+        }
         BI_BITS(type, index) = REFER;
+        readAhead = TRUE;
+
+        /* optimistic readers may read the train from now on */
+        BI_ENDCHANGE(type, index);
+
+        e = edubfm_UnlatchFrame(type, index);
+        if ( e < 0 ) ERR( e );
+    }
+    else {
+        //BI_BITS(type, index) |= REFER;
+        BI_FIXED(type, index)++;
+
+        if ( BI_BITS(type, index) & READING ) {
+            /* read ahead and maybe left in flight by this process; complete it out of the pool latch */
+            e = edubfm_UnlatchPool(type);
+            if ( e < 0 ) ERR( e );
+            e = edubfm_CompleteReadAhead(type, index);
+            if ( e < 0 ) ERR( e );
+            e = edubfm_LatchPool(type);
+            if ( e < 0 ) ERR( e );
+
+            if ( !EQUALKEY((BfMHashKey*)trainId, &BI_KEY(type, index)) ) {
+                /* the read failed and the buffer was given back */
+                BI_FIXED(type, index)--;
+                e = edubfm_UnlatchPool(type);
+                if ( e < 0 ) ERR( e );
+                goto retry;
+            }
+        }
+
+        if ( BI_BITS(type, index) & PREFETCH ) {
+            /* first reference of a train read ahead */
+            BI_BITS(type, index) = (BI_BITS(type, index) & ~PREFETCH) | REFER;
+            edubfm_raStat.nUsed++;
+            readAhead = TRUE;
+        }
+
+        e = edubfm_UnlatchPool(type);
+        if ( e < 0 ) ERR( e );
+
+        if ( IS_SHARED_BUFFERPOOL() ) {
+            /* wait until the process reading the train is done */
+            e = edubfm_LatchFrame(type, index);
+            if ( e < 0 ) ERR( e );
+            e = edubfm_UnlatchFrame(type, index);
+            if ( e < 0 ) ERR( e );
+
+            if ( !EQUALKEY((BfMHashKey*)trainId, &BI_KEY(type, index)) ) {
+                /* the read failed and the buffer was given back */
+                e = edubfm_LatchPool(type);
+                if ( e < 0 ) ERR( e );
+                BI_FIXED(type, index)--;
+                e = edubfm_UnlatchPool(type);
+                if ( e < 0 ) ERR( e );
+                goto retry;
+            }
+        }
     }
     
-    //BI_BITS(type, index) |= REFER;
-    BI_FIXED(type, index) += 1;
     *retBuf = BI_BUFFER(type, index);
+    __atomic_add_fetch(&edubfm_nFixed, 1, __ATOMIC_RELAXED);
+
+    /* read-ahead is done at best effort; its failure does not fail this call */
+    if ( readAhead ) (void) edubfm_ReadAhead(trainId, type);
 
     return(eNOERROR);   /* No error */
 
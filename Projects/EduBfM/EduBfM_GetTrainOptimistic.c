@@ -0,0 +1,137 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetTrainOptimistic.c
+ *
+ * Description : 
+ *  Return a buffer holding the train indicated by `trainId' without fixing it.
+ *
+ * Exports:
+ *  Four EduBfM_GetTrainOptimistic(TrainID *, char **, UFour *, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetTrainOptimistic()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetTrainOptimistic(TrainID*, char**, UFour*, Four)
+ *
+ * Description : 
+ *  Return a buffer holding the train indicated by `trainId' together with
+ *  the version of the buffer, without fixing the buffer.
+ *  This is for short read-only accesses such as the binary search in an
+ *  internal node; neither the pool latch is taken nor the fixed count is
+ *  touched, so the readers of a hot train do not contend with each other.
+ *  Since the buffer is not fixed, it may be replaced or modified while the
+ *  caller reads it; a train being modified (see EduBfM_BeginWrite()) is not
+ *  returned at all, while a train merely fixed by someone is. The buffer
+ *  table entry found without the latch is trusted only if its key is still
+ *  `trainId' after its version was read. The caller must therefore copy out what it needs and
+ *  call EduBfM_ValidateOptimistic() with the returned version before using
+ *  it; if the validation fails, the caller retries or falls back to
+ *  EduBfM_GetTrain(). The caller must not modify the buffer.
+ *  The train is not read from the disk; if it does not reside in the
+ *  buffer pool, or it is being modified or read in, eNOTFOUND_BFM is returned without
+ *  printing an error so that the caller can fall back to EduBfM_GetTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - Invalid Buffer
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    eNOTFOUND_BFM - the train is not in the buffer pool
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter retBuf
+ *     pointer to buffer holding the disk train indicated by `trainId'
+ *  2) parameter retVersion
+ *     version of the buffer to be passed to EduBfM_ValidateOptimistic()
+ */
+Four EduBfM_GetTrainOptimistic(
+    TrainID             *trainId,               /* IN train to be read */
+    char                **retBuf,               /* OUT pointer to the returned buffer */
+    UFour               *retVersion,            /* OUT version of the returned buffer */
+    Four                type )                  /* IN buffer type */
+{
+    Four                index;                  /* index of the buffer pool */
+    UFour               version;                /* version of the buffer */
+
+
+    /*@ Check the validity of given parameters */
+    if (retBuf == NULL || retVersion == NULL) ERR(eBADBUFFER_BFM);
+
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    index = edubfm_LookUpOptimistic((BfMHashKey*)trainId, type);
+    if ( index == NOTFOUND_IN_HTABLE ) return( eNOTFOUND_BFM );
+
+    version = BI_READVERSION(type, index);
+
+    /* the train is being modified or read in */
+    if ( version & 1 ) return( eNOTFOUND_BFM );
+
+    /* the buffer element was given to another train after the lookup */
+    if ( !EQUALKEY((BfMHashKey*)trainId, &BI_KEY(type, index)) ) return( eNOTFOUND_BFM );
+
+    /* keep the train from being chosen as a victim; written only when not set yet */
+    if ( !(BI_BITS(type, index) & REFER) )
+        __atomic_fetch_or(&BI_BITS(type, index), REFER, __ATOMIC_RELAXED);
+
+    *retBuf = BI_BUFFER(type, index);
+    *retVersion = version;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetTrainOptimistic() */
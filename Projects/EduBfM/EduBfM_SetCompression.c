@@ -0,0 +1,135 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SetCompression.c
+ *
+ * Description : 
+ *  Turn the page compression of a volume on or off.
+ *
+ * Exports:
+ *  Four EduBfM_SetCompression(VolNo, char *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetCompression()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetCompression(VolNo, char*)
+ *
+ * Description : 
+ *  Compress the trains of the volume into the given side file, or stop
+ *  compressing the volume if path is NULL. The trains written while the
+ *  volume is compressed are kept in the side file only, compressed, and
+ *  read back from it; the others are still read from the volume. So the
+ *  same side file must be given again whenever the volume is used, until
+ *  the compression is stopped: then the pages kept in the side file are
+ *  written back to the volume and the side file is emptied. If some page
+ *  cannot be written back, the volume stays compressed.
+ *  The mode is recorded in the volume, and the trains of a volume
+ *  recorded as compressed cannot be read or written until its side file
+ *  is given, so that a process forgetting to do so does not read stale
+ *  pages from the volume. If the mode cannot be recorded, the compression
+ *  is stopped again.
+ *  The dirty buffers are flushed and all buffers are discarded first, so
+ *  no buffer holds a train read before the switch. The setting is private
+ *  to the process, so it cannot be changed while the shared buffer pool
+ *  is attached.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - the volume is not compressed, too many volumes,
+ *                           or the volume is striped
+ *    eFLUSHFIXEDBUF_BFM - some buffer is fixed
+ *    eSHAREDPOOLATTACHED_EDUBFM - the shared buffer pool is attached
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be read or emptied
+ *    eBADCOMPRESSEDTRAIN_EDUBFM - a page in the side file is corrupted
+ *    some errors caused by function calls
+ */
+Four EduBfM_SetCompression(
+    VolNo               volNo,                  /* IN volume */
+    char                *path)                  /* IN side file; NULL to stop compressing */
+{
+    Four                e;                      /* for error */
+    Four                type;                   /* buffer type */
+    Four                i;                      /* index */
+
+
+    if (IS_SHARED_BUFFERPOOL()) ERR(eSHAREDPOOLATTACHED_EDUBFM);
+
+    /* the buffers read ahead are unfixed once their reads are completed */
+    edubfm_DrainReadAhead();
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) ERR(eFLUSHFIXEDBUF_BFM);
+
+    e = EduBfM_FlushAll();
+    if (e < 0) ERR(e);
+
+    e = EduBfM_DiscardAll();
+    if (e < 0) ERR(e);
+
+    e = edubfm_SetCompression(volNo, path);
+    if (e < 0) ERR(e);
+
+    e = edubfm_RecordVolumeMode(volNo, BFM_MODE_COMPRESSION, (path != NULL) ? TRUE : FALSE);
+    if (e < 0) {
+        if (path != NULL) (void) edubfm_SetCompression(volNo, NULL);
+        ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_SetCompression() */
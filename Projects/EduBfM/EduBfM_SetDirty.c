@@ -78,6 +78,9 @@
  *  Set the dirty bit of an entry in the buffer table.
  *  Look up the entry in the using given parameters and set the dirty
  *  bit of the entry.
+ *  The optimistic readers of the train (see EduBfM_GetTrainOptimistic())
+ *  are not told here; a train read optimistically must be modified between
+ *  EduBfM_BeginWrite() and EduBfM_EndWrite(), which also sets the dirty bit.
  * 
  * Returns:
  *  error code
@@ -90,16 +93,26 @@ Four EduBfM_SetDirty(
 {
 	/* These local variables are used in the solution code. However, you dont have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four                index;                  /* an index of the buffer table & pool */
+    Four                e;                      /* for error */
 
 
     /*@ Is the paramter valid? */
     if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
 
+    e = edubfm_LatchPool(type);
+    if ( e < 0 ) ERR( e );
+
     index = edubfm_LookUp(trainId, type);
-    if ( index == NOTFOUND_IN_HTABLE ) ERR( eNOTFOUND_BFM );
+    if ( index == NOTFOUND_IN_HTABLE ) {
+        edubfm_UnlatchPool(type);
+        ERR( eNOTFOUND_BFM );
+    }
 
     BI_BITS(type, index) |= DIRTY;
 
+    e = edubfm_UnlatchPool(type);
+    if ( e < 0 ) ERR( e );
+
     return( eNOERROR );
 
 }  /* EduBfM_SetDirty */
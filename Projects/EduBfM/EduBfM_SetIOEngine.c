@@ -0,0 +1,107 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SetIOEngine.c
+ *
+ * Description : 
+ *  Set the number of worker threads of the I/O engine.
+ *
+ * Exports:
+ *  Four EduBfM_SetIOEngine(Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetIOEngine()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetIOEngine(Four)
+ *
+ * Description : 
+ *  Set the number of worker threads doing the reads and writes of the
+ *  buffer manager. The read-ahead, the write clustering and
+ *  EduBfM_FlushAll() submit their I/Os in batches, which the worker
+ *  threads pass to the storage backend; every call waits for its I/Os
+ *  before returning, except the read-ahead, which may leave its reads in
+ *  flight (see edubfm_ReadAhead()); those are completed before the
+ *  threads are changed. With 0 threads (the default), the I/Os are done
+ *  one by one by the calling thread.
+ *  RDsM is not reentrant, so the file backend does the I/Os of a plain
+ *  volume one at a time whatever the number of threads; the workers
+ *  overlap only the I/Os on the device files of striped volumes, on the
+ *  side files of compressed volumes, and the waits of the delay backend.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad # of threads
+ *    some errors caused by function calls
+ */
+Four EduBfM_SetIOEngine(
+    Four                nThreads)               /* IN # of worker threads */
+{
+    Four                e;                      /* for error */
+
+
+    /*@ Check the validity of given parameters */
+    if (nThreads < 0 || nThreads > BFM_IO_MAXTHREADS) ERR(eBADPARAMETER_EDUBFM);
+
+    edubfm_DrainReadAhead();
+
+    e = edubfm_StartIOEngine(nThreads);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* EduBfM_SetIOEngine() */
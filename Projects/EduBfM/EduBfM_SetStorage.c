@@ -0,0 +1,132 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SetStorage.c
+ *
+ * Description : 
+ *  Select the storage backend under the buffer manager.
+ *
+ * Exports:
+ *  Four EduBfM_SetStorage(Four, Four, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetStorage()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetStorage(Four, Four, Four)
+ *
+ * Description : 
+ *  Select the storage backend which the trains are read from and written
+ *  to: BFM_STORAGE_FILE, the volume devices through RDsM (the default), or
+ *  BFM_STORAGE_RAM, the memory of this process, for CPU-bound benchmarks.
+ *  The RAM backend reads a page from the volume the first time and keeps
+ *  all the writes in memory; nothing written reaches the volume.
+ *  If latency or bandwidth is positive, the backend is used through
+ *  emulated devices with one queue each: every I/O takes the latency plus
+ *  the transfer time at the bandwidth, after the I/Os queued before it on
+ *  its device, so concurrent I/Os share a device as they would a real
+ *  one. The volumes share one device, and each device file of a striped
+ *  volume (see EduBfM_SetStriping()) is another one;
+ *  BFM_SSD_LATENCY/BANDWIDTH and BFM_HDD_LATENCY/BANDWIDTH are typical.
+ *  The dirty buffers are flushed to the previous backend and all buffers
+ *  are discarded before switching; the pages kept by the RAM backend are
+ *  freed when another backend is selected, so they are lost. The backend
+ *  is private to the process, so it cannot be changed while the shared
+ *  buffer pool is attached.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad backend or delay
+ *    eFLUSHFIXEDBUF_BFM - some buffer is fixed
+ *    eSHAREDPOOLATTACHED_EDUBFM - the shared buffer pool is attached
+ *    some errors caused by function calls
+ */
+Four EduBfM_SetStorage(
+    Four                backend,                /* IN BFM_STORAGE_FILE or BFM_STORAGE_RAM */
+    Four                latency,                /* IN latency per I/O (usec); 0 for none */
+    Four                bandwidth)              /* IN bandwidth (KB/sec); 0 for unlimited */
+{
+    Four                e;                      /* for error */
+    Four                type;                   /* buffer type */
+    Four                i;                      /* index */
+
+
+    /*@ Check the validity of given parameters */
+    if (backend != BFM_STORAGE_FILE && backend != BFM_STORAGE_RAM) ERR(eBADPARAMETER_EDUBFM);
+    if (latency < 0 || bandwidth < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    if (IS_SHARED_BUFFERPOOL()) ERR(eSHAREDPOOLATTACHED_EDUBFM);
+
+    /* the buffers read ahead are unfixed once their reads are completed */
+    edubfm_DrainReadAhead();
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) ERR(eFLUSHFIXEDBUF_BFM);
+
+    /*@ no buffer may hold a train of the previous backend */
+    e = EduBfM_FlushAll();
+    if (e < 0) ERR(e);
+
+    e = EduBfM_DiscardAll();
+    if (e < 0) ERR(e);
+
+    e = edubfm_SetStorage(backend, latency, bandwidth);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* EduBfM_SetStorage() */
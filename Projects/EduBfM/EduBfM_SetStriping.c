@@ -0,0 +1,142 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SetStriping.c
+ *
+ * Description : 
+ *  Stripe a volume over several device files.
+ *
+ * Exports:
+ *  Four EduBfM_SetStriping(VolNo, Four, char **)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetStriping()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetStriping(VolNo, Four, char**)
+ *
+ * Description : 
+ *  Stripe the trains of the volume over the given device files, RAID-0
+ *  style in units of BFM_STRIPE_NPAGES pages, or stop striping the volume
+ *  if nDevices is 0. The trains written while the volume is striped are
+ *  kept in the device files only and read back from them; the others are
+ *  still read from the volume. So the same device files must be given
+ *  again, in the same order, whenever the volume is used, until the
+ *  striping is stopped or changed: then the pages kept in the device files
+ *  are written back to the volume and the files are emptied. If some page
+ *  cannot be written back, the striping is left as it was. With the worker
+ *  threads of the I/O engine (see EduBfM_SetIOEngine()), the trains of a
+ *  batch on different devices are read and written concurrently.
+ *  The # of devices is recorded in the volume, and the trains of a volume
+ *  recorded as striped cannot be read or written until as many device
+ *  files are given, so that a process forgetting to do so does not read
+ *  stale pages from the volume. If the mode cannot be recorded, the
+ *  striping is stopped again.
+ *  The dirty buffers are flushed and all buffers are discarded first, so
+ *  no buffer holds a train read before the switch. The setting is private
+ *  to the process, so it cannot be changed while the shared buffer pool
+ *  is attached.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad # of devices, the volume is not striped,
+ *                           too many volumes, or the volume is compressed
+ *    eFLUSHFIXEDBUF_BFM - some buffer is fixed
+ *    eSHAREDPOOLATTACHED_EDUBFM - the shared buffer pool is attached
+ *    eFILEIOFAILED_EDUBFM - a device file cannot be read or emptied
+ *    some errors caused by function calls
+ */
+Four EduBfM_SetStriping(
+    VolNo               volNo,                  /* IN volume */
+    Four                nDevices,               /* IN # of devices; 0 to stop striping */
+    char                **paths)                /* IN device files */
+{
+    Four                e;                      /* for error */
+    Four                type;                   /* buffer type */
+    Four                i;                      /* index */
+
+
+    /*@ Check the validity of given parameters */
+    if (nDevices < 0 || nDevices > BFM_STRIPE_MAXDEVICES) ERR(eBADPARAMETER_EDUBFM);
+    if (nDevices > 0 && paths == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    if (IS_SHARED_BUFFERPOOL()) ERR(eSHAREDPOOLATTACHED_EDUBFM);
+
+    /* the buffers read ahead are unfixed once their reads are completed */
+    edubfm_DrainReadAhead();
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) ERR(eFLUSHFIXEDBUF_BFM);
+
+    e = EduBfM_FlushAll();
+    if (e < 0) ERR(e);
+
+    e = EduBfM_DiscardAll();
+    if (e < 0) ERR(e);
+
+    e = edubfm_SetStriping(volNo, nDevices, paths);
+    if (e < 0) ERR(e);
+
+    e = edubfm_RecordVolumeMode(volNo, BFM_MODE_STRIPING, nDevices);
+    if (e < 0) {
+        if (nDevices > 0) (void) edubfm_SetStriping(volNo, 0, NULL);
+        ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_SetStriping() */
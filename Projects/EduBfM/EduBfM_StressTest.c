@@ -0,0 +1,1749 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_StressTest.c
+ *
+ * Description : 
+ *  Stress tests of the extensions of EduBfM which cannot be shown by
+ *  EduBfM_Test(): several processes sharing the buffer pool, optimistic
+ *  readers racing with a writer, read-ahead with few buffers left,
+ *  switching the storage backend, concurrent I/Os on an emulated device,
+ *  page compression with more dirty pages
+ *  than buffers and with pages rewritten to other extents of the side
+ *  file, compressed volumes refused without their side file, pages moved
+ *  back when the striping stops, striped volumes refused without their
+ *  device files, batches of reads of the device files through io_uring,
+ *  write clustering of runs of any length and start, thread-local lookup
+ *  caches of threads replacing each other's buffers, new trains got by
+ *  racing threads, failures and recovery. The program is built by 'make check' by linking this
+ *  module in place of EduBfM_Test.o, and prints one line per test.
+ *
+ * Exports:
+ *  Four EduBfM_Test(Four)
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+#include "EduBfM_basictypes.h"
+#include "EduBfM_TestModule.h"
+
+
+/*@ Constant definitions */
+#define STRESS_SHMNAME          "/edubfm_stresstest"
+#define STRESS_SIDEFILE         "stress_compress.side"  /* side file of the compression test */
+#define STRESS_NDEVICES         2       /* # of device files of the striping test */
+#define STRESS_NPAGES           (3*NUM_PAGE_BUFS)   /* # of pages allocated for the tests */
+
+#define STRESS_NWRITERS         2       /* # of writer processes */
+#define STRESS_NREADERS         2       /* # of reader processes */
+#define STRESS_NROUNDS          2000    /* # of rounds of each process */
+#define STRESS_PAGESPERWRITER   2       /* # of pages updated by each writer */
+#define STRESS_NOPTIMISTIC      200000  /* # of optimistic reads racing with the writer */
+#define STRESS_TIMEOUT          120     /* seconds after which a hung test is killed */
+#define STRESS_NDELAYREADERS    4       /* # of threads reading through the delay backend */
+#define STRESS_DELAY_LATENCY    20000   /* latency of the delay backend (usec) */
+#define STRESS_NLOOKUPREADERS   4       /* # of threads fixing pages through their lookup caches */
+#define STRESS_NLOOKUPS         20000   /* # of pages fixed by each of them */
+#define STRESS_NHOTPAGES        4       /* # of pages fixed most of the time */
+#define STRESS_NNEWWRITERS      4       /* # of threads getting their pages by EduBfM_GetNewTrain() */
+#define STRESS_NNEWROUNDS       200     /* # of rounds of each of them */
+
+/* Macro: STRESS_CHECK(cond, msg)
+ * Description: print the failure and return FALSE from the test if 'cond' does not hold
+ */
+#define STRESS_CHECK(cond, msg) \
+BEGIN_MACRO \
+    if (!(cond)) { printf("    FAILED: %s\n", (msg)); return(FALSE); } \
+END_MACRO
+
+
+/* device files of the striping test */
+static char *stress_devices[STRESS_NDEVICES] = { "stress_stripe0.dev", "stress_stripe1.dev" };
+
+/* pages allocated for the tests */
+static PageID stress_pid[STRESS_NPAGES];
+
+/* set to stop the writer thread of stress_Optimistic() */
+static Four stress_stopWriter;
+
+/* # of buffers got zero-filled by the writer threads of stress_NewTrains() */
+static Four stress_nZeroFilled;
+
+
+
+/*@================================
+ * stress_AllocPages()
+ *================================*/
+/*
+ * Function: static Four stress_AllocPages(Four)
+ *
+ * Description:
+ *  Allocate the pages used by the tests and write them zero-filled.
+ *
+ * Returns:
+ *  error code
+ */
+static Four stress_AllocPages(
+    Four        volId)                  /* IN volume of the pages */
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        firstExtNo;             /* first extent number */
+    PageID      nearPid;                /* near pageID */
+    char        *apage;                 /* pointer to the buffer of a page */
+
+
+    e = RDsM_CreateSegment(volId, &firstExtNo);
+    if (e < eNOERROR) ERR(e);
+    e = RDsM_ExtNoToPageId(volId, firstExtNo, &nearPid);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = RDsM_AllocTrains(volId, firstExtNo, (PageID *)&nearPid, 100, 1, PAGESIZE2, &stress_pid[i]);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_GetNewTrain(&stress_pid[i], &apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_SetDirty(&stress_pid[i], PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* stress_AllocPages() */
+
+
+
+/*@================================
+ * stress_SharedPoolChild()
+ *================================*/
+/*
+ * Function: static Four stress_SharedPoolChild(Four, Four)
+ *
+ * Description:
+ *  Body of a process forked by stress_SharedPool(). A writer stores the
+ *  round number in its own pages in every round; a reader fixes all the
+ *  pages of the writers in every round and checks that the number it sees
+ *  in a page never goes back.
+ *
+ * Returns:
+ *  exit status of the process; 0 on success
+ */
+static Four stress_SharedPoolChild(
+    Four        id,                     /* IN # of the writer, or STRESS_NWRITERS + # of the reader */
+    Four        startFd)                /* IN pipe closed by the parent when all are to start */
+{
+    Four        e;                      /* for errors */
+    Four        round;                  /* round number */
+    Four        i;                      /* loop index */
+    char        c;                      /* byte read from the pipe */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    PageID      *pid;                   /* page accessed */
+    Four        seen[STRESS_NWRITERS*STRESS_PAGESPERWRITER]; /* last round seen by a reader */
+
+
+    e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+    if (e < eNOERROR) return(1);
+
+    (void) read(startFd, &c, 1);
+
+    memset(seen, 0, sizeof(seen));
+    for (round = 1; round <= STRESS_NROUNDS; round++) {
+        for (i = 0; i < STRESS_NWRITERS*STRESS_PAGESPERWRITER; i++) {
+            if (id < STRESS_NWRITERS && i / STRESS_PAGESPERWRITER != id) continue;
+
+            pid = &stress_pid[i];
+            e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+            if (e < eNOERROR) return(2);
+
+            if (id < STRESS_NWRITERS) {
+                __atomic_store_n((Four *)apage->data, round, __ATOMIC_RELEASE);
+                e = EduBfM_SetDirty(pid, PAGE_BUF);
+                if (e < eNOERROR) return(3);
+            }
+            else {
+                if (__atomic_load_n((Four *)apage->data, __ATOMIC_ACQUIRE) < seen[i]) return(4);
+                seen[i] = __atomic_load_n((Four *)apage->data, __ATOMIC_ACQUIRE);
+            }
+
+            e = EduBfM_FreeTrain(pid, PAGE_BUF);
+            if (e < eNOERROR) return(5);
+        }
+    }
+
+    e = EduBfM_DetachSharedPool();
+    if (e < eNOERROR) return(6);
+
+    return(0);
+
+}  /* stress_SharedPoolChild() */
+
+
+
+/*@================================
+ * stress_SharedPool()
+ *================================*/
+/*
+ * Function: static Boolean stress_SharedPool(void)
+ *
+ * Description:
+ *  Fork writer and reader processes over the shared buffer pool. All the
+ *  pages accessed are read into the pool by this process first, so that
+ *  the children never read the volume through the file descriptors they
+ *  share. When they are done, the pool must hold the last round of every
+ *  writer with no buffer left fixed, and the last detach must write it
+ *  to the volume.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_SharedPool(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        nPages;                 /* # of pages of the writers */
+    Four        fds[2];                 /* pipe starting the children */
+    pid_t       child[STRESS_NWRITERS+STRESS_NREADERS]; /* children forked */
+    int         status;                 /* exit status of a child */
+    Boolean     ok;                     /* TRUE if all children succeeded */
+    Page        *apage;                 /* pointer to the buffer of a page */
+
+
+    nPages = STRESS_NWRITERS*STRESS_PAGESPERWRITER;
+
+    STRESS_CHECK(pipe(fds) == 0, "pipe");
+    fflush(stdout);
+
+    for (i = 0; i < STRESS_NWRITERS+STRESS_NREADERS; i++) {
+        child[i] = fork();
+        if (child[i] == 0) {
+            close(fds[1]);
+            _exit(stress_SharedPoolChild(i, fds[0]));
+        }
+    }
+    close(fds[0]);
+
+    e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+    if (e < eNOERROR) close(fds[1]);
+    STRESS_CHECK(e == eNOERROR, "attach");
+
+    for (i = 0; i < nPages; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        if (e == eNOERROR) e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        if (e < eNOERROR) break;
+    }
+
+    /* the children start when the write end is closed */
+    close(fds[1]);
+
+    ok = (e == eNOERROR);
+    for (i = 0; i < STRESS_NWRITERS+STRESS_NREADERS; i++) {
+        if (waitpid(child[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("    process %ld exited with %d\n", (long)i, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+            ok = FALSE;
+        }
+    }
+    STRESS_CHECK(ok, "some process failed");
+
+    for (i = 0; i < BI_NBUFS(PAGE_BUF); i++)
+        STRESS_CHECK(BI_FIXED(PAGE_BUF, i) == 0, "a buffer is left fixed");
+
+    for (i = 0; i < nPages; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+        STRESS_CHECK(*(Four *)apage->data == STRESS_NROUNDS, "last round lost in the shared pool");
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+
+    e = EduBfM_DetachSharedPool();
+    STRESS_CHECK(e == eNOERROR, "detach");
+    STRESS_CHECK(access("/dev/shm" STRESS_SHMNAME, F_OK) != 0, "segment not removed");
+
+    for (i = 0; i < nPages; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+        STRESS_CHECK(*(Four *)apage->data == STRESS_NROUNDS, "last round not written by the last detach");
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+
+    return(TRUE);
+
+}  /* stress_SharedPool() */
+
+
+
+/*@================================
+ * stress_OptimisticWriter()
+ *================================*/
+/*
+ * Function: static void *stress_OptimisticWriter(void *)
+ *
+ * Description:
+ *  Writer thread of stress_Optimistic(). Until it is stopped, it fixes the
+ *  page, fills its data with the number of the round one byte at a time
+ *  between EduBfM_BeginWrite() and EduBfM_EndWrite(), and frees it. It
+ *  yields the processor in the middle of the page, so that the reader sees
+ *  half written pages even on a single processor.
+ *
+ * Returns:
+ *  error code, cast to a pointer
+ */
+static void *stress_OptimisticWriter(
+    void        *arg)                   /* IN page to write */
+{
+    Four        e;                      /* for errors */
+    PageID      *pid = (PageID *)arg;   /* page to write */
+    Page        *apage;                 /* pointer to the buffer of the page */
+    volatile char *p;                   /* byte written */
+    Four        round;                  /* round number */
+
+
+    for (round = 0; !__atomic_load_n(&stress_stopWriter, __ATOMIC_ACQUIRE); round++) {
+        e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+        e = EduBfM_BeginWrite(pid, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+
+        for (p = apage->data; p < apage->data + sizeof(apage->data); p++) {
+            *p = (char)round;
+            if (p == apage->data + sizeof(apage->data)/2) sched_yield();
+        }
+
+        e = EduBfM_EndWrite(pid, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+        e = EduBfM_FreeTrain(pid, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+
+        sched_yield();
+    }
+
+    return((void *)(long)eNOERROR);
+
+}  /* stress_OptimisticWriter() */
+
+
+
+/*@================================
+ * stress_Optimistic()
+ *================================*/
+/*
+ * Function: static Boolean stress_Optimistic(void)
+ *
+ * Description:
+ *  Read a page optimistically while a writer thread keeps rewriting it.
+ *  Every read which is validated must see the data of one round only;
+ *  a torn page must be rejected by EduBfM_ValidateOptimistic(). A page
+ *  merely fixed by someone must still be read optimistically. The
+ *  buffer pool is shared so that the pool latch is a real mutex.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_Optimistic(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, j;                   /* loop indexes */
+    PageID      *pid = &stress_pid[0];  /* page read and written */
+    Page        *apage;                 /* pointer to the buffer of the page */
+    UFour       version;                /* version of the buffer */
+    static char copy[PAGESIZE];         /* data copied out of the buffer */
+    Four        nValid = 0;             /* # of reads validated */
+    Four        nTorn = 0;              /* # of torn reads validated */
+    pthread_t   writer;                 /* writer thread */
+    void        *status;                /* error code of the writer */
+
+
+    e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+    STRESS_CHECK(e == eNOERROR, "attach");
+
+    e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train");
+    memset(apage->data, 0, sizeof(apage->data));
+    EduBfM_SetDirty(pid, PAGE_BUF);
+
+    e = EduBfM_GetTrainOptimistic(pid, (char **)&apage, &version, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "optimistic read of a fixed page");
+    STRESS_CHECK(EduBfM_ValidateOptimistic(pid, (char *)apage, version, PAGE_BUF) == TRUE, "validate a fixed page");
+    EduBfM_FreeTrain(pid, PAGE_BUF);
+
+    stress_stopWriter = FALSE;
+    STRESS_CHECK(pthread_create(&writer, NULL, stress_OptimisticWriter, pid) == 0, "pthread_create");
+
+    for (i = 0; i < STRESS_NOPTIMISTIC; i++) {
+        e = EduBfM_GetTrainOptimistic(pid, (char **)&apage, &version, PAGE_BUF);
+        if (e == eNOTFOUND_BFM) continue;
+        if (e < eNOERROR) break;
+
+        memcpy(copy, apage->data, sizeof(apage->data));
+
+        if (EduBfM_ValidateOptimistic(pid, (char *)apage, version, PAGE_BUF) != TRUE) continue;
+
+        nValid++;
+        for (j = 1; j < sizeof(apage->data); j++)
+            if (copy[j] != copy[0]) {
+                nTorn++;
+                break;
+            }
+    }
+
+    __atomic_store_n(&stress_stopWriter, TRUE, __ATOMIC_RELEASE);
+    pthread_join(writer, &status);
+
+    if (nTorn > 0) printf("    %ld of %ld reads validated were torn\n", (long)nTorn, (long)nValid);
+    STRESS_CHECK(e >= eNOERROR || e == eNOTFOUND_BFM, "optimistic read");
+    STRESS_CHECK((long)status == eNOERROR, "writer failed");
+    STRESS_CHECK(nTorn == 0, "torn read validated");
+    STRESS_CHECK(nValid > 0, "no read validated");
+
+    e = EduBfM_DetachSharedPool();
+    STRESS_CHECK(e == eNOERROR, "detach");
+
+    return(TRUE);
+
+}  /* stress_Optimistic() */
+
+
+
+/*@================================
+ * stress_ReadAheadFixed()
+ *================================*/
+/*
+ * Function: static Boolean stress_ReadAheadFixed(void)
+ *
+ * Description:
+ *  Read pages sequentially with read-ahead enabled while most of the
+ *  buffers are fixed; the window is larger than the buffers left, so the
+ *  read-ahead must be cut short instead of waiting for a victim.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_ReadAheadFixed(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        nFixed;                 /* # of buffers kept fixed */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    BfMReadAheadStat stat;              /* statistics of read-ahead */
+
+
+    nFixed = BI_NBUFS(PAGE_BUF) - 2;
+
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+    (void) EduBfM_GetReadAheadStat(&stat, TRUE);
+    e = EduBfM_SetReadAhead(8);
+    STRESS_CHECK(e == eNOERROR, "set read-ahead");
+
+    for (i = 0; i < nFixed; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+    }
+
+    for (i = nFixed; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "sequential get train");
+        e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "sequential free train");
+    }
+
+    for (i = 0; i < nFixed; i++) {
+        e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "free train");
+    }
+
+    (void) EduBfM_SetReadAhead(0);
+    (void) EduBfM_GetReadAheadStat(&stat, TRUE);
+    STRESS_CHECK(stat.nPrefetched > 0, "nothing read ahead");
+
+    return(TRUE);
+
+}  /* stress_ReadAheadFixed() */
+
+
+
+/*@================================
+ * stress_RamStorage()
+ *================================*/
+/*
+ * Function: static Boolean stress_RamStorage(void)
+ *
+ * Description:
+ *  Write a page to the RAM backend, switch to the file backend and back;
+ *  the page written to the RAM backend must be gone, so the page of the
+ *  volume is read again.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_RamStorage(void)
+{
+    Four        e;                      /* for errors */
+    PageID      *pid = &stress_pid[0];  /* page read and written */
+    Page        *apage;                 /* pointer to the buffer of the page */
+    char        orig;                   /* first byte of the page on the volume */
+
+
+    e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train");
+    orig = apage->data[0];
+    EduBfM_FreeTrain(pid, PAGE_BUF);
+
+    e = EduBfM_SetStorage(BFM_STORAGE_RAM, 0, 0);
+    STRESS_CHECK(e == eNOERROR, "select the RAM backend");
+
+    e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train from the RAM backend");
+    STRESS_CHECK(apage->data[0] == orig, "page of the volume not read");
+    apage->data[0] = orig + 1;
+    EduBfM_SetDirty(pid, PAGE_BUF);
+    EduBfM_FreeTrain(pid, PAGE_BUF);
+
+    /* another delay keeps the pages of the RAM backend */
+    e = EduBfM_SetStorage(BFM_STORAGE_RAM, 1, 0);
+    STRESS_CHECK(e == eNOERROR, "delay the RAM backend");
+    e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train from the delayed RAM backend");
+    STRESS_CHECK(apage->data[0] == (char)(orig + 1), "page written to the RAM backend lost");
+    EduBfM_FreeTrain(pid, PAGE_BUF);
+
+    e = EduBfM_SetStorage(BFM_STORAGE_FILE, 0, 0);
+    STRESS_CHECK(e == eNOERROR, "select the file backend");
+    e = EduBfM_SetStorage(BFM_STORAGE_RAM, 0, 0);
+    STRESS_CHECK(e == eNOERROR, "select the RAM backend again");
+
+    e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train from the RAM backend again");
+    STRESS_CHECK(apage->data[0] == orig, "stale page of the RAM backend read");
+    EduBfM_FreeTrain(pid, PAGE_BUF);
+
+    e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+    STRESS_CHECK(e == eRAMSTORAGEUSED_EDUBFM, "shared pool attached with the RAM backend");
+
+    e = EduBfM_SetStorage(BFM_STORAGE_FILE, 0, 0);
+    STRESS_CHECK(e == eNOERROR, "select the file backend again");
+
+    e = EduBfM_GetTrain(pid, (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train from the file backend");
+    STRESS_CHECK(apage->data[0] == orig, "page written to the RAM backend reached the volume");
+    EduBfM_FreeTrain(pid, PAGE_BUF);
+
+    return(TRUE);
+
+}  /* stress_RamStorage() */
+
+
+
+/*@================================
+ * stress_DelayReader()
+ *================================*/
+/*
+ * Function: static void *stress_DelayReader(void *)
+ *
+ * Description:
+ *  Read one page through the current backend, for stress_DelayQueue().
+ *
+ * Returns:
+ *  NULL
+ */
+static void *stress_DelayReader(
+    void        *arg)                   /* IN page to read */
+{
+    char        buf[PAGESIZE];          /* page read */
+
+
+    (void) BFM_STORAGE_READ((TrainID*)arg, buf, 1);
+
+    return(NULL);
+
+}  /* stress_DelayReader() */
+
+
+
+/*@================================
+ * stress_DelayQueue()
+ *================================*/
+/*
+ * Function: static Boolean stress_DelayQueue(void)
+ *
+ * Description:
+ *  Read pages through the delay backend from several threads at once;
+ *  the I/Os are queued on the one emulated device, so they take the
+ *  latency each one after another, not once for all.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_DelayQueue(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    pthread_t   reader[STRESS_NDELAYREADERS];   /* reader threads */
+    struct timespec start, end;         /* time of the reads */
+    double      seconds;                /* time taken */
+
+
+    e = EduBfM_SetStorage(BFM_STORAGE_FILE, STRESS_DELAY_LATENCY, 0);
+    STRESS_CHECK(e == eNOERROR, "delay the file backend");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < STRESS_NDELAYREADERS; i++)
+        STRESS_CHECK(pthread_create(&reader[i], NULL, stress_DelayReader, &stress_pid[i]) == 0, "pthread_create");
+    for (i = 0; i < STRESS_NDELAYREADERS; i++)
+        pthread_join(reader[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    e = EduBfM_SetStorage(BFM_STORAGE_FILE, 0, 0);
+    STRESS_CHECK(e == eNOERROR, "select the file backend");
+
+    STRESS_CHECK(seconds >= STRESS_NDELAYREADERS * STRESS_DELAY_LATENCY / 1e6, "delays of concurrent I/Os overlapped");
+
+    return(TRUE);
+
+}  /* stress_DelayQueue() */
+
+
+
+/*@================================
+ * stress_CheckPage()
+ *================================*/
+/*
+ * Function: static Boolean stress_CheckPage(char *, Four)
+ *
+ * Description:
+ *  Check that the data of a page holds the pattern written by
+ *  stress_Compression() for the i-th page.
+ *
+ * Returns:
+ *  TRUE if the pattern is there
+ */
+static Boolean stress_CheckPage(
+    char        *data,                  /* IN data of the page */
+    Four        i)                      /* IN position of the page in stress_pid */
+{
+    Four        j;                      /* index */
+
+
+    for (j = 0; j < sizeof(((Page *)0)->data); j++)
+        if (data[j] != (char)(i + j / 64)) return(FALSE);
+
+    return(TRUE);
+
+}  /* stress_CheckPage() */
+
+
+
+/*@================================
+ * stress_Compression()
+ *================================*/
+/*
+ * Function: static Boolean stress_Compression(void)
+ *
+ * Description:
+ *  Write a distinct pattern to more pages than there are buffers on a
+ *  compressed volume, so that dirty victims are flushed next to dirty
+ *  neighbors; flush, discard and read them all back, also as the first
+ *  page of a longer train. Then stop the compression and check that the
+ *  pages kept in the side file were written back to the volume.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_Compression(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, j;                   /* loop indexes */
+    VolNo       volNo = stress_pid[0].volNo;    /* volume compressed */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong;                 /* # of pages read back wrong */
+    struct stat st;                     /* status of the side file */
+
+
+    unlink(STRESS_SIDEFILE);
+    e = EduBfM_SetCompression(volNo, STRESS_SIDEFILE);
+    STRESS_CHECK(e == eNOERROR, "compress the volume");
+
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+        for (j = 0; j < sizeof(apage->data); j++)
+            apage->data[j] = (char)(i + j / 64);
+        EduBfM_SetDirty(&stress_pid[i], PAGE_BUF);
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+
+    e = EduBfM_FlushAll();
+    STRESS_CHECK(e == eNOERROR, "flush all");
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+
+    nWrong = 0;
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train from the side file");
+        if (!stress_CheckPage(apage->data, i)) nWrong++;
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+    if (nWrong > 0) printf("    %ld of %ld pages read back wrong\n", (long)nWrong, (long)STRESS_NPAGES);
+    STRESS_CHECK(nWrong == 0, "pages lost in the side file");
+
+    /* a longer train starting at a page written alone */
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, LOT_LEAF_BUF);
+    STRESS_CHECK(e == eNOERROR, "get a long train from the side file");
+    STRESS_CHECK(stress_CheckPage(apage->data, 0), "first page of a long train read back wrong");
+    EduBfM_FreeTrain(&stress_pid[0], LOT_LEAF_BUF);
+
+    e = EduBfM_SetCompression(volNo, NULL);
+    STRESS_CHECK(e == eNOERROR, "stop compressing the volume");
+    STRESS_CHECK(stat(STRESS_SIDEFILE, &st) == 0 && st.st_size == 0, "side file not emptied");
+    unlink(STRESS_SIDEFILE);
+
+    nWrong = 0;
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train from the volume");
+        if (!stress_CheckPage(apage->data, i)) nWrong++;
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+    if (nWrong > 0) printf("    %ld of %ld pages not written back\n", (long)nWrong, (long)STRESS_NPAGES);
+    STRESS_CHECK(nWrong == 0, "pages of the side file lost");
+
+    return(TRUE);
+
+}  /* stress_Compression() */
+
+
+
+/*@================================
+ * stress_WritePages()
+ *================================*/
+/*
+ * Function: static Boolean stress_WritePages(Four, Four, Boolean)
+ *
+ * Description:
+ *  Write every 'step'-th page from the 'first'-th one with the pattern of
+ *  stress_CheckPage(), its first half replaced by noise if 'noisy' is
+ *  TRUE so that it compresses much less, and flush them.
+ *
+ * Returns:
+ *  TRUE if the pages were written
+ */
+static Boolean stress_WritePages(
+    Four        first,                  /* IN position of the first page in stress_pid */
+    Four        step,                   /* IN distance between the pages written */
+    Boolean     noisy)                  /* IN TRUE to write noise in the first half */
+{
+    Four        e;                      /* for errors */
+    Four        i, j;                   /* loop indexes */
+    Page        *apage;                 /* pointer to the buffer of a page */
+
+
+    for (i = first; i < STRESS_NPAGES; i += step) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+        for (j = 0; j < sizeof(apage->data); j++)
+            apage->data[j] = (noisy && j < sizeof(apage->data) / 2) ?
+                             (char)(((UFour)(i * PAGESIZE + j) * 2654435761U) >> 24) : (char)(i + j / 64);
+        EduBfM_SetDirty(&stress_pid[i], PAGE_BUF);
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+
+    e = EduBfM_FlushAll();
+    STRESS_CHECK(e == eNOERROR, "flush all");
+
+    return(TRUE);
+
+}  /* stress_WritePages() */
+
+
+
+/*@================================
+ * stress_ReopenSideFile()
+ *================================*/
+/*
+ * Function: static Boolean stress_ReopenSideFile(Four, off_t *)
+ *
+ * Description:
+ *  Give the side file again, so that its index is rebuilt from it, discard
+ *  all buffers and check the pages written by stress_WritePages(): the
+ *  first half of the page is not checked for the pages whose position is
+ *  a multiple of 'noisyStep'. Return the size of the side file.
+ *
+ * Returns:
+ *  TRUE if the pages were read back right
+ */
+static Boolean stress_ReopenSideFile(
+    Four        noisyStep,              /* IN distance between the noisy pages; 0 if none */
+    off_t       *size)                  /* OUT size of the side file */
+{
+    Four        e;                      /* for errors */
+    Four        i, j;                   /* loop indexes */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong;                 /* # of pages read back wrong */
+    struct stat st;                     /* status of the side file */
+
+
+    e = EduBfM_SetCompression(stress_pid[0].volNo, STRESS_SIDEFILE);
+    STRESS_CHECK(e == eNOERROR, "give the side file again");
+    STRESS_CHECK(stat(STRESS_SIDEFILE, &st) == 0, "stat the side file");
+    *size = st.st_size;
+
+    nWrong = 0;
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train from the side file");
+        for (j = (noisyStep > 0 && i % noisyStep == 0) ? sizeof(apage->data) / 2 : 0; j < sizeof(apage->data); j++)
+            if (apage->data[j] != (char)(i + j / 64)) break;
+        if (j < sizeof(apage->data)) nWrong++;
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+    if (nWrong > 0) printf("    %ld of %ld pages read back wrong\n", (long)nWrong, (long)STRESS_NPAGES);
+    STRESS_CHECK(nWrong == 0, "pages lost in the side file");
+
+    return(TRUE);
+
+}  /* stress_ReopenSideFile() */
+
+
+
+/*@================================
+ * stress_CompressionRewrite()
+ *================================*/
+/*
+ * Function: static Boolean stress_CompressionRewrite(void)
+ *
+ * Description:
+ *  Write well compressible pages to a compressed volume and check that
+ *  their extents share the blocks of the side file; rewrite every other
+ *  page with noise, so that it moves to a larger extent, then back, so
+ *  that it shrinks in place, and give the side file again after each
+ *  round so that the pages are found from the headers of their extents.
+ *  The side file must not grow in the last round.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_CompressionRewrite(void)
+{
+    Four        e;                      /* for errors */
+    off_t       packed;                 /* size of the side file after the first round */
+    off_t       moved;                  /* size after the pages moved */
+    off_t       shrunk;                 /* size after the pages shrank */
+
+
+    unlink(STRESS_SIDEFILE);
+    e = EduBfM_SetCompression(stress_pid[0].volNo, STRESS_SIDEFILE);
+    STRESS_CHECK(e == eNOERROR, "compress the volume");
+
+    if (!stress_WritePages(0, 1, FALSE)) return(FALSE);
+    if (!stress_ReopenSideFile(0, &packed)) return(FALSE);
+    STRESS_CHECK(packed <= STRESS_NPAGES * PAGESIZE / 4, "compressed pages not packed");
+
+    if (!stress_WritePages(0, 2, TRUE)) return(FALSE);
+    if (!stress_ReopenSideFile(2, &moved)) return(FALSE);
+    STRESS_CHECK(moved > packed, "noisy pages not moved to larger extents");
+
+    if (!stress_WritePages(0, 2, FALSE)) return(FALSE);
+    if (!stress_ReopenSideFile(0, &shrunk)) return(FALSE);
+    STRESS_CHECK(shrunk == moved, "side file grew when the pages shrank");
+
+    return(TRUE);
+
+}  /* stress_CompressionRewrite() */
+
+
+
+/*@================================
+ * stress_CompressionMode()
+ *================================*/
+/*
+ * Function: static Boolean stress_CompressionMode(void)
+ *
+ * Description:
+ *  Compress the volume and write a page, then stop the compression behind
+ *  the back of EduBfM_SetCompression(), as a process which does not give
+ *  the side file would find the volume, and check that the trains of the
+ *  volume are refused until the side file is given again, and are read
+ *  once the compression is stopped.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_CompressionMode(void)
+{
+    Four        e;                      /* for errors */
+    VolNo       volNo = stress_pid[0].volNo;    /* volume compressed */
+    Page        *apage;                 /* pointer to the buffer of a page */
+
+
+    unlink(STRESS_SIDEFILE);
+    e = EduBfM_SetCompression(volNo, STRESS_SIDEFILE);
+    STRESS_CHECK(e == eNOERROR, "compress the volume");
+    if (!stress_WritePages(0, STRESS_NPAGES, FALSE)) return(FALSE);
+
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+    e = edubfm_SetCompression(volNo, NULL);
+    STRESS_CHECK(e == eNOERROR, "forget the side file");
+
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eVOLUMEMODEMISMATCH_EDUBFM, "compressed volume read without its side file");
+
+    e = EduBfM_SetCompression(volNo, STRESS_SIDEFILE);
+    STRESS_CHECK(e == eNOERROR, "give the side file again");
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train with the side file");
+    EduBfM_FreeTrain(&stress_pid[0], PAGE_BUF);
+
+    e = EduBfM_SetCompression(volNo, NULL);
+    STRESS_CHECK(e == eNOERROR, "stop compressing the volume");
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train once the compression is stopped");
+    STRESS_CHECK(apage->data[PAGESIZE/2] == (char)(PAGESIZE/2 / 64), "page not written back");
+    EduBfM_FreeTrain(&stress_pid[0], PAGE_BUF);
+
+    return(TRUE);
+
+}  /* stress_CompressionMode() */
+
+
+
+/*@================================
+ * stress_Striping()
+ *================================*/
+/*
+ * Function: static Boolean stress_Striping(void)
+ *
+ * Description:
+ *  Write a distinct pattern to the pages of a striped volume, flush,
+ *  discard and read them back; then stop the striping and check that the
+ *  pages kept in the device files were written back to the volume.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_Striping(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, j;                   /* loop indexes */
+    VolNo       volNo = stress_pid[0].volNo;    /* volume striped */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong;                 /* # of pages read back wrong */
+    struct stat st;                     /* status of a device file */
+
+
+    for (i = 0; i < STRESS_NDEVICES; i++) unlink(stress_devices[i]);
+    e = EduBfM_SetStriping(volNo, STRESS_NDEVICES, stress_devices);
+    STRESS_CHECK(e == eNOERROR, "stripe the volume");
+
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+        for (j = 0; j < sizeof(apage->data); j++)
+            apage->data[j] = (char)(i + j / 64);
+        EduBfM_SetDirty(&stress_pid[i], PAGE_BUF);
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+
+    e = EduBfM_FlushAll();
+    STRESS_CHECK(e == eNOERROR, "flush all");
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+
+    nWrong = 0;
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train from the device files");
+        if (!stress_CheckPage(apage->data, i)) nWrong++;
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+    STRESS_CHECK(nWrong == 0, "pages lost in the device files");
+
+    e = EduBfM_SetStriping(volNo, 0, NULL);
+    STRESS_CHECK(e == eNOERROR, "stop striping the volume");
+    for (i = 0; i < STRESS_NDEVICES; i++) {
+        STRESS_CHECK(stat(stress_devices[i], &st) == 0 && st.st_size == 0, "device file not emptied");
+        unlink(stress_devices[i]);
+    }
+
+    nWrong = 0;
+    for (i = 0; i < STRESS_NPAGES; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train from the volume");
+        if (!stress_CheckPage(apage->data, i)) nWrong++;
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+    if (nWrong > 0) printf("    %ld of %ld pages not written back\n", (long)nWrong, (long)STRESS_NPAGES);
+    STRESS_CHECK(nWrong == 0, "pages of the device files lost");
+
+    return(TRUE);
+
+}  /* stress_Striping() */
+
+
+
+/*@================================
+ * stress_StripingMode()
+ *================================*/
+/*
+ * Function: static Boolean stress_StripingMode(void)
+ *
+ * Description:
+ *  Stripe the volume and write the pages, then stop the striping, and
+ *  stripe it over fewer devices, behind the back of EduBfM_SetStriping(),
+ *  as processes which do not give all the device files would find the
+ *  volume; check that the trains of the volume are refused until the same
+ *  # of device files is given again, and are read once the striping is
+ *  stopped.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_StripingMode(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    VolNo       volNo = stress_pid[0].volNo;    /* volume striped */
+    Page        *apage;                 /* pointer to the buffer of a page */
+
+
+    for (i = 0; i < STRESS_NDEVICES; i++) unlink(stress_devices[i]);
+    e = EduBfM_SetStriping(volNo, STRESS_NDEVICES, stress_devices);
+    STRESS_CHECK(e == eNOERROR, "stripe the volume");
+    if (!stress_WritePages(0, STRESS_NPAGES, FALSE)) return(FALSE);
+
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+    e = edubfm_SetStriping(volNo, 0, NULL);
+    STRESS_CHECK(e == eNOERROR, "forget the device files");
+
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eVOLUMEMODEMISMATCH_EDUBFM, "striped volume read without its device files");
+    e = EduBfM_GetNewTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eVOLUMEMODEMISMATCH_EDUBFM, "new train of a striped volume without its device files");
+
+    e = edubfm_SetStriping(volNo, STRESS_NDEVICES - 1, stress_devices);
+    STRESS_CHECK(e == eNOERROR, "stripe over fewer devices");
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eVOLUMEMODEMISMATCH_EDUBFM, "striped volume read over fewer devices");
+
+    e = EduBfM_SetStriping(volNo, STRESS_NDEVICES, stress_devices);
+    STRESS_CHECK(e == eNOERROR, "give the device files again");
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train with the device files");
+    EduBfM_FreeTrain(&stress_pid[0], PAGE_BUF);
+
+    e = EduBfM_SetStriping(volNo, 0, NULL);
+    STRESS_CHECK(e == eNOERROR, "stop striping the volume");
+    for (i = 0; i < STRESS_NDEVICES; i++) unlink(stress_devices[i]);
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get train once the striping is stopped");
+    STRESS_CHECK(apage->data[PAGESIZE/2] == (char)(PAGESIZE/2 / 64), "page not written back");
+    EduBfM_FreeTrain(&stress_pid[0], PAGE_BUF);
+
+    return(TRUE);
+
+}  /* stress_StripingMode() */
+
+
+
+/*@================================
+ * stress_StripedBatches()
+ *================================*/
+/*
+ * Function: static Boolean stress_StripedBatches(void)
+ *
+ * Description:
+ *  Stripe the volume and write noise to every other page, so that the
+ *  other pages are holes in the device files; then read all pages
+ *  sequentially with read-ahead, by batches through an io_uring, by
+ *  preadv() one at a time, and by worker threads, and check that the
+ *  pages written are read from the device files and the holes from the
+ *  volume. With the worker threads, the reads ahead are left in flight
+ *  and the holes are read from the volume when the pages are referenced.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_StripedBatches(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, j, m;                /* loop indexes */
+    VolNo       volNo = stress_pid[0].volNo;    /* volume striped */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        uring[] = { TRUE, FALSE, TRUE };        /* io_uring of each mode */
+    Four        nThreads[] = { 0, 0, 4 };               /* # of threads of each mode */
+    Four        nWrong;                 /* # of pages read back wrong */
+    BfMReadAheadStat stat;              /* statistics of read-ahead */
+
+
+    for (i = 0; i < STRESS_NDEVICES; i++) unlink(stress_devices[i]);
+    e = EduBfM_SetStriping(volNo, STRESS_NDEVICES, stress_devices);
+    STRESS_CHECK(e == eNOERROR, "stripe the volume");
+    if (!stress_WritePages(0, 2, TRUE)) return(FALSE);
+
+    (void) EduBfM_GetReadAheadStat(&stat, TRUE);
+    e = EduBfM_SetReadAhead(8);
+    STRESS_CHECK(e == eNOERROR, "enable read-ahead");
+
+    for (m = 0; m < sizeof(uring) / sizeof(uring[0]); m++) {
+        edubfm_uringEnabled = uring[m];
+        e = EduBfM_SetIOEngine(nThreads[m]);
+        STRESS_CHECK(e == eNOERROR, "set the I/O engine");
+        e = EduBfM_DiscardAll();
+        STRESS_CHECK(e == eNOERROR, "discard all");
+
+        nWrong = 0;
+        for (i = 0; i < STRESS_NPAGES; i++) {
+            e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+            STRESS_CHECK(e == eNOERROR, "get train");
+            for (j = 0; j < sizeof(apage->data); j++)
+                if (apage->data[j] != ((i % 2 == 0 && j < sizeof(apage->data) / 2) ?
+                                       (char)(((UFour)(i * PAGESIZE + j) * 2654435761U) >> 24) : (char)(i + j / 64)))
+                    break;
+            if (j < sizeof(apage->data)) nWrong++;
+            EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        }
+        if (nWrong > 0) printf("    %ld of %ld pages read wrong in mode %ld\n", (long)nWrong, (long)STRESS_NPAGES, (long)m);
+        STRESS_CHECK(nWrong == 0, "pages read wrong by batches");
+    }
+    edubfm_uringEnabled = TRUE;
+
+    e = EduBfM_SetIOEngine(0);
+    STRESS_CHECK(e == eNOERROR, "stop the I/O engine");
+    (void) EduBfM_SetReadAhead(0);
+    (void) EduBfM_GetReadAheadStat(&stat, TRUE);
+    STRESS_CHECK(stat.nPrefetched > 0, "nothing read ahead");
+    STRESS_CHECK(stat.nAsync > 0, "no read ahead left in flight");
+
+    /* leave the pattern of stress_CheckPage() in the volume */
+    e = EduBfM_SetStriping(volNo, 0, NULL);
+    STRESS_CHECK(e == eNOERROR, "stop striping the volume");
+    for (i = 0; i < STRESS_NDEVICES; i++) unlink(stress_devices[i]);
+    if (!stress_WritePages(0, 1, FALSE)) return(FALSE);
+
+    return(TRUE);
+
+}  /* stress_StripedBatches() */
+
+
+
+/*@================================
+ * stress_Clustering()
+ *================================*/
+/*
+ * Function: static Boolean stress_Clustering(void)
+ *
+ * Description:
+ *  Make runs of dirty and unfixed pages of every length up to
+ *  BFM_CLUSTER_MAXPAGES, or as many as the buffers allow, starting at
+ *  every position of a train, between a dirty page kept fixed and a clean
+ *  page; flush each run from its first, middle and last page by
+ *  edubfm_FlushCluster(), with and without the worker threads, and check
+ *  that the whole run, and only the run, is marked clean and reaches the
+ *  volume.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_Clustering(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, j, k, m, s, n;       /* loop indexes */
+    Four        victim[3];              /* positions in the run of the victims */
+    Four        base;                   /* position in stress_pid of the adjacent pages used */
+    Four        first;                  /* position of the first page of the run */
+    Four        round = 0;              /* round number written to the pages */
+    Four        idx;                    /* index of a buffer */
+    Four        nThreads[] = { 0, 4 };  /* # of threads of each mode */
+    Four        maxPages;               /* length of the longest run */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong;                 /* # of pages read back wrong */
+
+
+    /* the run and the pages around it must fit in the buffers */
+    maxPages = (BI_NBUFS(PAGE_BUF) - 2 < BFM_CLUSTER_MAXPAGES) ? BI_NBUFS(PAGE_BUF) - 2 : BFM_CLUSTER_MAXPAGES;
+
+    /* a page before the runs, the runs shifted by up to a train, and a page after them */
+    for (base = 0; base + BFM_CLUSTER_MAXPAGES + BFM_CLUSTER_NPAGES + 1 < STRESS_NPAGES; base++) {
+        for (i = 1; i <= BFM_CLUSTER_MAXPAGES + BFM_CLUSTER_NPAGES; i++)
+            if (stress_pid[base+i].pageNo != stress_pid[base].pageNo + i) break;
+        if (i > BFM_CLUSTER_MAXPAGES + BFM_CLUSTER_NPAGES) break;
+    }
+    STRESS_CHECK(base + BFM_CLUSTER_MAXPAGES + BFM_CLUSTER_NPAGES + 1 < STRESS_NPAGES, "no adjacent pages");
+
+    for (m = 0; m < sizeof(nThreads) / sizeof(nThreads[0]); m++) {
+        e = EduBfM_SetIOEngine(nThreads[m]);
+        STRESS_CHECK(e == eNOERROR, "set the I/O engine");
+
+        for (s = 0; s < BFM_CLUSTER_NPAGES; s++)
+        for (n = 1; n <= maxPages; n++)
+        for (victim[0] = 0, victim[1] = n / 2, victim[2] = n - 1, k = 0; k < 3; k++) {
+            e = EduBfM_DiscardAll();
+            STRESS_CHECK(e == eNOERROR, "discard all");
+            first = base + s + 1;
+            round++;
+
+            /* the page before the run is kept fixed, the page after it is left clean */
+            for (i = first - 1; i <= first + n; i++) {
+                e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+                STRESS_CHECK(e == eNOERROR, "get train");
+                if (i == first + n) {
+                    EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+                    continue;
+                }
+                for (j = 0; j < sizeof(apage->data); j++)
+                    apage->data[j] = (char)(i + j / 64);
+                *(Four *)apage->data = round;
+                EduBfM_SetDirty(&stress_pid[i], PAGE_BUF);
+                if (i >= first) EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+            }
+
+            e = edubfm_FlushCluster(&stress_pid[first + victim[k]], PAGE_BUF);
+            STRESS_CHECK(e == eNOERROR, "flush the run");
+
+            nWrong = 0;
+            for (i = first - 1; i < first + n; i++) {
+                idx = edubfm_LookUp((BfMHashKey *)&stress_pid[i], PAGE_BUF);
+                STRESS_CHECK(idx != NOTFOUND_IN_HTABLE, "page of the run replaced");
+                if ((i < first) != ((BI_BITS(PAGE_BUF, idx) & DIRTY) != 0)) nWrong++;
+            }
+            if (nWrong > 0) printf("    %ld pages of %ld wrongly dirty: start %ld, victim %ld, mode %ld\n",
+                                   (long)nWrong, (long)n, (long)s, (long)victim[k], (long)m);
+            STRESS_CHECK(nWrong == 0, "run not marked clean");
+
+            EduBfM_FreeTrain(&stress_pid[first - 1], PAGE_BUF);
+            e = EduBfM_DiscardAll();
+            STRESS_CHECK(e == eNOERROR, "discard all");
+
+            nWrong = 0;
+            for (i = first - 1; i < first + n; i++) {
+                e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+                STRESS_CHECK(e == eNOERROR, "get train from the volume");
+                for (j = sizeof(Four); j < sizeof(apage->data); j++)
+                    if (apage->data[j] != (char)(i + j / 64)) break;
+                if ((i < first) == (j == sizeof(apage->data) && *(Four *)apage->data == round)) nWrong++;
+                EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+            }
+            if (nWrong > 0) printf("    %ld pages of %ld wrongly written: start %ld, victim %ld, mode %ld\n",
+                                   (long)nWrong, (long)n, (long)s, (long)victim[k], (long)m);
+            STRESS_CHECK(nWrong == 0, "run not written or fixed page written");
+        }
+    }
+
+    e = EduBfM_SetIOEngine(0);
+    STRESS_CHECK(e == eNOERROR, "stop the I/O engine");
+
+    /* leave the pattern of stress_CheckPage() in the volume */
+    if (!stress_WritePages(0, 1, FALSE)) return(FALSE);
+
+    return(TRUE);
+
+}  /* stress_Clustering() */
+
+
+
+/*@================================
+ * stress_LookUpCacheReader()
+ *================================*/
+/*
+ * Function: static void *stress_LookUpCacheReader(void *)
+ *
+ * Description:
+ *  Reader thread of stress_LookUpCache(). It fixes pages picked at random,
+ *  mostly among a few hot ones so that its thread-local cache hits, and
+ *  sometimes among all pages so that the buffers are replaced under the
+ *  entries cached by the other threads; it checks that each fixed buffer
+ *  holds the page asked for.
+ *
+ * Returns:
+ *  # of buffers holding another page, an error code, or -1 if the cache
+ *  never hit, cast to a pointer
+ */
+static void *stress_LookUpCacheReader(
+    void        *arg)                   /* IN seed of the random numbers */
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* position of the page in stress_pid */
+    Four        n;                      /* loop index */
+    UFour       seed = (UFour)(long)arg;        /* state of the random numbers */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong = 0;             /* # of buffers holding another page */
+    BfMLookUpStat stat;                 /* statistics of the lookups of this thread */
+
+
+    (void) EduBfM_GetLookUpStat(&stat, TRUE);
+
+    for (n = 0; n < STRESS_NLOOKUPS; n++) {
+        seed = seed * 1103515245 + 12345;
+        i = (seed >> 16) % 8 ? (seed >> 8) % STRESS_NHOTPAGES : (seed >> 8) % STRESS_NPAGES;
+
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+        if (!stress_CheckPage(apage->data, i)) nWrong++;
+        e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+    }
+
+    (void) EduBfM_GetLookUpStat(&stat, FALSE);
+    if (stat.nCacheHits == 0) return((void *)(long)-1);
+
+    return((void *)(long)nWrong);
+
+}  /* stress_LookUpCacheReader() */
+
+
+
+/*@================================
+ * stress_LookUpCache()
+ *================================*/
+/*
+ * Function: static Boolean stress_LookUpCache(void)
+ *
+ * Description:
+ *  Fill the thread-local cache of this thread in the private buffer pool,
+ *  attach the shared segment and run reader threads fixing pages while
+ *  the buffers are replaced under their caches, then detach it; the
+ *  buffers found by this thread must hold the pages asked for in both
+ *  pools, although its cached entries point into the other pool.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_LookUpCache(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, p;                   /* loop indexes */
+    pthread_t   reader[STRESS_NLOOKUPREADERS];  /* reader threads */
+    void        *status;                /* value returned by a reader */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong;                 /* # of buffers holding another page */
+
+
+    for (p = 0; p < 3; p++) {
+        if (p == 1) {
+            e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+            STRESS_CHECK(e == eNOERROR, "attach");
+        }
+
+        /* the entries cached in the last pool are looked up again */
+        nWrong = 0;
+        for (i = 0; i < 2 * STRESS_NHOTPAGES; i++) {
+            e = EduBfM_GetTrain(&stress_pid[i % STRESS_NHOTPAGES + p], (char **)&apage, PAGE_BUF);
+            STRESS_CHECK(e == eNOERROR, "get train");
+            if (!stress_CheckPage(apage->data, i % STRESS_NHOTPAGES + p)) nWrong++;
+            EduBfM_FreeTrain(&stress_pid[i % STRESS_NHOTPAGES + p], PAGE_BUF);
+        }
+        STRESS_CHECK(nWrong == 0, "buffer of another page found after the pool changed");
+
+        if (p == 1) {
+            for (i = 0; i < STRESS_NLOOKUPREADERS; i++)
+                STRESS_CHECK(pthread_create(&reader[i], NULL, stress_LookUpCacheReader, (void *)(long)(i + 1)) == 0,
+                             "pthread_create");
+            nWrong = 0;
+            for (i = 0; i < STRESS_NLOOKUPREADERS; i++) {
+                STRESS_CHECK(pthread_join(reader[i], &status) == 0, "pthread_join");
+                STRESS_CHECK((long)status >= 0, "reader failed or never hit its cache");
+                nWrong += (long)status;
+            }
+            if (nWrong > 0) printf("    %ld buffers held another page\n", (long)nWrong);
+            STRESS_CHECK(nWrong == 0, "buffer of another page found through the cache");
+
+            e = EduBfM_DetachSharedPool();
+            STRESS_CHECK(e == eNOERROR, "detach");
+        }
+    }
+
+    return(TRUE);
+
+}  /* stress_LookUpCache() */
+
+
+
+/*@================================
+ * stress_NewTrainWriter()
+ *================================*/
+/*
+ * Function: static void *stress_NewTrainWriter(void *)
+ *
+ * Description:
+ *  Writer thread of stress_NewTrains(). In every round, it gets each of
+ *  its pages by EduBfM_GetNewTrain(), checks that the buffer is either
+ *  zero-filled or still holds what it wrote in the last round, writes the
+ *  round number and the pattern of stress_CheckPage() and marks it dirty;
+ *  then it gets the page shared by all writers, racing with them.
+ *
+ * Returns:
+ *  # of buffers holding something else, or an error code, cast to a pointer
+ */
+static void *stress_NewTrainWriter(
+    void        *arg)                   /* IN number of the writer */
+{
+    Four        e;                      /* for errors */
+    Four        t = (Four)(long)arg;    /* number of the writer */
+    Four        i, j;                   /* loop indexes */
+    Four        round;                  /* round number */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong = 0;             /* # of buffers holding something else */
+    PageID      *shared = &stress_pid[STRESS_NPAGES - 1];       /* page shared by the writers */
+
+
+    for (round = 1; round <= STRESS_NNEWROUNDS; round++) {
+        for (i = t; i < STRESS_NPAGES - 1; i += STRESS_NNEWWRITERS) {
+            e = EduBfM_GetNewTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+            if (e < eNOERROR) return((void *)(long)e);
+
+            if (*(Four *)apage->data == 0) {
+                for (j = 0; j < sizeof(apage->data); j++)
+                    if (apage->data[j] != 0) break;
+                if (j < sizeof(apage->data)) nWrong++;
+                __atomic_add_fetch(&stress_nZeroFilled, 1, __ATOMIC_RELAXED);
+            }
+            else if (*(Four *)apage->data != round - 1 || apage->data[PAGESIZE/2] != (char)(i + PAGESIZE/2 / 64))
+                nWrong++;
+
+            for (j = 0; j < sizeof(apage->data); j++)
+                apage->data[j] = (char)(i + j / 64);
+            *(Four *)apage->data = round;
+
+            e = EduBfM_SetDirty(&stress_pid[i], PAGE_BUF);
+            if (e < eNOERROR) return((void *)(long)e);
+            e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+            if (e < eNOERROR) return((void *)(long)e);
+        }
+
+        e = EduBfM_GetNewTrain(shared, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+        e = EduBfM_FreeTrain(shared, PAGE_BUF);
+        if (e < eNOERROR) return((void *)(long)e);
+    }
+
+    return((void *)(long)nWrong);
+
+}  /* stress_NewTrainWriter() */
+
+
+
+/*@================================
+ * stress_NewTrains()
+ *================================*/
+/*
+ * Function: static Boolean stress_NewTrains(void)
+ *
+ * Description:
+ *  Run writer threads getting their pages by EduBfM_GetNewTrain() in a
+ *  shared buffer pool with more pages than buffers, so that the trains are
+ *  written out and got again zero-filled, and one page is got by all of
+ *  them at once. No train may be in two buffers; the pages flushed must
+ *  hold the last round, and a train got again after the buffers are
+ *  discarded must be zero-filled rather than read.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_NewTrains(void)
+{
+    Four        e;                      /* for errors */
+    Four        i, j;                   /* loop indexes */
+    pthread_t   writer[STRESS_NNEWWRITERS];     /* writer threads */
+    void        *status;                /* value returned by a writer */
+    Page        *apage;                 /* pointer to the buffer of a page */
+    Four        nWrong;                 /* # of buffers or pages holding something else */
+
+
+    e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+    STRESS_CHECK(e == eNOERROR, "attach");
+    stress_nZeroFilled = 0;
+
+    for (i = 0; i < STRESS_NNEWWRITERS; i++)
+        STRESS_CHECK(pthread_create(&writer[i], NULL, stress_NewTrainWriter, (void *)(long)i) == 0, "pthread_create");
+    nWrong = 0;
+    for (i = 0; i < STRESS_NNEWWRITERS; i++) {
+        STRESS_CHECK(pthread_join(writer[i], &status) == 0, "pthread_join");
+        STRESS_CHECK((long)status >= 0, "writer failed");
+        nWrong += (long)status;
+    }
+    if (nWrong > 0) printf("    %ld buffers held something else\n", (long)nWrong);
+    STRESS_CHECK(nWrong == 0, "new train neither zero-filled nor the last round");
+    STRESS_CHECK(stress_nZeroFilled > STRESS_NPAGES, "trains never got again zero-filled");
+
+    for (i = 0; i < BI_NBUFS(PAGE_BUF); i++) {
+        if (IS_NILBFMHASHKEY(BI_KEY(PAGE_BUF, i))) continue;
+        for (j = i + 1; j < BI_NBUFS(PAGE_BUF); j++)
+            STRESS_CHECK(!EQUALKEY(&BI_KEY(PAGE_BUF, i), &BI_KEY(PAGE_BUF, j)), "train in two buffers");
+    }
+
+    e = EduBfM_FlushAll();
+    STRESS_CHECK(e == eNOERROR, "flush all");
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+
+    nWrong = 0;
+    for (i = 0; i < STRESS_NPAGES - 1; i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train from the volume");
+        for (j = sizeof(Four); j < sizeof(apage->data); j++)
+            if (apage->data[j] != (char)(i + j / 64)) break;
+        if (j < sizeof(apage->data) || *(Four *)apage->data != STRESS_NNEWROUNDS) nWrong++;
+        EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+    }
+    if (nWrong > 0) printf("    %ld of %ld pages lost their last round\n", (long)nWrong, (long)STRESS_NPAGES - 1);
+    STRESS_CHECK(nWrong == 0, "last round not written");
+
+    e = EduBfM_DiscardAll();
+    STRESS_CHECK(e == eNOERROR, "discard all");
+    e = EduBfM_GetNewTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get new train");
+    for (j = 0; j < sizeof(apage->data); j++)
+        if (apage->data[j] != 0) break;
+    EduBfM_FreeTrain(&stress_pid[0], PAGE_BUF);
+    STRESS_CHECK(j == sizeof(apage->data), "new train read from the volume");
+
+    e = EduBfM_DetachSharedPool();
+    STRESS_CHECK(e == eNOERROR, "detach");
+
+    /* leave the pattern of stress_CheckPage() in the volume */
+    if (!stress_WritePages(0, 1, FALSE)) return(FALSE);
+
+    return(TRUE);
+
+}  /* stress_NewTrains() */
+
+
+
+/*@================================
+ * stress_SharedPoolFailures()
+ *================================*/
+/*
+ * Function: static Boolean stress_SharedPoolFailures(void)
+ *
+ * Description:
+ *  Check the failures of the shared buffer pool: a train cannot be fixed
+ *  when every buffer is fixed, the segment cannot be detached while this
+ *  process fixes a train, and the segment becomes suspect when a process
+ *  dies holding the pool latch.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_SharedPoolFailures(void)
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    pid_t       child;                  /* child forked */
+    int         status;                 /* exit status of the child */
+    Page        *apage;                 /* pointer to the buffer of a page */
+
+
+    e = EduBfM_AttachSharedPool(STRESS_SHMNAME);
+    STRESS_CHECK(e == eNOERROR, "attach");
+
+    /* every buffer fixed */
+    for (i = 0; i < BI_NBUFS(PAGE_BUF); i++) {
+        e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "get train");
+    }
+    e = EduBfM_GetTrain(&stress_pid[i], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOUNFIXEDBUF_BFM, "no error when every buffer is fixed");
+
+    e = EduBfM_DetachSharedPool();
+    STRESS_CHECK(e == eFLUSHFIXEDBUF_BFM, "detached with trains fixed");
+
+    for (i = 0; i < BI_NBUFS(PAGE_BUF); i++) {
+        e = EduBfM_FreeTrain(&stress_pid[i], PAGE_BUF);
+        STRESS_CHECK(e == eNOERROR, "free train");
+    }
+
+    /* a process dying with the pool latch */
+    fflush(stdout);
+    child = fork();
+    if (child == 0) {
+        edubfm_LatchPool(PAGE_BUF);
+        _exit(0);
+    }
+    STRESS_CHECK(waitpid(child, &status, 0) == child, "wait");
+
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eSHAREDPOOLSUSPECT_EDUBFM, "dead latch holder not detected");
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eSHAREDPOOLSUSPECT_EDUBFM, "suspect segment used again");
+
+    e = EduBfM_DetachSharedPool();
+    STRESS_CHECK(e == eNOERROR, "detach of a suspect segment");
+    STRESS_CHECK(access("/dev/shm" STRESS_SHMNAME, F_OK) != 0, "segment not removed");
+
+    e = EduBfM_GetTrain(&stress_pid[0], (char **)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "private pool after detach");
+    EduBfM_FreeTrain(&stress_pid[0], PAGE_BUF);
+
+    return(TRUE);
+
+}  /* stress_SharedPoolFailures() */
+
+
+
+/*@================================
+ * stress_Run()
+ *================================*/
+/*
+ * Function: static Four stress_Run(char *, Boolean (*)(void))
+ *
+ * Description:
+ *  Run a test and print its result. A failed test may leave the shared
+ *  segment attached with trains fixed, or the volume compressed or
+ *  striped; the fixes are discarded, the segment is detached and the
+ *  compression or the striping is stopped so that the next test starts
+ *  from the private buffer pool and the plain volume.
+ *
+ * Returns:
+ *  1 if the test failed, 0 otherwise
+ */
+static Four stress_Run(
+    char        *name,                  /* IN name of the test */
+    Boolean     (*test)(void))          /* IN test to run */
+{
+    Boolean     passed;                 /* TRUE if the test passed */
+    Four        i;                      /* loop index */
+
+
+    printf("%s:\n", name);
+    passed = test();
+    if (passed) printf("    ok\n");
+
+    if (IS_SHARED_BUFFERPOOL()) {
+        (void) EduBfM_DiscardAll();
+        (void) EduBfM_DetachSharedPool();
+    }
+
+    if (edubfm_IsCompressedVolume(stress_pid[0].volNo)) {
+        (void) EduBfM_SetCompression(stress_pid[0].volNo, NULL);
+        unlink(STRESS_SIDEFILE);
+    }
+
+    if (edubfm_IsStripedVolume(stress_pid[0].volNo)) {
+        (void) EduBfM_SetStriping(stress_pid[0].volNo, 0, NULL);
+        for (i = 0; i < STRESS_NDEVICES; i++) unlink(stress_devices[i]);
+    }
+
+    return(passed ? 0 : 1);
+
+}  /* stress_Run() */
+
+
+
+/*@================================
+ * EduBfM_Test()
+ *================================*/
+/*
+ * Function: Four EduBfM_Test(Four)
+ *
+ * Description:
+ *  Run the stress tests and print their results. If some test failed,
+ *  the process exits with status 1 so that 'make check' fails.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduBfM_Test(Four volId)
+{
+    Four        e;                      /* for errors */
+    Four        nFailed = 0;            /* # of tests failed */
+
+
+    /* a segment left by a killed run would be attached with its contents */
+    shm_unlink(STRESS_SHMNAME);
+
+    /* a hung test kills the process */
+    alarm(STRESS_TIMEOUT);
+
+    e = stress_AllocPages(volId);
+    if (e < eNOERROR) ERR(e);
+
+    nFailed += stress_Run("shared pool with writer and reader processes", stress_SharedPool);
+    nFailed += stress_Run("optimistic reads racing with a writer", stress_Optimistic);
+    nFailed += stress_Run("read-ahead with most buffers fixed", stress_ReadAheadFixed);
+    nFailed += stress_Run("RAM backend switched off and on", stress_RamStorage);
+    nFailed += stress_Run("delayed I/Os queued on one device", stress_DelayQueue);
+    nFailed += stress_Run("compressed volume flushed, discarded and read back", stress_Compression);
+    nFailed += stress_Run("compressed pages rewritten and found again in the side file", stress_CompressionRewrite);
+    nFailed += stress_Run("compressed volume refused without its side file", stress_CompressionMode);
+    nFailed += stress_Run("striped volume written back when the striping stops", stress_Striping);
+    nFailed += stress_Run("striped volume refused without its device files", stress_StripingMode);
+    nFailed += stress_Run("striped trains read by batches, holes from the volume", stress_StripedBatches);
+    nFailed += stress_Run("runs of dirty pages of any length and start written together", stress_Clustering);
+    nFailed += stress_Run("thread-local lookup caches with buffers replaced and pools switched", stress_LookUpCache);
+    nFailed += stress_Run("new trains got by threads racing in a shared pool", stress_NewTrains);
+    nFailed += stress_Run("shared pool failures", stress_SharedPoolFailures);
+
+    printf("%ld test(s) failed\n", (long)nFailed);
+    if (nFailed > 0) exit(1);
+
+    return(eNOERROR);
+
+}  /* EduBfM_Test() */
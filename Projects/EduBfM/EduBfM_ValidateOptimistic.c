@@ -0,0 +1,112 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_ValidateOptimistic.c
+ *
+ * Description : 
+ *  Check whether an optimistic read of a buffer is still valid.
+ *
+ * Exports:
+ *  Four EduBfM_ValidateOptimistic(TrainID *, char *, UFour, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_ValidateOptimistic()
+ *================================*/
+/*
+ * Function: Four EduBfM_ValidateOptimistic(TrainID*, char*, UFour, Four)
+ *
+ * Description : 
+ *  Check whether the buffer returned by EduBfM_GetTrainOptimistic() still
+ *  holds the train indicated by `trainId' and has not been modified since,
+ *  i.e. the version of the buffer is the same as the given version.
+ *  Everything the caller read from the buffer before this call is valid
+ *  only if TRUE is returned.
+ *  No latch is acquired.
+ *
+ * Returns:
+ *  1) TRUE if the read is valid, FALSE otherwise
+ *  2) error code
+ *     eBADBUFFER_BFM - Invalid Buffer
+ *     eBADBUFFERTYPE_BFM - Invalid Buffer type
+ */
+Four EduBfM_ValidateOptimistic(
+    TrainID             *trainId,               /* IN train which was read */
+    char                *buf,                   /* IN buffer returned by EduBfM_GetTrainOptimistic() */
+    UFour               version,                /* IN version returned by EduBfM_GetTrainOptimistic() */
+    Four                type )                  /* IN buffer type */
+{
+    Four                index;                  /* index of the buffer pool */
+    Boolean             valid;                  /* TRUE if the read is valid */
+
+
+    /*@ Check the validity of given parameters */
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    if (buf == NULL) ERR(eBADBUFFER_BFM);
+
+    index = BI_INDEXOFBUFFER(type, buf);
+    if (index < 0 || index >= BI_NBUFS(type) || BI_BUFFER(type, index) != buf)
+        ERR(eBADBUFFER_BFM);
+
+    /* the reads of the buffer by the caller must complete before the version is read again */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    valid = (EQUALKEY((BfMHashKey*)trainId, &BI_KEY(type, index)) &&
+             __atomic_load_n(&BI_VERSION(type, index), __ATOMIC_RELAXED) == version) ? TRUE : FALSE;
+
+    return( valid );
+
+}  /* EduBfM_ValidateOptimistic() */
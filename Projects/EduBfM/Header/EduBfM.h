@@ -56,9 +56,24 @@
 /* Interface Function Prototypes */
 Four EduBfM_FreeTrain(TrainID *, Four);
 Four EduBfM_GetTrain(TrainID *, char **, Four);
+Four EduBfM_GetNewTrain(TrainID *, char **, Four);
 Four EduBfM_SetDirty(TrainID *, Four);
 Four EduBfM_DiscardAll(void);
 Four EduBfM_FlushAll(void);
+Four EduBfM_AttachSharedPool(char *);
+Four EduBfM_DetachSharedPool(void);
+Four EduBfM_GetTrainOptimistic(TrainID *, char **, UFour *, Four);
+Four EduBfM_ValidateOptimistic(TrainID *, char *, UFour, Four);
+Four EduBfM_BeginWrite(TrainID *, Four);
+Four EduBfM_EndWrite(TrainID *, Four);
+Four EduBfM_GetLookUpStat(BfMLookUpStat *, Boolean);
+Four EduBfM_SetReadAhead(Four);
+Four EduBfM_GetReadAheadStat(BfMReadAheadStat *, Boolean);
+Four EduBfM_SetStorage(Four, Four, Four);
+Four EduBfM_SetIOEngine(Four);
+Four EduBfM_SetCompression(VolNo, char *);
+Four EduBfM_GetCompressionStat(BfMCompressionStat *, Boolean);
+Four EduBfM_SetStriping(VolNo, Four, char **);
 
 
 #endif /* _EDUBFM_H_ */
@@ -50,6 +50,10 @@
 #define _EDUBFM_INTERNAL_H_
 
 
+#include <pthread.h>		/* for the process-shared latches */
+#include <sys/uio.h>		/* for the batches of file I/O */
+
+
 /*@
  * Constant Definitions
  */ 
@@ -113,13 +117,16 @@ typedef struct {
 typedef struct {
     BfMHashKey 	key;		/* identify a page */
     Two    	fixed;		/* fixed count */
-    One    	bits;		/* bit 1 : DIRTY, bit 2 : VALID, bit 3 : REFER, bit 4 : NEW */
+    One    	bits;		/* bit 1 : DIRTY, bit 2 : VALID, bit 3 : REFER, bit 4 : NEW, bit 5 : PREFETCH, bit 6 : READING */
+    UOne   	generation;	/* increased whenever the entry is removed from the hash table */
     Two    	nextHashEntry;
 } BufferTable;
 
 #define DIRTY  0x01
 #define VALID  0x02
 #define REFER  0x04
+#define PREFETCH 0x10	/* read ahead and not referenced yet */
+#define READING  0x20	/* being read ahead; completed by its first reference */
 #define ALL_0  0x00
 #define ALL_1  ((sizeof(One) == 1) ? (0xff) : (0xffff))
 
@@ -155,7 +162,9 @@ typedef struct {
  *  Four type       : buffer type
  * Returns: (UTwo) an array index of the next victim
  */
-#define BI_NEXTVICTIM(type)	     (bufInfo[type].nextVictim)
+#define BI_NEXTVICTIM(type)	     (*(IS_SHARED_BUFFERPOOL() ? \
+                                   &(edubfm_sharedSegment->pool[type].nextVictim) : \
+                                   &(bufInfo[type].nextVictim)))
 
 /* Macro: BI_KEY(type, idx)
  * Description: return the hash key of the page/train residing in the buffer element
@@ -193,6 +202,61 @@ typedef struct {
  */
 #define BI_NEXTHASHENTRY(type, idx)  (((BufferTable*)bufInfo[type].bufTable)[idx].nextHashEntry)
 
+/* Macro: BI_GENERATION(type, idx)
+ * Description: return the generation of the buffer element; it is increased
+ *  whenever the page/train in the buffer element is removed from the hash table
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four idx        : array index of the buffer element
+ * Returns: (UOne) generation
+ */
+#define BI_GENERATION(type, idx)     (((BufferTable*)bufInfo[type].bufTable)[idx].generation)
+
+/* Macro: BI_VERSION(type, idx)
+ * Description: return the version of the buffer element; it is odd while the
+ *  page/train in the buffer element is being modified (see EduBfM_BeginWrite()),
+ *  or while the buffer element is being assigned to another page/train and
+ *  read in. The versions are kept out of the buffer table, which is shared
+ *  with the BfM of the COSMOS object and must keep its size.
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four idx        : array index of the buffer element
+ * Returns: (UFour) version
+ */
+#define BI_VERSION(type, idx)	     (edubfm_versionTable[type][idx])
+
+/* Macro: BI_READVERSION(type, idx)
+ * Description: read the version of the buffer element; the reads of the buffer
+ *  following it are not reordered before it
+ * Returns: (UFour) version
+ */
+#define BI_READVERSION(type, idx)    (__atomic_load_n(&BI_VERSION(type, idx), __ATOMIC_ACQUIRE))
+
+/* Macro: BI_BUMPVERSION(type, idx, n)
+ * Description: increase the version of the buffer element by n; the writes to
+ *  the buffer preceding it are not reordered after it
+ */
+#define BI_BUMPVERSION(type, idx, n) (__atomic_add_fetch(&BI_VERSION(type, idx), (n), __ATOMIC_ACQ_REL))
+
+/* Macro: BI_BEGINCHANGE(type, idx), BI_ENDCHANGE(type, idx)
+ * Description: make the version of the buffer element odd before the buffer
+ *  element is assigned to another page/train or its page/train is modified,
+ *  and even again when it is done; the writes to the buffer element preceding
+ *  BI_ENDCHANGE() are not reordered after it
+ */
+#define BI_BEGINCHANGE(type, idx)    (__atomic_store_n(&BI_VERSION(type, idx), BI_VERSION(type, idx) | 1, __ATOMIC_RELEASE), \
+                                      __atomic_thread_fence(__ATOMIC_SEQ_CST))
+#define BI_ENDCHANGE(type, idx)      (__atomic_store_n(&BI_VERSION(type, idx), (BI_VERSION(type, idx) | 1) + 1, __ATOMIC_RELEASE))
+
+/* Macro: BI_INDEXOFBUFFER(type, buf)
+ * Description: return the array index of the buffer element starting at buf
+ * Parameters:
+ *  Four type       : buffer type
+ *  char *buf       : pointer to a buffer element of the buffer pool
+ * Returns: (Four) array index
+ */
+#define BI_INDEXOFBUFFER(type, buf)  ((Four)(((char*)(buf) - BI_BUFFERPOOL(type)) / (PAGESIZE*BI_BUFSIZE(type))))
+
 /* Macro: BI_BUFFERPOOL(type)
  * Description: return the buffer pool
  * Parameter:
@@ -252,7 +316,294 @@ typedef struct {
 /* constant definition: The BfMHashKey don't exist in the hash table. */
 #define NOTFOUND_IN_HTABLE  -1
 
+/*
+ * Thread-local lookup cache
+ *
+ * edubfm_LookUp() first checks a small direct-mapped cache of the calling
+ * thread which remembers the buffer elements of the recently looked up
+ * keys. A cached entry is used only if the generation of the buffer element
+ * has not changed since, i.e. the page/train has not been removed from the
+ * hash table, and the buffer pools have not been switched by attaching or
+ * detaching the shared segment (edubfm_poolEpoch).
+ */
+#define BFM_TLCACHE_SIZE    8       /* must be a power of 2 */
+
+typedef struct {
+    BfMHashKey          key;            /* cached key */
+    Two                 index;          /* buffer element holding the key */
+    UOne                generation;     /* generation of the buffer element when cached */
+    Four                epoch;          /* edubfm_poolEpoch when cached; 0 if empty */
+} BfMTLCacheEntry;
+
+/* Macro: BFM_TLCACHE_SLOT(k)
+ * Description: return the slot of the thread-local cache for the key
+ * Parameter:
+ *  BfMHashKey *k   : pointer to the key
+ * Returns: (Four) slot
+ */
+#define BFM_TLCACHE_SLOT(k)          (((k)->pageNo ^ (k)->volNo) & (BFM_TLCACHE_SIZE - 1))
+
+/*
+ * Storage backends
+ *
+ * All the trains are read and written through the current backend,
+ * edubfm_storage, instead of calling RDsM directly. A backend is a set of
+ * functions and its private data; a wrapping backend (e.g. the one
+ * injecting delays) keeps the backend it wraps in 'inner'.
+ * The functions return eNOERROR or an error code, like RDsM_ReadTrain()
+ * and RDsM_WriteTrain(), and may be called by several threads at a time.
+ */
+typedef struct BfMStorage_T_tag BfMStorage_T;
+struct BfMStorage_T_tag {
+    char                *name;          /* name of the backend */
+    Four                (*read)(BfMStorage_T *, TrainID *, char *, Two);   /* read nPages into a buffer */
+    Four                (*write)(BfMStorage_T *, TrainID *, char *, Two);  /* write nPages from a buffer */
+    BfMStorage_T        *inner;         /* wrapped backend; NULL if none */
+    void                *data;          /* private data of the backend */
+};
+
+/* Macro: BFM_STORAGE_READ(trainId, buf, nPages), BFM_STORAGE_WRITE(trainId, buf, nPages)
+ * Description: read/write nPages pages starting at trainId through the current backend
+ * Returns: error code
+ */
+#define BFM_STORAGE_READ(trainId, buf, nPages)  (edubfm_storage->read(edubfm_storage, (trainId), (buf), (nPages)))
+#define BFM_STORAGE_WRITE(trainId, buf, nPages) (edubfm_storage->write(edubfm_storage, (trainId), (buf), (nPages)))
+
+/* # of buckets of the hash table of the RAM backend */
+#define BFM_RAMSTORAGE_NBUCKETS 4093
+
+/* # of devices emulated by the delay backend: the volumes and the device files of a striped volume */
+#define BFM_DELAY_NDEVICES      (1 + BFM_STRIPE_MAXDEVICES)
+
+/*
+ * Page compression
+ *
+ * The file backend keeps the pages of a compressed volume in a side file
+ * instead of the volume (see EduBfM_SetCompression()). Each page is
+ * compressed on its own, whatever the length of the train written, and
+ * stored in an extent of BFM_COMPRESS_UNIT-byte units: a header followed
+ * by the compressed page. The extents are packed one after the other, so
+ * several compressed pages share a disk block, and the pages of a train
+ * written together lie next to each other and are read back by one I/O.
+ * A page rewritten is kept in its extent if it still fits, or else moved
+ * to a new one and its old extent is marked free, by a header of NIL page,
+ * to be reused. The side file has no other index: the index of the pages
+ * is kept in memory and rebuilt from the headers when the side file is
+ * opened. A page never written to the side file is read from the volume.
+ */
+#define BFM_COMPRESS_MAXVOLUMES 8               /* # of volumes compressed at once */
+#define BFM_COMPRESS_UNIT       256             /* allocation unit of the side file (unit: bytes) */
+#define BFM_COMPRESS_MAGIC      0x4266435bL     /* marks a header */
+
+#define BFM_COMPRESS_RAW        0       /* stored as is; did not compress */
+#define BFM_COMPRESS_LZ         1       /* compressed by edubfm_LzCompress() */
+
+typedef struct {
+    UFour               magic;          /* BFM_COMPRESS_MAGIC */
+    PageNo              pageNo;         /* page stored; NIL if the extent is free */
+    Two                 nUnits;         /* size of the extent (unit: BFM_COMPRESS_UNIT bytes) */
+    Two                 method;         /* BFM_COMPRESS_RAW or BFM_COMPRESS_LZ */
+    Four                length;         /* # of bytes of the page following the header */
+    UFour               seq;            /* sequence number; the extent written last wins */
+} BfMCompressHeader;
+
+/* maximum # of units of an extent, holding a page stored uncompressed */
+#define BFM_COMPRESS_MAXUNITS   ((sizeof(BfMCompressHeader) + PAGESIZE + BFM_COMPRESS_UNIT - 1) / BFM_COMPRESS_UNIT)
+
+/*
+ * Striping
+ *
+ * The file backend keeps the trains of a striped volume in several device
+ * files instead of the volume (see EduBfM_SetStriping()). The pages are
+ * striped RAID-0 style in units of BFM_STRIPE_NPAGES pages, the largest
+ * train, so a train lies on one device and the trains of a batch go to
+ * different devices, which the worker threads of the I/O engine access
+ * concurrently. A page never written to its device file is a hole there,
+ * and the train is read from the volume.
+ */
+#define BFM_STRIPE_MAXVOLUMES   8       /* # of volumes striped at once */
+#define BFM_STRIPE_MAXDEVICES   20      /* # of devices of a striped volume */
+#define BFM_STRIPE_NPAGES       BFM_CLUSTER_NPAGES     /* striping unit (unit: # of pages) */
+#define BFM_STRIPE_MAXPIECES    (BFM_CLUSTER_MAXPAGES / BFM_STRIPE_NPAGES + 1)  /* # of units a train lies on */
+
+/*
+ * Volume modes
+ *
+ * The pages of a compressed or striped volume written to the side file or
+ * the device files are stale in the volume itself. So EduBfM_SetCompression()
+ * and EduBfM_SetStriping() record the mode in the meta dictionary of the
+ * volume, and the trains of a volume recorded so cannot be fixed until
+ * the process gives the side file or the device files too (see
+ * edubfm_CheckVolumeMode()). The modes read from the volumes are cached
+ * per process.
+ */
+#define BFM_MODE_MAXVOLUMES     20      /* # of volumes whose modes are cached */
+#define BFM_MODE_COMPRESSION    "EduBfM.compression"    /* TRUE if the volume is compressed */
+#define BFM_MODE_STRIPING       "EduBfM.striping"       /* # of devices the volume is striped over */
+
+/*
+ * I/O engine
+ *
+ * Reads and writes of several trains are submitted to the I/O engine in a
+ * batch and run by its worker threads through the current backend; the
+ * submitter then waits for (or polls) each request. With no worker thread,
+ * which is the default, a request is done on submission.
+ * Every function of the buffer manager waits for all the requests it
+ * submitted before it returns, so the engine never runs while the caller
+ * uses RDsM directly. RDsM itself is not reentrant; the file backend
+ * serializes the calls to it. The only exception is the read-ahead, which
+ * may leave its reads in flight (see edubfm_ReadAhead()); their requests
+ * have deferVolume set, and the workers do not call RDsM for them but
+ * return eVOLUMEIODEFERRED_EDUBFM, so that the read is redone when the
+ * request is waited for.
+ */
+#define BFM_IO_READ         0
+#define BFM_IO_WRITE        1
+
+#define BFM_IO_MAXBATCH     64      /* maximum # of requests submitted at a time */
+#define BFM_IO_MAXTHREADS   64      /* maximum # of worker threads */
+
+typedef struct BfMIORequest_T_tag BfMIORequest_T;
+struct BfMIORequest_T_tag {
+    Four                op;             /* BFM_IO_READ or BFM_IO_WRITE */
+    TrainID             trainId;        /* first page */
+    char                *buf;           /* buffer to read into or write from */
+    Two                 nPages;         /* # of pages */
+    Four                status;         /* error code; valid when done */
+    Four                done;           /* TRUE when the request is done */
+    Boolean             deferVolume;    /* TRUE if the workers must not read the volume by RDsM */
+    BfMIORequest_T      *next;          /* next request in the queue */
+};
+
+/*
+ * File I/O
+ *
+ * The side files and the device files are read and written by batches of
+ * I/Os like preadv() and pwritev() (see edubfm_FileIO()); a batch goes to
+ * an io_uring at once, so that its I/Os overlap in the kernel.
+ */
+#define BFM_FILEIO_MAXBATCH     128     /* # of I/Os submitted to an io_uring at a time */
+
+typedef struct {
+    Four                op;             /* BFM_IO_READ or BFM_IO_WRITE */
+    int                 fd;             /* file */
+    struct iovec        *iov;           /* buffers */
+    Four                iovcnt;         /* # of buffers */
+    off_t               offset;         /* offset in the file */
+    ssize_t             result;         /* # of bytes transferred, or -errno; valid when done */
+} BfMFileIO_T;
+
+/*
+ * Write clustering
+ *
+ * When a dirty victim is replaced, its dirty and unfixed neighbors with
+ * adjacent page numbers are written with it, by trains of BFM_CLUSTER_NPAGES
+ * pages and single pages (see edubfm_FlushCluster()).
+ */
+#define BFM_CLUSTER_NPAGES      4       /* # of pages written by one RDsM_WriteTrain() */
+#define BFM_CLUSTER_MAXPAGES    16      /* maximum # of pages written together */
+
+/*
+ * Sequential read-ahead
+ *
+ * The misses, and the first references of the read-ahead trains, are fed
+ * to a detector which keeps the last train number per volume and buffer
+ * type. Once BFM_RA_MINRUN consecutive trains are accessed, the following
+ * trains are read ahead into the buffer pool with the PREFETCH bit set;
+ * the window starts at BFM_RA_INITWINDOW trains and doubles each time the
+ * pattern holds, up to the maximum set by EduBfM_SetReadAhead() and half
+ * of the buffer pool. An access breaking the pattern collapses the window.
+ * With the worker threads of the I/O engine, the reads of a window may be
+ * left in flight, up to BFM_RA_MAXBATCHES windows; a buffer still being
+ * read has the READING bit set and is completed by its first reference.
+ */
+#define BFM_RA_NDETECTORS   8       /* # of volumes/buffer types tracked at once */
+#define BFM_RA_MINRUN       2       /* # of consecutive trains starting read-ahead */
+#define BFM_RA_INITWINDOW   2       /* initial window (unit: # of trains) */
+#define BFM_RA_MAXWINDOW    BFM_IO_MAXBATCH /* the window is read by a batch */
+#define BFM_RA_MAXBATCHES   4       /* # of windows read ahead in flight at once */
+
+typedef struct {
+    VolNo               volNo;          /* volume tracked; NIL if unused */
+    Two                 type;           /* buffer type tracked */
+    PageNo              lastPageNo;     /* last train number accessed */
+    PageNo              raEndPageNo;    /* last train number read ahead */
+    Four                runLength;      /* # of consecutive trains accessed */
+    Four                window;         /* current window; 0 if not reading ahead */
+} BfMReadAheadDetector;
+
+
+/*
+ * Shared buffer pool
+ *
+ * When EduBfM_AttachSharedPool() is called, the buffer table, the hash table
+ * and the buffer pool of every buffer type are placed in a named POSIX
+ * shared memory segment so that all processes on a host share one cache.
+ * The segment starts with a BfMSharedSegment header; the arrays of each
+ * buffer type follow at the offsets recorded in BfMSharedPoolHdr.
+ * The tables hold array indexes only, so the segment can be mapped at a
+ * different address in each process.
+ */
+#define BFM_SHAREDSEGMENT_MAGIC     0x45424653      /* "EBFS" */
+#define BFM_SHAREDSEGMENT_NAMELEN   64
+
+/* upper bound of BI_NBUFS(); sizes the version tables of the private buffer pools */
+#define BFM_MAXNBUFS                0x8000
+
+/* per buffer type part of the shared segment header */
+typedef struct {
+    pthread_mutex_t     poolLatch;      /* protects buffer table, hash table and nextVictim */
+    UTwo                nextVictim;     /* shared starting point for searching a next victim */
+    Two                 nBufs;          /* # of buffers; must match in all processes */
+    Two                 bufSize;        /* size of a buffer in page size */
+    size_t              bufTableOffset; /* offsets from the start of the segment */
+    size_t              hashTableOffset;
+    size_t              frameLatchOffset;
+    size_t              versionTableOffset;
+    size_t              bufferPoolOffset;
+} BfMSharedPoolHdr;
+
+/* header of the shared segment */
+typedef struct {
+    Four                magic;          /* BFM_SHAREDSEGMENT_MAGIC after initialization */
+    Four                nAttached;      /* # of processes attached to the segment */
+    Four                suspect;        /* TRUE once a process died holding a pool or frame latch */
+    pthread_mutex_t     attachLatch;    /* protects nAttached */
+    size_t              size;           /* total size of the segment */
+    BfMSharedPoolHdr    pool[NUM_BUF_TYPES];
+} BfMSharedSegment;
+
+/* Macro: IS_SHARED_BUFFERPOOL()
+ * Description: check whether the buffer pools are placed in the shared segment
+ * Returns: TRUE(1) if the shared segment is attached, otherwise FALSE(0)
+ */
+#define IS_SHARED_BUFFERPOOL()       (edubfm_sharedSegment != NULL)
+
+/* Macro: BI_FRAMELATCH(type, idx)
+ * Description: return the process-shared latch protecting the I/O on a buffer element
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four idx        : array index of the buffer element
+ * Returns: (pthread_mutex_t *) pointer to the latch
+ */
+#define BI_FRAMELATCH(type, idx) \
+    ((pthread_mutex_t*)((char*)edubfm_sharedSegment + edubfm_sharedSegment->pool[type].frameLatchOffset) + (idx))
+
 extern BufferInfo bufInfo[];
+extern BfMSharedSegment *edubfm_sharedSegment;
+extern BufferInfo edubfm_privateBufInfo[];
+extern UFour *edubfm_versionTable[];
+extern UFour edubfm_privateVersionTable[][BFM_MAXNBUFS];
+extern char edubfm_sharedSegmentName[];
+extern Four edubfm_poolEpoch;
+extern Four edubfm_nFixed;
+extern __thread BfMLookUpStat edubfm_lookUpStat;
+extern BfMStorage_T *edubfm_storage;
+extern Four edubfm_raMaxWindow;
+extern Four edubfm_uringEnabled;
+extern __thread Boolean edubfm_deferVolumeIO;
+extern BfMReadAheadStat edubfm_raStat;
+extern BfMCompressionStat edubfm_compressStat;
 
 /*@
  * Function Prototypes
@@ -262,9 +613,44 @@ Four edubfm_AllocTrain(Four);
 Four edubfm_Delete(BfMHashKey *, Four);
 Four edubfm_DeleteAll(void);
 Four edubfm_FlushTrain(TrainID *, Four);
+Four edubfm_FlushTrains(Four, Four *, Four);
+Four edubfm_FlushCluster(TrainID *, Four);
 Four edubfm_Insert(BfMHashKey *, Two, Four); 
 Four edubfm_LookUp(BfMHashKey *, Four);
+Four edubfm_LookUpOptimistic(BfMHashKey *, Four);
 Four edubfm_ReadTrain(TrainID *, char *, Four);
+Four edubfm_LatchPool(Four);
+Four edubfm_UnlatchPool(Four);
+Four edubfm_LatchFrame(Four, Four);
+Four edubfm_UnlatchFrame(Four, Four);
+Four edubfm_ReadAhead(TrainID *, Four);
+Four edubfm_CompleteReadAhead(Four, Four);
+void edubfm_DrainReadAhead(void);
+Four edubfm_SetStorage(Four, Four, Four);
+Four edubfm_VolumeRead(TrainID *, char *, Two);
+Four edubfm_VolumeWrite(TrainID *, char *, Two);
+Four edubfm_RecordVolumeMode(VolNo, char *, Four);
+Four edubfm_CheckVolumeMode(VolNo);
+Four edubfm_FileIO(BfMFileIO_T *, Four);
+Boolean edubfm_IsRamStorage(void);
+Boolean edubfm_IsFileStorage(void);
+Four edubfm_SubmitIO(BfMIORequest_T *, Four);
+Four edubfm_WaitIO(BfMIORequest_T *);
+Boolean edubfm_PollIO(BfMIORequest_T *);
+Four edubfm_StartIOEngine(Four);
+Four edubfm_StopIOEngine(void);
+Boolean edubfm_IsIOEngineRunning(void);
+Four edubfm_SetCompression(VolNo, char *);
+Four edubfm_CompressedRead(TrainID *, char *, Two);
+Four edubfm_CompressedWrite(TrainID *, char *, Two);
+Boolean edubfm_IsCompressedVolume(VolNo);
+Four edubfm_SetStriping(VolNo, Four, char **);
+Four edubfm_StripedRead(TrainID *, char *, Two);
+Four edubfm_StripedWrite(TrainID *, char *, Two);
+void edubfm_StripedBatch(BfMIORequest_T *, Four);
+Boolean edubfm_IsStripedVolume(VolNo);
+Four edubfm_GetStripedDevices(VolNo);
+Four edubfm_GetStripeDevice(TrainID *);
 
 
 #endif /* _EDUBFM_INTERNAL_H_ */
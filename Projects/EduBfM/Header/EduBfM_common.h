@@ -117,6 +117,43 @@ typedef PageID TrainID;		/* use its first page's PageID as the TrainID */
 
 #define PRINT_TRAINID(x,y) PRINT_PAGEID(x,y)
 
+/*
+** Storage Backends (see EduBfM_SetStorage())
+*/
+#define BFM_STORAGE_FILE	0	/* volume devices through RDsM */
+#define BFM_STORAGE_RAM		1	/* memory of the process; not durable */
+
+/* delays emulating typical devices: latency per I/O (usec) and bandwidth (KB/sec) */
+#define BFM_SSD_LATENCY		100
+#define BFM_SSD_BANDWIDTH	500000
+#define BFM_HDD_LATENCY		8000
+#define BFM_HDD_BANDWIDTH	150000
+
+/*
+** Type Definitions for Statistics
+*/
+/* lookups of the buffer table done by the calling thread */
+typedef struct {
+    Four nLookUps;		/* # of lookups */
+    Four nCacheHits;		/* # of lookups served by the thread-local cache */
+} BfMLookUpStat;
+
+/* sequential read-ahead */
+typedef struct {
+    Four nPrefetched;		/* # of trains read ahead */
+    Four nUsed;			/* # of trains read ahead and referenced afterwards */
+    Four nWasted;		/* # of trains read ahead and replaced without being referenced */
+    Four nAsync;		/* # of trains read ahead whose reads were left in flight */
+} BfMReadAheadStat;
+
+/* page compression; the compression ratio is nBytesIn / nBytesOut */
+typedef struct {
+    Four nTrainsWritten;	/* # of trains written to compressed volumes */
+    Four nTrainsRaw;		/* # of trains among them stored uncompressed */
+    double nBytesIn;		/* # of bytes of the trains written */
+    double nBytesOut;		/* # of bytes of the extents stored for them, headers and padding included */
+} BfMCompressionStat;
+
 /*
  * Error Handling
  */
@@ -121,3 +121,16 @@
 #define eNOMORELOCKCONTROLBLOCKS_BFM             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,59)
 #define NUM_ERRORS_BFM_ERR_BASE                  60
 #define eNOTSUPPORTED_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,61)
+#define eBADSHAREDPOOLNAME_EDUBFM                ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,62)
+#define eSHAREDPOOLATTACHED_EDUBFM               ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,63)
+#define eSHAREDPOOLNOTATTACHED_EDUBFM            ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,64)
+#define eSHAREDPOOLMISMATCH_EDUBFM               ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,65)
+#define eBADPARAMETER_EDUBFM                     ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,66)
+#define eMEMALLOCFAILED_EDUBFM                   ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,67)
+#define eTHREADCREATEFAILED_EDUBFM               ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,68)
+#define eFILEIOFAILED_EDUBFM                     ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,69)
+#define eBADCOMPRESSEDTRAIN_EDUBFM               ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,70)
+#define eSHAREDPOOLSUSPECT_EDUBFM                ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,71)
+#define eVOLUMEMODEMISMATCH_EDUBFM               ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,72)
+#define eRAMSTORAGEUSED_EDUBFM                   ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,73)
+#define eVOLUMEIODEFERRED_EDUBFM                 ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,74)
@@ -52,6 +52,13 @@
 
 Four	RDsM_ReadTrain(PageID *, char *, Two);
 Four	RDsM_WriteTrain(char *, PageID *, Two);
+Four	RDsM_InsertMetaEntry(Four, char *, char *, Four);
+Four	RDsM_GetMetaEntry(Four, char *, char *, Four);
+Four	BfM_FlushAll(void);		/* the buffer manager of COSMOS, used by RDsM */
+
+/* returned by RDsM_GetMetaEntry() if the meta dictionary has no such entry */
+#define RDSM_ERR_BASE                   3
+#define eMETADICTENTRYNOTFOUND_RDSM     ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,19)
 
 
 #endif /* _RDsM_H_ */
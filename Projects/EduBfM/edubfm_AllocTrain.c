@@ -85,6 +85,9 @@ extern CfgParams_T sm_cfgParams;
  *  returned.
  *  Before return the buffer, if the dirty bit of the victim is set, it 
  *  must be force out to the disk.
+ *  The search gives up after two rounds over the buffer pool, which clear
+ *  all the reference bits, so that the caller holding the pool latch does
+ *  not spin while every buffer is fixed.
  *
  * Returns;
  *  1) An index of a new buffer from the buffer pool
@@ -99,6 +102,7 @@ Four edubfm_AllocTrain(
     Four 	e;			/* for error */
     Four 	victim;			/* return value */
     Four 	i;
+    Four 	n;			/* # of buffer elements visited */
     PageID *pid;
     
 
@@ -107,7 +111,7 @@ Four edubfm_AllocTrain(
 
     victim = -1;
     i = BI_NEXTVICTIM(type);
-    while ( victim == -1 ) {
+    for ( n = 0; victim == -1 && n < 2 * BI_NBUFS(type); n++ ) {
         if ( BI_FIXED(type, i) );
         else if ( BI_BITS(type, i) & REFER )
             BI_BITS(type, i) &= ~REFER;
@@ -117,14 +121,19 @@ Four edubfm_AllocTrain(
     }
     BI_NEXTVICTIM(type) = i;
 
+    if ( victim == -1 ) ERR( eNOUNFIXEDBUF_BFM );
+
     pid = &BI_KEY(type, victim);
     if ( !IS_NILBFMHASHKEY( *((BfMHashKey*)pid) ) ) {
-        e = edubfm_FlushTrain(pid, type);
+        e = edubfm_FlushCluster(pid, type);
         if ( e < 0 ) ERR( e );
         e = edubfm_Delete(pid, type);
         if ( e < 0 ) ERR( e );
     }
 
+    if ( BI_BITS(type, victim) & PREFETCH ) edubfm_raStat.nWasted++;
+    BI_BITS(type, victim) = ALL_0;
+
     
     return( victim );
     
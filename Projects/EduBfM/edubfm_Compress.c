@@ -0,0 +1,1148 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Compress.c
+ *
+ * Description:
+ *  Page compression of the file backend.
+ *  The pages of a compressed volume are kept in a side file; each page is
+ *  compressed on write by a small LZ77 coder into an extent of a few
+ *  units, packed with the extents of the other pages, and decompressed on
+ *  read into the buffer (see the page compression section of
+ *  EduBfM_Internal.h). The index of the extents is kept in memory and
+ *  rebuilt from their headers when the side file is opened. The extents
+ *  of a train are read and written by edubfm_FileIO() out of the latch
+ *  of the volume, so that the trains of a batch overlap.
+ *
+ * Exports:
+ *  BfMCompressionStat edubfm_compressStat
+ *  Four edubfm_SetCompression(VolNo, char *)
+ *  Four edubfm_CompressedRead(TrainID *, char *, Two)
+ *  Four edubfm_CompressedWrite(TrainID *, char *, Two)
+ *  Boolean edubfm_IsCompressedVolume(VolNo)
+ */
+
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * type definitions
+ */
+/* an extent of the side file */
+typedef struct {
+    Four                unit;           /* first unit; NIL if none */
+    Two                 nUnits;         /* # of units */
+} edubfm_CompressExtent_T;
+
+/* a compressed volume */
+typedef struct {
+    VolNo               volNo;          /* volume compressed; NIL if unused */
+    int                 fd;             /* side file */
+    pthread_mutex_t     latch;          /* protects the extents; not held during the I/Os of the trains */
+    edubfm_CompressExtent_T *index;     /* extent of each page kept, by page number */
+    Four                nIndex;         /* # of entries of index */
+    edubfm_CompressExtent_T *freeExtent; /* extents of no page */
+    Four                nFree;          /* # of free extents */
+    Four                maxFree;        /* # of entries of freeExtent */
+    Four                nUnits;         /* size of the side file (unit: BFM_COMPRESS_UNIT bytes) */
+    UFour               seq;            /* sequence number of the last extent written */
+} edubfm_CompressedVolume_T;
+
+/* an extent being read or written */
+typedef union {
+    BfMCompressHeader   header;
+    char                bytes[BFM_COMPRESS_MAXUNITS * BFM_COMPRESS_UNIT];
+} edubfm_CompressSlot_T;
+
+
+/*@
+ * macro definitions
+ */
+#define BFM_LZ_HASHSIZE     4096        /* # of entries of the match finder */
+#define BFM_LZ_MAXOFFSET    8191        /* largest distance of a match - 1 */
+#define BFM_LZ_MAXLITERALS  32          /* longest literal run */
+#define BFM_LZ_MAXMATCH     264         /* longest match */
+
+/* Macro: BFM_LZ_HASH(p)
+ * Description: hash the three bytes at p
+ */
+#define BFM_LZ_HASH(p)  (((((UFour)(p)[0] << 16) | ((UFour)(p)[1] << 8) | (p)[2]) * 2654435761U) >> 20)
+
+/* Macro: BFM_COMPRESS_OFFSET(unit)
+ * Description: return the offset of the unit in the side file
+ */
+#define BFM_COMPRESS_OFFSET(unit)       ((off_t)(unit) * BFM_COMPRESS_UNIT)
+
+/* Macro: BFM_COMPRESS_NUNITS(length)
+ * Description: return the # of units of the extent of a page compressed into length bytes
+ */
+#define BFM_COMPRESS_NUNITS(length)     ((Two)((sizeof(BfMCompressHeader) + (length) + BFM_COMPRESS_UNIT - 1) / BFM_COMPRESS_UNIT))
+
+/* Macro: BFM_COMPRESS_ISKEPT(vol, pageNo)
+ * Description: tell whether the page is kept in the side file
+ */
+#define BFM_COMPRESS_ISKEPT(vol, pageNo) ((pageNo) < (vol)->nIndex && (vol)->index[pageNo].unit != NIL)
+
+
+/*@
+ * global variables
+ */
+/* statistics of the page compression */
+BfMCompressionStat edubfm_compressStat;
+
+static pthread_mutex_t edubfm_compressStatLatch = PTHREAD_MUTEX_INITIALIZER;
+
+static edubfm_CompressedVolume_T edubfm_compressedVolume[BFM_COMPRESS_MAXVOLUMES] = {
+    { NIL, -1 }, { NIL, -1 }, { NIL, -1 }, { NIL, -1 },
+    { NIL, -1 }, { NIL, -1 }, { NIL, -1 }, { NIL, -1 }
+};
+
+
+
+/*@================================
+ * edubfm_LzCompress()
+ *================================*/
+/*
+ * Function: static Four edubfm_LzCompress(UOne*, Four, UOne*, Four)
+ *
+ * Description:
+ *  Compress 'inLen' bytes. The output is a sequence of literal runs and
+ *  matches; a control byte c < 32 is followed by c+1 literal bytes, and
+ *  any other is a match of ((c >> 5) + 2) bytes, the length being extended
+ *  by a byte if c >> 5 is 7, at the distance given by the low 5 bits of c
+ *  and the next byte, plus one.
+ *
+ * Returns:
+ *  # of bytes of the output; 0 if it does not fit in 'outMax' bytes
+ */
+static Four edubfm_LzCompress(
+    UOne                *in,            /* IN bytes to compress */
+    Four                inLen,          /* IN # of bytes to compress */
+    UOne                *out,           /* OUT compressed bytes */
+    Four                outMax)         /* IN size of out */
+{
+    Four                hashTable[BFM_LZ_HASHSIZE];    /* last position of each hash */
+    Four                ip;             /* current input position */
+    Four                op;             /* current output position */
+    Four                literal;        /* start of the pending literals */
+    Four                ref;            /* candidate match */
+    Four                len;            /* match length */
+    Four                maxLen;         /* longest match possible here */
+    Four                offset;         /* match distance - 1 */
+    Four                n;              /* # of literals in a run */
+    Four                i;              /* index */
+
+
+    for (i = 0; i < BFM_LZ_HASHSIZE; i++) hashTable[i] = NIL;
+
+    ip = op = literal = 0;
+    while (ip <= inLen) {
+
+        /*@ find a match at ip */
+        len = 0;
+        if (ip + 2 < inLen) {
+            ref = hashTable[BFM_LZ_HASH(&in[ip])];
+            hashTable[BFM_LZ_HASH(&in[ip])] = ip;
+
+            if (ref != NIL && ip - ref - 1 <= BFM_LZ_MAXOFFSET &&
+                in[ref] == in[ip] && in[ref+1] == in[ip+1] && in[ref+2] == in[ip+2]) {
+                maxLen = inLen - ip;
+                if (maxLen > BFM_LZ_MAXMATCH) maxLen = BFM_LZ_MAXMATCH;
+                for (len = 3; len < maxLen && in[ref+len] == in[ip+len]; len++);
+            }
+        }
+
+        if (len == 0 && ip < inLen) {
+            ip++;
+            continue;
+        }
+
+        /*@ flush the pending literals */
+        while (literal < ip) {
+            n = ip - literal;
+            if (n > BFM_LZ_MAXLITERALS) n = BFM_LZ_MAXLITERALS;
+            if (op + 1 + n > outMax) return(0);
+
+            out[op++] = n - 1;
+            memcpy(&out[op], &in[literal], n);
+            op += n;
+            literal += n;
+        }
+
+        if (len == 0) break;    /* end of the input */
+
+        /*@ emit the match */
+        if (op + 3 > outMax) return(0);
+        offset = ip - ref - 1;
+        if (len - 2 < 7) {
+            out[op++] = ((len - 2) << 5) | (offset >> 8);
+        }
+        else {
+            out[op++] = (7 << 5) | (offset >> 8);
+            out[op++] = len - 2 - 7;
+        }
+        out[op++] = offset & 0xff;
+
+        for (i = ip + 1; i < ip + len && i + 2 < inLen; i++)
+            hashTable[BFM_LZ_HASH(&in[i])] = i;
+
+        ip += len;
+        literal = ip;
+    }
+
+    return(op);
+
+}  /* edubfm_LzCompress() */
+
+
+
+/*@================================
+ * edubfm_LzDecompress()
+ *================================*/
+/*
+ * Function: static Four edubfm_LzDecompress(UOne*, Four, UOne*, Four)
+ *
+ * Description:
+ *  Decompress the output of edubfm_LzCompress().
+ *
+ * Returns:
+ *  # of bytes decompressed; NIL if the input is corrupted
+ */
+static Four edubfm_LzDecompress(
+    UOne                *in,            /* IN compressed bytes */
+    Four                inLen,          /* IN # of compressed bytes */
+    UOne                *out,           /* OUT decompressed bytes */
+    Four                outMax)         /* IN size of out */
+{
+    Four                ip;             /* current input position */
+    Four                op;             /* current output position */
+    Four                c;              /* control byte */
+    Four                len;            /* length of a run or match */
+    Four                ref;            /* start of a match */
+
+
+    ip = op = 0;
+    while (ip < inLen) {
+        c = in[ip++];
+
+        if (c < BFM_LZ_MAXLITERALS) {
+            len = c + 1;
+            if (ip + len > inLen || op + len > outMax) return(NIL);
+
+            memcpy(&out[op], &in[ip], len);
+            ip += len;
+            op += len;
+        }
+        else {
+            len = c >> 5;
+            if (len == 7) {
+                if (ip >= inLen) return(NIL);
+                len += in[ip++];
+            }
+            len += 2;
+
+            if (ip >= inLen) return(NIL);
+            ref = op - (((c & 0x1f) << 8) | in[ip++]) - 1;
+            if (ref < 0 || op + len > outMax) return(NIL);
+
+            if (op - ref >= len) {
+                memcpy(&out[op], &out[ref], len);
+                op += len;
+            }
+            else {
+                /* byte by byte; the match overlaps the output */
+                for ( ; len > 0; len--) out[op++] = out[ref++];
+            }
+        }
+    }
+
+    return(op);
+
+}  /* edubfm_LzDecompress() */
+
+
+
+/*@================================
+ * edubfm_FindCompressedVolume()
+ *================================*/
+/*
+ * Function: static edubfm_CompressedVolume_T *edubfm_FindCompressedVolume(VolNo)
+ *
+ * Description:
+ *  Find the entry of a compressed volume.
+ *
+ * Returns:
+ *  pointer to the entry; NULL if the volume is not compressed
+ */
+static edubfm_CompressedVolume_T *edubfm_FindCompressedVolume(
+    VolNo               volNo)          /* IN volume to find */
+{
+    Four                i;              /* index */
+
+
+    for (i = 0; i < BFM_COMPRESS_MAXVOLUMES; i++)
+        if (edubfm_compressedVolume[i].volNo == volNo) return(&edubfm_compressedVolume[i]);
+
+    return(NULL);
+
+}  /* edubfm_FindCompressedVolume() */
+
+
+
+/*@================================
+ * edubfm_IsCompressedVolume()
+ *================================*/
+/*
+ * Function: Boolean edubfm_IsCompressedVolume(VolNo)
+ *
+ * Description:
+ *  Tell whether the volume is compressed.
+ *
+ * Returns:
+ *  TRUE if the volume is compressed; FALSE otherwise
+ */
+Boolean edubfm_IsCompressedVolume(
+    VolNo               volNo)          /* IN volume */
+{
+    return((edubfm_FindCompressedVolume(volNo) != NULL) ? TRUE : FALSE);
+
+}  /* edubfm_IsCompressedVolume() */
+
+
+
+/*@================================
+ * edubfm_GrowIndex()
+ *================================*/
+/*
+ * Function: static Four edubfm_GrowIndex(edubfm_CompressedVolume_T*, PageNo)
+ *
+ * Description:
+ *  Make the index of a compressed volume cover the page. The caller holds
+ *  the latch of the volume.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCFAILED_EDUBFM - no memory for the index
+ */
+static Four edubfm_GrowIndex(
+    edubfm_CompressedVolume_T *vol,     /* IN entry of the volume */
+    PageNo              pageNo)         /* IN page to cover */
+{
+    edubfm_CompressExtent_T *index;     /* index grown */
+    Four                nIndex;         /* # of entries of the index grown */
+    Four                i;              /* index */
+
+
+    if (pageNo < vol->nIndex) return(eNOERROR);
+
+    for (nIndex = (vol->nIndex > 0) ? vol->nIndex : 1024; nIndex <= pageNo; nIndex *= 2);
+
+    index = (edubfm_CompressExtent_T*)realloc(vol->index, nIndex * sizeof(edubfm_CompressExtent_T));
+    if (index == NULL) ERR(eMEMALLOCFAILED_EDUBFM);
+
+    for (i = vol->nIndex; i < nIndex; i++) {
+        index[i].unit = NIL;
+        index[i].nUnits = 0;
+    }
+    vol->index = index;
+    vol->nIndex = nIndex;
+
+    return(eNOERROR);
+
+}  /* edubfm_GrowIndex() */
+
+
+
+/*@================================
+ * edubfm_FreeExtent()
+ *================================*/
+/*
+ * Function: static Four edubfm_FreeExtent(edubfm_CompressedVolume_T*, Four, Two, Boolean)
+ *
+ * Description:
+ *  Add an extent to the free extents of a compressed volume, and mark it
+ *  free in the side file if 'mark' is TRUE, so that it is not taken for a
+ *  page when the side file is opened again. The caller holds the latch of
+ *  the volume.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCFAILED_EDUBFM - no memory for the free extents
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be written
+ */
+static Four edubfm_FreeExtent(
+    edubfm_CompressedVolume_T *vol,     /* IN entry of the volume */
+    Four                unit,           /* IN first unit of the extent */
+    Two                 nUnits,         /* IN # of units of the extent */
+    Boolean             mark)           /* IN TRUE to mark the extent free in the side file */
+{
+    BfMCompressHeader   header;         /* header of a free extent */
+    edubfm_CompressExtent_T *freeExtent; /* free extents grown */
+    Four                maxFree;        /* # of entries of the free extents grown */
+
+
+    if (mark) {
+        header.magic = BFM_COMPRESS_MAGIC;
+        header.pageNo = NIL;
+        header.nUnits = nUnits;
+        header.method = BFM_COMPRESS_RAW;
+        header.length = 0;
+        header.seq = ++vol->seq;
+
+        if (pwrite(vol->fd, &header, sizeof(header), BFM_COMPRESS_OFFSET(unit)) != sizeof(header))
+            ERR(eFILEIOFAILED_EDUBFM);
+    }
+
+    if (vol->nFree == vol->maxFree) {
+        maxFree = (vol->maxFree > 0) ? vol->maxFree * 2 : 64;
+        freeExtent = (edubfm_CompressExtent_T*)realloc(vol->freeExtent, maxFree * sizeof(edubfm_CompressExtent_T));
+        if (freeExtent == NULL) ERR(eMEMALLOCFAILED_EDUBFM);
+
+        vol->freeExtent = freeExtent;
+        vol->maxFree = maxFree;
+    }
+
+    vol->freeExtent[vol->nFree].unit = unit;
+    vol->freeExtent[vol->nFree].nUnits = nUnits;
+    vol->nFree++;
+
+    return(eNOERROR);
+
+}  /* edubfm_FreeExtent() */
+
+
+
+/*@================================
+ * edubfm_AllocExtent()
+ *================================*/
+/*
+ * Function: static Four edubfm_AllocExtent(edubfm_CompressedVolume_T*, Four, Four*)
+ *
+ * Description:
+ *  Allocate nUnits contiguous units of the side file of a compressed
+ *  volume: the first free extent large enough, the rest of which stays
+ *  free, or else the end of the side file. The caller holds the latch of
+ *  the volume.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by edubfm_FreeExtent()
+ */
+static Four edubfm_AllocExtent(
+    edubfm_CompressedVolume_T *vol,     /* IN entry of the volume */
+    Four                nUnits,         /* IN # of units to allocate */
+    Four                *unit)          /* OUT first unit allocated */
+{
+    Four                e;              /* for error */
+    Four                rest;           /* # of units of the free extent left */
+    Four                i;              /* index */
+
+
+    for (i = 0; i < vol->nFree; i++)
+        if (vol->freeExtent[i].nUnits >= nUnits) break;
+
+    if (i == vol->nFree) {
+        *unit = vol->nUnits;
+        vol->nUnits += nUnits;
+        return(eNOERROR);
+    }
+
+    *unit = vol->freeExtent[i].unit;
+    rest = vol->freeExtent[i].nUnits - nUnits;
+    vol->freeExtent[i] = vol->freeExtent[--vol->nFree];
+
+    if (rest > 0) {
+        e = edubfm_FreeExtent(vol, *unit + nUnits, rest, TRUE);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_AllocExtent() */
+
+
+
+/*@================================
+ * edubfm_LoadSideFile()
+ *================================*/
+/*
+ * Function: static Four edubfm_LoadSideFile(edubfm_CompressedVolume_T*)
+ *
+ * Description:
+ *  Rebuild the index and the free extents of a compressed volume from the
+ *  headers of the extents of its side file. If a page has two extents,
+ *  which happens if the process stopped between writing the page to a new
+ *  extent and freeing the old one, the one written last is taken.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be read
+ *    eBADCOMPRESSEDTRAIN_EDUBFM - the side file is corrupted
+ *    some errors caused by function calls
+ */
+static Four edubfm_LoadSideFile(
+    edubfm_CompressedVolume_T *vol)     /* IN entry of the volume */
+{
+    Four                e;              /* for error */
+    BfMCompressHeader   header;         /* header of an extent */
+    BfMCompressHeader   other;          /* header of the other extent of a page */
+    edubfm_CompressExtent_T *kept;      /* extent of the page in the index */
+    Four                unit;           /* first unit of the extent */
+    ssize_t             n;              /* # of bytes read */
+
+
+    for (unit = 0; ; unit += header.nUnits) {
+        n = pread(vol->fd, &header, sizeof(header), BFM_COMPRESS_OFFSET(unit));
+        if (n < 0) ERR(eFILEIOFAILED_EDUBFM);
+        if (n == 0) break;              /* end of the side file */
+
+        if (n != sizeof(header) || header.magic != BFM_COMPRESS_MAGIC ||
+            header.nUnits < 1 || header.length < 0 ||
+            (size_t)header.nUnits * BFM_COMPRESS_UNIT < sizeof(header) + header.length)
+            ERR(eBADCOMPRESSEDTRAIN_EDUBFM);
+        if ((Four)(header.seq - vol->seq) > 0) vol->seq = header.seq;
+
+        if (header.pageNo == NIL) {
+            e = edubfm_FreeExtent(vol, unit, header.nUnits, FALSE);
+            if (e < 0) ERR(e);
+            continue;
+        }
+        if (header.pageNo < 0) ERR(eBADCOMPRESSEDTRAIN_EDUBFM);
+
+        e = edubfm_GrowIndex(vol, header.pageNo);
+        if (e < 0) ERR(e);
+
+        kept = &vol->index[header.pageNo];
+        if (kept->unit != NIL) {
+            if (pread(vol->fd, &other, sizeof(other), BFM_COMPRESS_OFFSET(kept->unit)) != sizeof(other))
+                ERR(eFILEIOFAILED_EDUBFM);
+
+            if ((Four)(header.seq - other.seq) < 0) {
+                e = edubfm_FreeExtent(vol, unit, header.nUnits, TRUE);
+                if (e < 0) ERR(e);
+                continue;
+            }
+
+            e = edubfm_FreeExtent(vol, kept->unit, kept->nUnits, TRUE);
+            if (e < 0) ERR(e);
+        }
+
+        kept->unit = unit;
+        kept->nUnits = header.nUnits;
+    }
+
+    vol->nUnits = unit;
+
+    return(eNOERROR);
+
+}  /* edubfm_LoadSideFile() */
+
+
+
+/*@================================
+ * edubfm_ExtentIOs()
+ *================================*/
+/*
+ * Function: static Four edubfm_ExtentIOs(edubfm_CompressedVolume_T*, Four, edubfm_CompressExtent_T*, Two, edubfm_CompressSlot_T*, BfMFileIO_T*, struct iovec*)
+ *
+ * Description:
+ *  Fill in the I/Os of the extents of the pages of a train, one for each
+ *  run of extents lying next to each other in the side file; the pages
+ *  with no extent are skipped.
+ *
+ * Returns:
+ *  # of I/Os filled in
+ */
+static Four edubfm_ExtentIOs(
+    edubfm_CompressedVolume_T *vol,     /* IN entry of the volume */
+    Four                op,             /* IN BFM_IO_READ or BFM_IO_WRITE */
+    edubfm_CompressExtent_T *extent,    /* IN extent of each page; unit is NIL if none */
+    Two                 nPages,         /* IN # of pages */
+    edubfm_CompressSlot_T *slot,        /* IN extent of each page in memory */
+    BfMFileIO_T         *ios,           /* OUT I/Os of the runs */
+    struct iovec        *iov)           /* OUT buffers of the extents */
+{
+    Four                nIOs;           /* # of I/Os */
+    Four                i;              /* index */
+
+
+    for (nIOs = 0, i = 0; i < nPages; i++) {
+        if (extent[i].unit == NIL) continue;
+
+        iov[i].iov_base = slot[i].bytes;
+        iov[i].iov_len = extent[i].nUnits * BFM_COMPRESS_UNIT;
+
+        if (i > 0 && extent[i-1].unit != NIL && extent[i].unit == extent[i-1].unit + extent[i-1].nUnits) {
+            ios[nIOs-1].iovcnt++;
+            continue;
+        }
+
+        ios[nIOs].op = op;
+        ios[nIOs].fd = vol->fd;
+        ios[nIOs].iov = &iov[i];
+        ios[nIOs].iovcnt = 1;
+        ios[nIOs].offset = BFM_COMPRESS_OFFSET(extent[i].unit);
+        nIOs++;
+    }
+
+    return(nIOs);
+
+}  /* edubfm_ExtentIOs() */
+
+
+
+/*@================================
+ * edubfm_DoExtentIOs()
+ *================================*/
+/*
+ * Function: static Four edubfm_DoExtentIOs(BfMFileIO_T*, Four)
+ *
+ * Description:
+ *  Do the I/Os of the extents of a train together, and check that each
+ *  one transferred all its extents.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be read or written
+ *    some errors caused by edubfm_FileIO()
+ */
+static Four edubfm_DoExtentIOs(
+    BfMFileIO_T         *ios,           /* INOUT I/Os to do */
+    Four                nIOs)           /* IN # of I/Os */
+{
+    Four                e;              /* for error */
+    ssize_t             length;         /* # of bytes of an I/O */
+    Four                i, j;           /* indexes */
+
+
+    e = edubfm_FileIO(ios, nIOs);
+    if (e < 0) ERR(e);
+
+    for (i = 0; i < nIOs; i++) {
+        for (length = 0, j = 0; j < ios[i].iovcnt; j++) length += ios[i].iov[j].iov_len;
+        if (ios[i].result != length) ERR(eFILEIOFAILED_EDUBFM);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_DoExtentIOs() */
+
+
+
+/*@================================
+ * edubfm_ReadPages()
+ *================================*/
+/*
+ * Function: static Four edubfm_ReadPages(edubfm_CompressedVolume_T*, PageNo, Two, char*, Boolean*)
+ *
+ * Description:
+ *  Read the pages of a train kept in the side file of a compressed volume
+ *  and decompress them into the buffer. The extents are looked up under
+ *  the latch of the volume, and read out of it, all together; a run of
+ *  extents lying next to each other is read by one I/O. The extents of
+ *  the train cannot be freed meanwhile, since a train is read only when
+ *  it is not in the buffer pool, and written only from there.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be read
+ *    eBADCOMPRESSEDTRAIN_EDUBFM - a page in the side file is corrupted
+ */
+static Four edubfm_ReadPages(
+    edubfm_CompressedVolume_T *vol,     /* IN entry of the volume */
+    PageNo              pageNo,         /* IN first page to read */
+    Two                 nPages,         /* IN # of pages; at most BFM_CLUSTER_MAXPAGES */
+    char                *buf,           /* OUT buffer */
+    Boolean             *found)         /* OUT TRUE for each page kept in the side file */
+{
+    Four                e;              /* for error */
+    edubfm_CompressSlot_T slot[BFM_CLUSTER_MAXPAGES];  /* extents read */
+    edubfm_CompressExtent_T extent[BFM_CLUSTER_MAXPAGES];  /* extent of each page */
+    BfMFileIO_T         ios[BFM_CLUSTER_MAXPAGES];      /* reads of the runs of extents */
+    struct iovec        iov[BFM_CLUSTER_MAXPAGES];      /* extents read */
+    BfMCompressHeader   *header;        /* header of a page read */
+    char                *data;          /* compressed page */
+    Four                i;              /* index */
+
+
+    pthread_mutex_lock(&vol->latch);
+    for (i = 0; i < nPages; i++) {
+        extent[i].unit = NIL;
+        if (BFM_COMPRESS_ISKEPT(vol, pageNo + i)) extent[i] = vol->index[pageNo + i];
+        found[i] = (extent[i].unit != NIL) ? TRUE : FALSE;
+    }
+    pthread_mutex_unlock(&vol->latch);
+
+    e = edubfm_DoExtentIOs(ios, edubfm_ExtentIOs(vol, BFM_IO_READ, extent, nPages, slot, ios, iov));
+    if (e < 0) ERR(e);
+
+    /*@ decompress them */
+    for (i = 0; i < nPages; i++) {
+        if (!found[i]) continue;
+
+        header = &slot[i].header;
+        data = &slot[i].bytes[sizeof(BfMCompressHeader)];
+
+        if (header->magic != BFM_COMPRESS_MAGIC || header->pageNo != pageNo + i ||
+            header->nUnits != extent[i].nUnits || header->length < 0 ||
+            (size_t)header->nUnits * BFM_COMPRESS_UNIT < sizeof(BfMCompressHeader) + header->length)
+            ERR(eBADCOMPRESSEDTRAIN_EDUBFM);
+
+        if (header->method == BFM_COMPRESS_RAW) {
+            if (header->length != PAGESIZE) ERR(eBADCOMPRESSEDTRAIN_EDUBFM);
+            memcpy(buf + i*PAGESIZE, data, PAGESIZE);
+        }
+        else if (edubfm_LzDecompress((UOne*)data, header->length, (UOne*)(buf + i*PAGESIZE), PAGESIZE) != PAGESIZE)
+            ERR(eBADCOMPRESSEDTRAIN_EDUBFM);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_ReadPages() */
+
+
+
+/*@================================
+ * edubfm_WritePages()
+ *================================*/
+/*
+ * Function: static Four edubfm_WritePages(edubfm_CompressedVolume_T*, PageNo, Two, edubfm_CompressSlot_T*, Four*)
+ *
+ * Description:
+ *  Write the compressed pages of a train to the side file of a compressed
+ *  volume. A page is rewritten in place if it fits in its extent; the
+ *  others are written to one new extent, one after the other, and their
+ *  old extents are freed afterwards. The extents are placed, and the old
+ *  ones freed, under the latch of the volume; they are written out of it,
+ *  all together, a run of extents lying next to each other by one I/O.
+ *
+ * Returns:
+ *  # of bytes of the extents written in 'nBytes'
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be written
+ *    some errors caused by function calls
+ */
+static Four edubfm_WritePages(
+    edubfm_CompressedVolume_T *vol,     /* IN entry of the volume */
+    PageNo              pageNo,         /* IN first page to write */
+    Two                 nPages,         /* IN # of pages; at most BFM_CLUSTER_MAXPAGES */
+    edubfm_CompressSlot_T *slot,        /* INOUT compressed pages; nUnits and seq are set here */
+    Four                *nBytes)        /* OUT # of bytes of the extents written */
+{
+    Four                e;              /* for error */
+    edubfm_CompressExtent_T target[BFM_CLUSTER_MAXPAGES];  /* extent of each page written */
+    BfMFileIO_T         ios[BFM_CLUSTER_MAXPAGES];      /* writes of the runs of extents */
+    struct iovec        iov[BFM_CLUSTER_MAXPAGES];      /* extents written */
+    BfMCompressHeader   *header;        /* header of a page */
+    edubfm_CompressExtent_T *kept;      /* extent of a page in the index */
+    Four                nMoved;         /* # of units of the pages written to a new extent */
+    Four                unit;           /* first unit of the new extent */
+    Four                i;              /* index */
+
+
+    pthread_mutex_lock(&vol->latch);
+
+    e = edubfm_GrowIndex(vol, pageNo + nPages - 1);
+    if (e < 0) {
+        pthread_mutex_unlock(&vol->latch);
+        ERR(e);
+    }
+
+    /*@ place the pages */
+    nMoved = 0;
+    for (i = 0; i < nPages; i++) {
+        kept = &vol->index[pageNo + i];
+        target[i].nUnits = BFM_COMPRESS_NUNITS(slot[i].header.length);
+
+        if (kept->unit != NIL && kept->nUnits >= target[i].nUnits) {
+            target[i] = *kept;
+        }
+        else {
+            target[i].unit = NIL;
+            nMoved += target[i].nUnits;
+        }
+    }
+
+    if (nMoved > 0) {
+        e = edubfm_AllocExtent(vol, nMoved, &unit);
+        if (e < 0) {
+            pthread_mutex_unlock(&vol->latch);
+            ERR(e);
+        }
+
+        for (i = 0; i < nPages; i++) {
+            if (target[i].unit != NIL) continue;
+            target[i].unit = unit;
+            unit += target[i].nUnits;
+        }
+    }
+
+    for (i = 0; i < nPages; i++) slot[i].header.seq = ++vol->seq;
+
+    pthread_mutex_unlock(&vol->latch);
+
+    /*@ write them */
+    *nBytes = 0;
+    for (i = 0; i < nPages; i++) {
+        header = &slot[i].header;
+        header->nUnits = target[i].nUnits;
+        memset(&slot[i].bytes[sizeof(BfMCompressHeader) + header->length], 0,
+               target[i].nUnits * BFM_COMPRESS_UNIT - sizeof(BfMCompressHeader) - header->length);
+        *nBytes += target[i].nUnits * BFM_COMPRESS_UNIT;
+    }
+
+    e = edubfm_DoExtentIOs(ios, edubfm_ExtentIOs(vol, BFM_IO_WRITE, target, nPages, slot, ios, iov));
+    if (e < 0) ERR(e);
+
+    /*@ free the old extents of the pages moved */
+    pthread_mutex_lock(&vol->latch);
+    for (i = 0; i < nPages; i++) {
+        kept = &vol->index[pageNo + i];
+        if (kept->unit == target[i].unit) continue;
+
+        if (kept->unit != NIL) {
+            e = edubfm_FreeExtent(vol, kept->unit, kept->nUnits, TRUE);
+            if (e < 0) {
+                pthread_mutex_unlock(&vol->latch);
+                ERR(e);
+            }
+        }
+        *kept = target[i];
+    }
+    pthread_mutex_unlock(&vol->latch);
+
+    return(eNOERROR);
+
+}  /* edubfm_WritePages() */
+
+
+
+/*@================================
+ * edubfm_ReleaseCompressedVolume()
+ *================================*/
+/*
+ * Function: static void edubfm_ReleaseCompressedVolume(edubfm_CompressedVolume_T*)
+ *
+ * Description:
+ *  Close the side file of a compressed volume and free its entry.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_ReleaseCompressedVolume(
+    edubfm_CompressedVolume_T *vol)     /* IN entry of the volume */
+{
+    close(vol->fd);
+    pthread_mutex_destroy(&vol->latch);
+    free(vol->index);
+    free(vol->freeExtent);
+
+    vol->volNo = NIL;
+    vol->fd = -1;
+    vol->index = vol->freeExtent = NULL;
+    vol->nIndex = vol->nFree = vol->maxFree = vol->nUnits = 0;
+    vol->seq = 0;
+
+}  /* edubfm_ReleaseCompressedVolume() */
+
+
+
+/*@================================
+ * edubfm_UncompressVolume()
+ *================================*/
+/*
+ * Function: static Four edubfm_UncompressVolume(edubfm_CompressedVolume_T*)
+ *
+ * Description:
+ *  Write every page kept in the side file back to the volume, and empty
+ *  the side file so that it does not hide the volume when given again.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be emptied
+ *    some errors caused by function calls
+ */
+static Four edubfm_UncompressVolume(
+    edubfm_CompressedVolume_T *vol)     /* IN entry of the volume */
+{
+    Four                e;              /* for error */
+    TrainID             pageId;         /* page written back */
+    char                page[PAGESIZE]; /* page decompressed */
+    Boolean             found;          /* TRUE if the page is kept in the side file */
+
+
+    pageId.volNo = vol->volNo;
+    for (pageId.pageNo = 0; pageId.pageNo < vol->nIndex; pageId.pageNo++) {
+        if (vol->index[pageId.pageNo].unit == NIL) continue;
+
+        e = edubfm_ReadPages(vol, pageId.pageNo, 1, page, &found);
+        if (e < 0) ERR(e);
+
+        e = edubfm_VolumeWrite(&pageId, page, 1);
+        if (e < 0) ERR(e);
+    }
+
+    if (ftruncate(vol->fd, 0) < 0) ERR(eFILEIOFAILED_EDUBFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_UncompressVolume() */
+
+
+
+/*@================================
+ * edubfm_SetCompression()
+ *================================*/
+/*
+ * Function: Four edubfm_SetCompression(VolNo, char*)
+ *
+ * Description:
+ *  Compress the trains of the volume into the given side file, which is
+ *  created if it does not exist; the pages it already keeps are found by
+ *  their headers. With NULL, write the pages kept in the side file back to
+ *  the volume, empty the side file, and stop compressing the volume. If
+ *  they cannot all be written back, the volume stays compressed. The
+ *  caller makes sure that no I/O on the volume is in progress.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - the volume is not compressed, too many volumes,
+ *                           or the volume is striped
+ *    eCREATEFILEFAILED_BFM - the side file cannot be opened
+ *    some errors caused by function calls
+ */
+Four edubfm_SetCompression(
+    VolNo               volNo,          /* IN volume */
+    char                *path)          /* IN side file; NULL to stop compressing */
+{
+    Four                e;              /* for error */
+    edubfm_CompressedVolume_T *vol;     /* entry of the volume */
+    int                 fd;             /* side file */
+
+
+    if (path != NULL && edubfm_IsStripedVolume(volNo)) ERR(eBADPARAMETER_EDUBFM);
+
+    vol = edubfm_FindCompressedVolume(volNo);
+
+    if (path == NULL) {
+        if (vol == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+        e = edubfm_UncompressVolume(vol);
+        if (e < 0) ERR(e);
+
+        edubfm_ReleaseCompressedVolume(vol);
+
+        return(eNOERROR);
+    }
+
+    if (vol != NULL)
+        edubfm_ReleaseCompressedVolume(vol);
+    else {
+        vol = edubfm_FindCompressedVolume(NIL);
+        if (vol == NULL) ERR(eBADPARAMETER_EDUBFM);
+    }
+
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) ERR(eCREATEFILEFAILED_BFM);
+
+    vol->fd = fd;
+    pthread_mutex_init(&vol->latch, NULL);
+
+    e = edubfm_LoadSideFile(vol);
+    if (e < 0) {
+        edubfm_ReleaseCompressedVolume(vol);
+        ERR(e);
+    }
+    vol->volNo = volNo;
+
+    return(eNOERROR);
+
+}  /* edubfm_SetCompression() */
+
+
+
+/*@================================
+ * edubfm_CompressedRead()
+ *================================*/
+/*
+ * Function: Four edubfm_CompressedRead(TrainID*, char*, Two)
+ *
+ * Description:
+ *  Read a train of a compressed volume from the side file and decompress
+ *  it into the buffer page by page. The pages of the train never written
+ *  to the side file are read from the volume.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - the volume is not compressed, or no page of the train
+ *                    was written to the side file; read it from the volume
+ *    eBADPARAMETER_EDUBFM - the train is too long
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be read
+ *    eBADCOMPRESSEDTRAIN_EDUBFM - a page in the side file is corrupted
+ *    some errors caused by edubfm_VolumeRead()
+ */
+Four edubfm_CompressedRead(
+    TrainID             *trainId,       /* IN train to read */
+    char                *buf,           /* OUT buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    Four                e;              /* for error */
+    edubfm_CompressedVolume_T *vol;     /* entry of the volume */
+    Boolean             found[BFM_CLUSTER_MAXPAGES];    /* TRUE if the page is in the side file */
+    Four                nFound;         /* # of pages in the side file */
+    TrainID             pageId;         /* page of the train */
+    Four                i;              /* index */
+
+
+    vol = edubfm_FindCompressedVolume(trainId->volNo);
+    if (vol == NULL) return(eNOTFOUND_BFM);
+
+    if (nPages > BFM_CLUSTER_MAXPAGES) ERR(eBADPARAMETER_EDUBFM);
+
+    e = edubfm_ReadPages(vol, trainId->pageNo, nPages, buf, found);
+    if (e < 0) ERR(e);
+
+    for (nFound = i = 0; i < nPages; i++)
+        if (found[i]) nFound++;
+
+    if (nFound == 0) return(eNOTFOUND_BFM);
+
+    pageId.volNo = trainId->volNo;
+    for (i = 0; i < nPages; i++) {
+        if (found[i]) continue;
+
+        pageId.pageNo = trainId->pageNo + i;
+        e = edubfm_VolumeRead(&pageId, buf + i*PAGESIZE, 1);
+        if (e == eVOLUMEIODEFERRED_EDUBFM) return(e);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_CompressedRead() */
+
+
+
+/*@================================
+ * edubfm_CompressedWrite()
+ *================================*/
+/*
+ * Function: Four edubfm_CompressedWrite(TrainID*, char*, Two)
+ *
+ * Description:
+ *  Compress the pages of a train of a compressed volume one by one and
+ *  write them to the side file, each in its own extent, so that a page can
+ *  be read back by a train of any length. A page which does not get
+ *  smaller is stored as is; a train counts as stored uncompressed if none
+ *  of its pages got smaller.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - the volume is not compressed; write it to the volume
+ *    eBADPARAMETER_EDUBFM - the train is too long
+ *    eFILEIOFAILED_EDUBFM - the side file cannot be written
+ *    some errors caused by edubfm_WritePages()
+ */
+Four edubfm_CompressedWrite(
+    TrainID             *trainId,       /* IN train to write */
+    char                *buf,           /* IN buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    Four                e;              /* for error */
+    edubfm_CompressedVolume_T *vol;     /* entry of the volume */
+    edubfm_CompressSlot_T slot[BFM_CLUSTER_MAXPAGES];  /* compressed pages */
+    BfMCompressHeader   *header;        /* header of a page */
+    Four                nBytes;         /* # of bytes stored for the train */
+    Four                nRaw;           /* # of pages stored uncompressed */
+    Four                i;              /* index */
+
+
+    vol = edubfm_FindCompressedVolume(trainId->volNo);
+    if (vol == NULL) return(eNOTFOUND_BFM);
+
+    if (nPages > BFM_CLUSTER_MAXPAGES) ERR(eBADPARAMETER_EDUBFM);
+
+    for (nRaw = i = 0; i < nPages; i++) {
+        header = &slot[i].header;
+        header->magic = BFM_COMPRESS_MAGIC;
+        header->pageNo = trainId->pageNo + i;
+        header->method = BFM_COMPRESS_LZ;
+        header->length = edubfm_LzCompress((UOne*)(buf + i*PAGESIZE), PAGESIZE,
+                                           (UOne*)&slot[i].bytes[sizeof(BfMCompressHeader)], PAGESIZE - 1);
+        if (header->length == 0) {
+            header->method = BFM_COMPRESS_RAW;
+            header->length = PAGESIZE;
+            memcpy(&slot[i].bytes[sizeof(BfMCompressHeader)], buf + i*PAGESIZE, PAGESIZE);
+            nRaw++;
+        }
+    }
+
+    e = edubfm_WritePages(vol, trainId->pageNo, nPages, slot, &nBytes);
+    if (e < 0) ERR(e);
+
+    pthread_mutex_lock(&edubfm_compressStatLatch);
+    edubfm_compressStat.nTrainsWritten++;
+    if (nRaw == nPages) edubfm_compressStat.nTrainsRaw++;
+    edubfm_compressStat.nBytesIn += (double)nPages * PAGESIZE;
+    edubfm_compressStat.nBytesOut += nBytes;
+    pthread_mutex_unlock(&edubfm_compressStatLatch);
+
+    return(eNOERROR);
+
+}  /* edubfm_CompressedWrite() */
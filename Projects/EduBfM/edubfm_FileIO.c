@@ -0,0 +1,403 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/*
+ * Module: edubfm_FileIO.c
+ *
+ * Description:
+ *  Batches of reads and writes of the side files and the device files.
+ *  A batch is submitted at once to an io_uring of the calling thread, so
+ *  that its I/Os overlap in the kernel without worker threads, and the
+ *  thread waits until all of them are done. If io_uring is not available,
+ *  e.g. on an old kernel or under a seccomp filter, or it is disabled, the
+ *  I/Os are done one by one by preadv() and pwritev().
+ *  The rings are set up by the system calls directly, without liburing;
+ *  a ring is created by each thread the first time it is used and closed
+ *  when the thread exits.
+ *
+ * Exports:
+ *  Four edubfm_FileIO(BfMFileIO_T *, Four)
+ */
+
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * type definitions
+ */
+/* an io_uring mapped in the process */
+typedef struct {
+    int                 fd;             /* file descriptor of the ring */
+    unsigned            *sqTail;        /* tail of the submission queue */
+    unsigned            *sqMask;        /* mask of the submission queue */
+    unsigned            *sqArray;       /* indexes of the submission queue entries */
+    struct io_uring_sqe *sqes;          /* submission queue entries */
+    unsigned            *cqHead;        /* head of the completion queue */
+    unsigned            *cqTail;        /* tail of the completion queue */
+    unsigned            *cqMask;        /* mask of the completion queue */
+    struct io_uring_cqe *cqes;          /* completion queue entries */
+    void                *sqRing;        /* mapping of the submission queue */
+    size_t              sqRingSize;
+    void                *cqRing;        /* mapping of the completion queue; sqRing if shared */
+    size_t              cqRingSize;
+    size_t              sqesSize;       /* size of the mapping of sqes */
+} edubfm_Uring_T;
+
+
+/*@
+ * global variables
+ */
+/* FALSE to do the I/Os by preadv() and pwritev() */
+Four edubfm_uringEnabled = TRUE;
+
+static pthread_once_t edubfm_uringOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t edubfm_uringKey;   /* ring of the calling thread */
+static Four edubfm_uringAvailable = TRUE;   /* FALSE once a ring cannot be set up */
+
+
+
+/*@================================
+ * edubfm_CloseUring()
+ *================================*/
+/*
+ * Function: static void edubfm_CloseUring(void*)
+ *
+ * Description:
+ *  Unmap and close the ring of a thread; called when the thread exits.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_CloseUring(
+    void                *arg)           /* IN ring to close */
+{
+    edubfm_Uring_T      *ring = (edubfm_Uring_T*)arg;  /* ring to close */
+
+
+    munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqRing != ring->sqRing) munmap(ring->cqRing, ring->cqRingSize);
+    munmap(ring->sqRing, ring->sqRingSize);
+    close(ring->fd);
+    free(ring);
+
+}  /* edubfm_CloseUring() */
+
+
+
+/*@================================
+ * edubfm_CreateUringKey()
+ *================================*/
+/*
+ * Function: static void edubfm_CreateUringKey(void)
+ *
+ * Description:
+ *  Create the key of the rings of the threads, once per process.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_CreateUringKey(void)
+{
+    if (pthread_key_create(&edubfm_uringKey, edubfm_CloseUring) != 0)
+        edubfm_uringAvailable = FALSE;
+
+}  /* edubfm_CreateUringKey() */
+
+
+
+/*@================================
+ * edubfm_GetUring()
+ *================================*/
+/*
+ * Function: static edubfm_Uring_T *edubfm_GetUring(void)
+ *
+ * Description:
+ *  Return the ring of the calling thread, setting it up the first time.
+ *  If a ring cannot be set up, io_uring is not used by the process any
+ *  more.
+ *
+ * Returns:
+ *  pointer to the ring; NULL if io_uring is not available
+ */
+static edubfm_Uring_T *edubfm_GetUring(void)
+{
+    edubfm_Uring_T      *ring;          /* ring of the thread */
+    struct io_uring_params params;      /* parameters of the ring */
+    char                *sq;            /* mapping of the submission queue */
+    char                *cq;            /* mapping of the completion queue */
+
+
+    pthread_once(&edubfm_uringOnce, edubfm_CreateUringKey);
+    if (!edubfm_uringAvailable) return(NULL);
+
+    ring = (edubfm_Uring_T*)pthread_getspecific(edubfm_uringKey);
+    if (ring != NULL) return(ring);
+
+    ring = (edubfm_Uring_T*)malloc(sizeof(edubfm_Uring_T));
+    if (ring == NULL) return(NULL);
+
+    memset(&params, 0, sizeof(params));
+    ring->fd = syscall(__NR_io_uring_setup, BFM_FILEIO_MAXBATCH, &params);
+    if (ring->fd < 0) {
+        free(ring);
+        edubfm_uringAvailable = FALSE;
+        return(NULL);
+    }
+
+    /*@ map the queues */
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cqRingSize > ring->sqRingSize) ring->sqRingSize = ring->cqRingSize;
+        ring->cqRingSize = ring->sqRingSize;
+    }
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->fd, IORING_OFF_SQ_RING);
+    ring->cqRing = ring->sqRing;
+    if (ring->sqRing != MAP_FAILED && !(params.features & IORING_FEAT_SINGLE_MMAP))
+        ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe*)MAP_FAILED;
+    if (ring->sqRing != MAP_FAILED && ring->cqRing != MAP_FAILED)
+        ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cqRing != MAP_FAILED && ring->cqRing != ring->sqRing) munmap(ring->cqRing, ring->cqRingSize);
+        if (ring->sqRing != MAP_FAILED) munmap(ring->sqRing, ring->sqRingSize);
+        close(ring->fd);
+        free(ring);
+        edubfm_uringAvailable = FALSE;
+        return(NULL);
+    }
+
+    sq = (char*)ring->sqRing;
+    cq = (char*)ring->cqRing;
+    ring->sqTail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned*)(sq + params.sq_off.array);
+    ring->cqHead = (unsigned*)(cq + params.cq_off.head);
+    ring->cqTail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    if (pthread_setspecific(edubfm_uringKey, ring) != 0) {
+        edubfm_CloseUring(ring);
+        return(NULL);
+    }
+
+    return(ring);
+
+}  /* edubfm_GetUring() */
+
+
+
+/*@================================
+ * edubfm_SyncFileIO()
+ *================================*/
+/*
+ * Function: static void edubfm_SyncFileIO(BfMFileIO_T*)
+ *
+ * Description:
+ *  Do an I/O by preadv() or pwritev(), resuming it if a signal interrupts
+ *  it.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_SyncFileIO(
+    BfMFileIO_T         *io)            /* INOUT I/O to do */
+{
+    do {
+        if (io->op == BFM_IO_READ)
+            io->result = preadv(io->fd, io->iov, io->iovcnt, io->offset);
+        else
+            io->result = pwritev(io->fd, io->iov, io->iovcnt, io->offset);
+    } while (io->result < 0 && errno == EINTR);
+
+    if (io->result < 0) io->result = -errno;
+
+}  /* edubfm_SyncFileIO() */
+
+
+
+/*@================================
+ * edubfm_UringFileIO()
+ *================================*/
+/*
+ * Function: static Four edubfm_UringFileIO(edubfm_Uring_T*, BfMFileIO_T*, Four)
+ *
+ * Description:
+ *  Submit at most BFM_FILEIO_MAXBATCH I/Os to the ring at once, and wait
+ *  for all of them.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - the ring failed; the I/Os are not done
+ */
+static Four edubfm_UringFileIO(
+    edubfm_Uring_T      *ring,          /* IN ring of the thread */
+    BfMFileIO_T         *ios,           /* INOUT I/Os to do */
+    Four                nIOs)           /* IN # of I/Os */
+{
+    struct io_uring_sqe *sqe;           /* entry submitted */
+    struct io_uring_cqe *cqe;           /* entry completed */
+    unsigned            tail;           /* tail of the submission queue */
+    unsigned            head;           /* head of the completion queue */
+    Four                nDone;          /* # of I/Os completed */
+    Four                nSubmitted;     /* # of I/Os taken by the kernel */
+    long                n;              /* result of io_uring_enter */
+    Four                i;              /* index */
+
+
+    /*@ fill in the submission queue */
+    tail = *ring->sqTail;
+    for (i = 0; i < nIOs; i++, tail++) {
+        sqe = &ring->sqes[tail & *ring->sqMask];
+        memset(sqe, 0, sizeof(struct io_uring_sqe));
+        sqe->opcode = (ios[i].op == BFM_IO_READ) ? IORING_OP_READV : IORING_OP_WRITEV;
+        sqe->fd = ios[i].fd;
+        sqe->addr = (unsigned long)ios[i].iov;
+        sqe->len = ios[i].iovcnt;
+        sqe->off = ios[i].offset;
+        sqe->user_data = i;
+        ring->sqArray[tail & *ring->sqMask] = tail & *ring->sqMask;
+    }
+    __atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+
+    /*@ submit them and reap the completions */
+    nSubmitted = 0;
+    nDone = 0;
+    while (nDone < nIOs) {
+        n = syscall(__NR_io_uring_enter, ring->fd, nIOs - nSubmitted, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (nSubmitted == 0 && nDone == 0) return(eFILEIOFAILED_EDUBFM);
+            n = 0;
+        }
+        nSubmitted += n;
+
+        head = *ring->cqHead;
+        while (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+            cqe = &ring->cqes[head & *ring->cqMask];
+            ios[cqe->user_data].result = cqe->res;
+            head++;
+            nDone++;
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_UringFileIO() */
+
+
+
+/*@================================
+ * edubfm_FileIO()
+ *================================*/
+/*
+ * Function: Four edubfm_FileIO(BfMFileIO_T*, Four)
+ *
+ * Description:
+ *  Do a batch of reads and writes of files, and wait until all of them
+ *  are done. The caller fills in op, fd, iov, iovcnt and offset of each
+ *  I/O; the result is the # of bytes transferred or -errno. An I/O cut
+ *  short by the ring, which the kernel may do before the end of the file,
+ *  is done again by preadv() or pwritev(), so a read is short only at the
+ *  end of the file.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad # of I/Os
+ */
+Four edubfm_FileIO(
+    BfMFileIO_T         *ios,           /* INOUT I/Os to do */
+    Four                nIOs)           /* IN # of I/Os */
+{
+    edubfm_Uring_T      *ring;          /* ring of the thread */
+    ssize_t             length;         /* # of bytes of an I/O */
+    Four                n;              /* # of I/Os submitted together */
+    Four                i, j, k;        /* indexes */
+
+
+    if (nIOs < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    /* a single I/O gains nothing from the ring */
+    ring = (edubfm_uringEnabled && nIOs > 1) ? edubfm_GetUring() : NULL;
+
+    for (i = 0; i < nIOs; i += n) {
+        n = (nIOs - i < BFM_FILEIO_MAXBATCH) ? nIOs - i : BFM_FILEIO_MAXBATCH;
+
+        if (ring == NULL || edubfm_UringFileIO(ring, &ios[i], n) < 0) {
+            for (j = i; j < i + n; j++) edubfm_SyncFileIO(&ios[j]);
+            continue;
+        }
+
+        for (j = i; j < i + n; j++) {
+            for (length = 0, k = 0; k < ios[j].iovcnt; k++) length += ios[j].iov[k].iov_len;
+            if (ios[j].result >= 0 && ios[j].result < length) edubfm_SyncFileIO(&ios[j]);
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_FileIO() */
@@ -54,9 +54,12 @@
  *
  * Exports:
  *  Four edubfm_FlushTrain(TrainID *, Four)
+ *  Four edubfm_FlushTrains(Four, Four *, Four)
+ *  Four edubfm_FlushCluster(TrainID *, Four)
  */
 
 
+#include <string.h>
 #include "EduBfM_common.h"
 #include "RDsM.h"
 #include "RM.h"
@@ -78,7 +81,7 @@
  *  Construct a hash key using the TrainID 'trainId'(actually same)
  *  in order to look up the buffer in the buffer pool. If it is successfully
  *  found, then force it out to the disk using RDsM, especially
- *  RDsM_WriteTrain().
+ *  RDsM_WriteTrain(), through the current storage backend.
  *
  * Returns:
  *  error code
@@ -101,7 +104,7 @@ Four edubfm_FlushTrain(
         ERR ( eNOTFOUND_BFM );
 
     if (BI_BITS(type, index) & DIRTY) {
-        e = RDsM_WriteTrain(BI_BUFFER(type, index), trainId, BI_BUFSIZE(type));
+        e = BFM_STORAGE_WRITE(trainId, BI_BUFFER(type, index), BI_BUFSIZE(type));
 	    if ( e < 0 ) ERR ( e );
         BI_BITS(type, index) &= ~DIRTY;
     }
@@ -109,3 +112,186 @@ Four edubfm_FlushTrain(
     return( eNOERROR );
 
 }  /* edubfm_FlushTrain */
+
+
+
+/*@================================
+ * edubfm_FlushTrains()
+ *================================*/
+/*
+ * Function: Four edubfm_FlushTrains(Four, Four*, Four)
+ *
+ * Description : 
+ *  Write the dirty buffers given by their indexes into the disk.
+ *  The writes are submitted to the I/O engine in a batch, and the buffers
+ *  written successfully are marked clean.
+ *  The caller holds the pool latch of the buffer type.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - too many buffers
+ *    some errors caused by function calls
+ */
+Four edubfm_FlushTrains(
+    Four                type,           /* IN buffer type */
+    Four                *index,         /* IN indexes of the buffers to write */
+    Four                nTrains)        /* IN # of buffers */
+{
+    Four                e;              /* for errors */
+    BfMIORequest_T      req[BFM_IO_MAXBATCH];   /* writes of the buffers */
+    Four                i;              /* loop index */
+
+
+	/* Error check whether using not supported functionality by EduBfM */
+	if (RM_IS_ROLLBACK_REQUIRED()) ERR(eNOTSUPPORTED_EDUBFM);
+
+    if (nTrains > BFM_IO_MAXBATCH) ERR( eBADPARAMETER_EDUBFM );
+
+    for (i = 0; i < nTrains; i++) {
+        req[i].op = BFM_IO_WRITE;
+        req[i].trainId.volNo = BI_KEY(type, index[i]).volNo;
+        req[i].trainId.pageNo = BI_KEY(type, index[i]).pageNo;
+        req[i].buf = BI_BUFFER(type, index[i]);
+        req[i].nPages = BI_BUFSIZE(type);
+        req[i].deferVolume = FALSE;
+    }
+
+    e = edubfm_SubmitIO(req, nTrains);
+    if ( e < 0 ) ERR( e );
+
+    for (i = 0; i < nTrains; i++)
+        if (edubfm_WaitIO(&req[i]) >= 0)
+            BI_BITS(type, index[i]) &= ~DIRTY;
+
+    for (i = 0; i < nTrains; i++)
+        if (req[i].status < 0) ERR( req[i].status );
+
+    return( eNOERROR );
+
+}  /* edubfm_FlushTrains */
+
+
+
+/*@================================
+ * edubfm_FlushCluster()
+ *================================*/
+/*
+ * Function: Four edubfm_FlushCluster(TrainID*, Four)
+ *
+ * Description : 
+ *  Write a dirty victim specified by 'trainId' into the disk together with
+ *  its dirty neighbors. The run of dirty and unfixed pages with adjacent
+ *  page numbers around the victim, up to BFM_CLUSTER_MAXPAGES pages, is
+ *  written whatever its length and its first page number: RDsM writes a
+ *  train of BFM_CLUSTER_NPAGES pages or a single page from one buffer, so
+ *  the run is cut into trains of BFM_CLUSTER_NPAGES pages and the pages
+ *  left at its end are written one by one. The pages of a train are
+ *  written in place if their buffers lie next to each other in the pool,
+ *  and copied into a buffer of the call otherwise. The writes are
+ *  submitted to the I/O engine in a batch, and the pages written are
+ *  marked clean. A victim with no such neighbor is written alone by
+ *  edubfm_FlushTrain().
+ *  Only the buffer types holding one page per buffer are clustered, and
+ *  the trains of compressed or striped volumes are never clustered since
+ *  those backends lay out each page on their own.
+ *  The caller holds the pool latch of the buffer type.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_FlushCluster(
+    TrainID             *trainId,       /* IN victim to be flushed */
+    Four                type)           /* IN buffer type */
+{
+    char                staging[BFM_CLUSTER_MAXPAGES*PAGESIZE] __attribute__((aligned(PAGESIZE)));  /* trains copied */
+    BfMIORequest_T      req[BFM_CLUSTER_MAXPAGES];  /* writes of the pieces of the run */
+    Four                nReqs;          /* # of writes */
+    Four                e;              /* for errors */
+    Four                index;          /* index of the victim */
+    Four                run[BFM_CLUSTER_MAXPAGES];  /* indexes of the buffers in the run */
+    PageNo              firstPageNo;    /* page number of run[0] */
+    Four                nBefore;        /* # of neighbors before the victim */
+    Four                nPages;         /* # of pages in the run */
+    Four                chunk;          /* first position of the piece being written */
+    Four                idx;            /* index of a neighbor */
+    Four                i;              /* loop index */
+    BfMHashKey          key;            /* key of a neighbor */
+
+
+    key.volNo = trainId->volNo;
+    key.pageNo = trainId->pageNo;
+
+    index = edubfm_LookUp(&key, type);
+    if (index == NIL) ERR( eNOTFOUND_BFM );
+
+    if (BI_BUFSIZE(type) != 1 || !(BI_BITS(type, index) & DIRTY) ||
+        edubfm_IsCompressedVolume(trainId->volNo) || edubfm_IsStripedVolume(trainId->volNo))
+        return( edubfm_FlushTrain(trainId, type) );
+
+    /*@ gather the dirty and unfixed neighbors before the victim */
+    nBefore = 0;
+    while (nBefore < BFM_CLUSTER_MAXPAGES - 1 && key.pageNo > 0) {
+        key.pageNo--;
+        idx = edubfm_LookUp(&key, type);
+        if (idx == NIL || BI_FIXED(type, idx) > 0 || !(BI_BITS(type, idx) & DIRTY)) break;
+        nBefore++;
+    }
+    firstPageNo = trainId->pageNo - nBefore;
+
+    /*@ lay out the run: the neighbors before, the victim, and the neighbors after */
+    nPages = 0;
+    key.volNo = trainId->volNo;
+    for (key.pageNo = firstPageNo; key.pageNo < trainId->pageNo; key.pageNo++)
+        run[nPages++] = edubfm_LookUp(&key, type);
+    run[nPages++] = index;
+    for (key.pageNo = trainId->pageNo + 1; nPages < BFM_CLUSTER_MAXPAGES; key.pageNo++) {
+        idx = edubfm_LookUp(&key, type);
+        if (idx == NIL || BI_FIXED(type, idx) > 0 || !(BI_BITS(type, idx) & DIRTY)) break;
+        run[nPages++] = idx;
+    }
+
+    if (nPages == 1) return( edubfm_FlushTrain(trainId, type) );
+
+    /*@ cut the run into trains and single pages, and write them in a batch */
+    nReqs = 0;
+    for (chunk = 0; chunk < nPages; chunk += req[nReqs-1].nPages) {
+        req[nReqs].op = BFM_IO_WRITE;
+        req[nReqs].trainId.volNo = trainId->volNo;
+        req[nReqs].trainId.pageNo = firstPageNo + chunk;
+        req[nReqs].deferVolume = FALSE;
+
+        if (nPages - chunk >= BFM_CLUSTER_NPAGES) {
+            for (i = 1; i < BFM_CLUSTER_NPAGES; i++)
+                if (BI_BUFFER(type, run[chunk+i]) != BI_BUFFER(type, run[chunk]) + i*PAGESIZE) break;
+            if (i < BFM_CLUSTER_NPAGES) {
+                for (i = 0; i < BFM_CLUSTER_NPAGES; i++)
+                    memcpy(&staging[(chunk+i)*PAGESIZE], BI_BUFFER(type, run[chunk+i]), PAGESIZE);
+                req[nReqs].buf = &staging[chunk*PAGESIZE];
+            }
+            else
+                req[nReqs].buf = BI_BUFFER(type, run[chunk]);
+            req[nReqs].nPages = BFM_CLUSTER_NPAGES;
+        }
+        else {
+            req[nReqs].buf = BI_BUFFER(type, run[chunk]);
+            req[nReqs].nPages = 1;
+        }
+        nReqs++;
+    }
+
+    e = edubfm_SubmitIO(req, nReqs);
+    if ( e < 0 ) ERR( e );
+
+    for (chunk = 0, i = 0; i < nReqs; chunk += req[i].nPages, i++) {
+        if (edubfm_WaitIO(&req[i]) < 0) continue;
+        for (idx = chunk; idx < chunk + req[i].nPages; idx++)
+            BI_BITS(type, run[idx]) &= ~DIRTY;
+    }
+
+    for (i = 0; i < nReqs; i++)
+        if (req[i].status < 0) ERR( req[i].status );
+
+    return( eNOERROR );
+
+}  /* edubfm_FlushCluster */
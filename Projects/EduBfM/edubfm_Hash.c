@@ -55,9 +55,13 @@
  *  and each entry has an index which indicates a buffer in a buffer pool.
  *  An ordinary hashing method is used and linear probing strategy is
  *  used if collision has occurred.
+ *  edubfm_LookUp() is served first by a small thread-local cache of the
+ *  recently looked up keys, validated by the generation of the buffer
+ *  element; the generation is increased whenever a key is removed.
  *
  * Exports:
  *  Four edubfm_LookUp(BfMHashKey *, Four)
+ *  Four edubfm_LookUpOptimistic(BfMHashKey *, Four)
  *  Four edubfm_Insert(BfMHaskKey *, Two, Four)
  *  Four edubfm_Delete(BfMHashKey *, Four)
  *  Four edubfm_DeleteAll(void)
@@ -84,6 +88,17 @@
 #define BFM_HASH(k,type)	(((k)->volNo + (k)->pageNo) % HASHTABLESIZE(type))
 
 
+/*@
+ * global variables
+ */
+/* increased whenever the buffer pools are switched; starts at 1 since 0 marks an empty cache entry */
+Four edubfm_poolEpoch = 1;
+
+/* thread-local lookup cache and its statistics */
+static __thread BfMTLCacheEntry edubfm_tlCache[NUM_BUF_TYPES][BFM_TLCACHE_SIZE];
+__thread BfMLookUpStat edubfm_lookUpStat;
+
+
 /*@================================
  * edubfm_Insert()
  *================================*/
@@ -179,6 +194,11 @@ Four edubfm_Delete(
     else
         BI_NEXTHASHENTRY(type, prev) = BI_NEXTHASHENTRY(type, i);
 
+    /* invalidate the thread-local cache entries of all threads pointing to i */
+    BI_GENERATION(type, i)++;
+
+    return( eNOERROR );
+
 }  /* edubfm_Delete */
 
 
@@ -195,6 +215,8 @@ Four edubfm_Delete(
  *
  *  Look up the given key in the hash table and return its
  *  corressponding index to the buffer table.
+ *  The thread-local cache is checked before the hash table; an entry
+ *  found in the hash table is put in the cache.
  *
  * Retruns:
  *  index on buffer table entry holding the train specified by 'key'
@@ -207,11 +229,22 @@ Four edubfm_LookUp(
 	/* These local variables are used in the solution code. However, you dont have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Two                 i;                   /* indices */
     Two                 hashValue;
+    BfMTLCacheEntry     *entry;              /* entry of the thread-local cache */
 
 
     CHECKKEY(key);    /*@ check validity of key */
     if (IS_BAD_BUFFERTYPE(type)) ERR( eBADBUFFERTYPE_BFM );
 
+    edubfm_lookUpStat.nLookUps++;
+
+    entry = &edubfm_tlCache[type][BFM_TLCACHE_SLOT(key)];
+    if( entry->epoch == edubfm_poolEpoch && EQUALKEY(key, &entry->key) &&
+        BI_GENERATION(type, entry->index) == entry->generation &&
+        EQUALKEY(key, &BI_KEY(type, entry->index)) ) {
+        edubfm_lookUpStat.nCacheHits++;
+        return entry->index;
+    }
+
     hashValue = BFM_HASH(key, type);
     i = BI_HASHTABLEENTRY(type, hashValue);
     
@@ -223,12 +256,59 @@ Four edubfm_LookUp(
     if(i == NIL)
         return(NOTFOUND_IN_HTABLE);
 
+    entry->key = *key;
+    entry->index = i;
+    entry->generation = BI_GENERATION(type, i);
+    entry->epoch = edubfm_poolEpoch;
+
     return i;
     
 }  /* edubfm_LookUp */
 
 
 
+/*@================================
+ * edubfm_LookUpOptimistic()
+ *================================*/
+/*
+ * Function: Four edubfm_LookUpOptimistic(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Look up the given key in the hash table without the pool latch.
+ *  The hash chains may be changed meanwhile, so the walk may leave the
+ *  chain of the key or miss it; it is cut after BI_NBUFS() steps so that
+ *  it always ends. The returned index is only a guess: the caller must
+ *  check the key of the buffer element against its version (see
+ *  EduBfM_GetTrainOptimistic()), or have the train fixed.
+ *  The thread-local cache is neither used nor filled, as its entries are
+ *  only consistent with the hash table under the pool latch.
+ *
+ * Returns:
+ *  index on buffer table entry which held the train specified by 'key'
+ *  (NOTFOUND_IN_HTABLE - The key was not found in the hash table.)
+ */
+Four edubfm_LookUpOptimistic(
+    BfMHashKey          *key,                   /* IN a hash key in Buffer Manager */
+    Four                type)                   /* IN buffer type */
+{
+    Two                 i;                      /* index of the buffer element */
+    Four                n;                      /* # of steps in the chain */
+
+
+    i = __atomic_load_n(&BI_HASHTABLEENTRY(type, BFM_HASH(key, type)), __ATOMIC_RELAXED);
+
+    for (n = 0; i != NIL && n < BI_NBUFS(type); n++) {
+        if ( (i < 0) || (i >= BI_NBUFS(type)) ) break;
+        if ( EQUALKEY(key, &BI_KEY(type, i)) ) return i;
+        i = __atomic_load_n(&BI_NEXTHASHENTRY(type, i), __ATOMIC_RELAXED);
+    }
+
+    return(NOTFOUND_IN_HTABLE);
+
+}  /* edubfm_LookUpOptimistic */
+
+
+
 /*@================================
  * edubfm_DeleteAll()
  *================================*/
@@ -250,9 +330,12 @@ Four edubfm_DeleteAll(void)
     Two 	    type, i;
     Four        tableSize;
 
-    for(type = 0; type < NUM_BUF_TYPES; type++)
+    for(type = 0; type < NUM_BUF_TYPES; type++) {
         for(i = 0; i < HASHTABLESIZE(type); i++)
             BI_HASHTABLEENTRY(type, i) = NIL;
+        for(i = 0; i < BI_NBUFS(type); i++)
+            BI_GENERATION(type, i)++;
+    }
 
     return(eNOERROR);
 
@@ -0,0 +1,367 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_IOEngine.c
+ *
+ * Description:
+ *  I/O engine running batches of reads and writes of trains on a pool of
+ *  worker threads through the current storage backend. The file backend
+ *  serializes its calls to RDsM, so only the I/Os it does not pass to
+ *  RDsM overlap (see edubfm_Storage.c). Without worker threads, the
+ *  requests of a batch on striped volumes are still done together
+ *  through an io_uring (see edubfm_FileIO.c).
+ *
+ * Exports:
+ *  Four edubfm_SubmitIO(BfMIORequest_T *, Four)
+ *  Four edubfm_WaitIO(BfMIORequest_T *)
+ *  Boolean edubfm_PollIO(BfMIORequest_T *)
+ *  Four edubfm_StartIOEngine(Four)
+ *  Four edubfm_StopIOEngine(void)
+ *  Boolean edubfm_IsIOEngineRunning(void)
+ */
+
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * global variables
+ */
+static pthread_mutex_t edubfm_ioLatch = PTHREAD_MUTEX_INITIALIZER;  /* protects the queue */
+static pthread_cond_t edubfm_ioWork = PTHREAD_COND_INITIALIZER;     /* a request is queued */
+static pthread_cond_t edubfm_ioDone = PTHREAD_COND_INITIALIZER;     /* a request is done */
+static BfMIORequest_T *edubfm_ioHead = NULL;    /* queue of the requests submitted */
+static BfMIORequest_T *edubfm_ioTail = NULL;
+static pthread_t edubfm_ioThread[BFM_IO_MAXTHREADS];
+static Four edubfm_ioNThreads = 0;              /* # of worker threads; 0 if synchronous */
+static Boolean edubfm_ioStop = FALSE;           /* TRUE while the workers are being stopped */
+
+
+
+/*@================================
+ * edubfm_DoIO()
+ *================================*/
+/*
+ * Function: static void edubfm_DoIO(BfMIORequest_T*)
+ *
+ * Description:
+ *  Do a request through the current backend and mark it done.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_DoIO(
+    BfMIORequest_T      *req)           /* INOUT request to do */
+{
+    if (req->op == BFM_IO_READ)
+        req->status = BFM_STORAGE_READ(&req->trainId, req->buf, req->nPages);
+    else
+        req->status = BFM_STORAGE_WRITE(&req->trainId, req->buf, req->nPages);
+
+}  /* edubfm_DoIO() */
+
+
+
+/*@================================
+ * edubfm_IOWorker()
+ *================================*/
+/*
+ * Function: static void *edubfm_IOWorker(void*)
+ *
+ * Description:
+ *  Main loop of a worker thread; take a request from the queue, do it,
+ *  and wake up the waiters, until the engine is stopped. RDsM is not
+ *  called for the requests with deferVolume set (see edubfm_VolumeRead()).
+ *
+ * Returns:
+ *  NULL
+ */
+static void *edubfm_IOWorker(
+    void                *arg)           /* IN not used */
+{
+    BfMIORequest_T      *req;           /* request taken */
+
+
+    pthread_mutex_lock(&edubfm_ioLatch);
+    for (;;) {
+        while (edubfm_ioHead == NULL && !edubfm_ioStop)
+            pthread_cond_wait(&edubfm_ioWork, &edubfm_ioLatch);
+        if (edubfm_ioHead == NULL) break;
+
+        req = edubfm_ioHead;
+        edubfm_ioHead = req->next;
+        if (edubfm_ioHead == NULL) edubfm_ioTail = NULL;
+        pthread_mutex_unlock(&edubfm_ioLatch);
+
+        edubfm_deferVolumeIO = req->deferVolume;
+        edubfm_DoIO(req);
+        edubfm_deferVolumeIO = FALSE;
+
+        pthread_mutex_lock(&edubfm_ioLatch);
+        __atomic_store_n(&req->done, TRUE, __ATOMIC_RELEASE);
+        pthread_cond_broadcast(&edubfm_ioDone);
+    }
+    pthread_mutex_unlock(&edubfm_ioLatch);
+
+    return(NULL);
+
+}  /* edubfm_IOWorker() */
+
+
+
+/*@================================
+ * edubfm_SubmitIO()
+ *================================*/
+/*
+ * Function: Four edubfm_SubmitIO(BfMIORequest_T*, Four)
+ *
+ * Description:
+ *  Submit a batch of nReqs requests. The caller fills in op, trainId, buf,
+ *  nPages and deferVolume of each request, and must wait for all of them
+ *  with edubfm_WaitIO() before it returns to its caller, unless all of them
+ *  have deferVolume set; the requests and the buffers must stay valid
+ *  until they are waited for.
+ *  If the engine has no worker thread, the requests are done here; those
+ *  on striped volumes are done together if the file backend is used
+ *  without delay.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad # of requests
+ */
+Four edubfm_SubmitIO(
+    BfMIORequest_T      *reqs,          /* INOUT requests to submit */
+    Four                nReqs)          /* IN # of requests */
+{
+    Four                i;              /* index */
+
+
+    if (nReqs < 0 || nReqs > BFM_IO_MAXBATCH) ERR(eBADPARAMETER_EDUBFM);
+
+    for (i = 0; i < nReqs; i++) {
+        reqs[i].done = FALSE;
+        reqs[i].next = (i + 1 < nReqs) ? &reqs[i+1] : NULL;
+    }
+
+    if (edubfm_ioNThreads == 0) {
+        if (edubfm_IsFileStorage()) edubfm_StripedBatch(reqs, nReqs);
+
+        for (i = 0; i < nReqs; i++) {
+            if (reqs[i].done) continue;
+            edubfm_DoIO(&reqs[i]);
+            reqs[i].done = TRUE;
+        }
+        return(eNOERROR);
+    }
+
+    if (nReqs == 0) return(eNOERROR);
+
+    /*@ append the batch to the queue at once */
+    pthread_mutex_lock(&edubfm_ioLatch);
+    if (edubfm_ioTail == NULL)
+        edubfm_ioHead = &reqs[0];
+    else
+        edubfm_ioTail->next = &reqs[0];
+    edubfm_ioTail = &reqs[nReqs-1];
+    pthread_cond_broadcast(&edubfm_ioWork);
+    pthread_mutex_unlock(&edubfm_ioLatch);
+
+    return(eNOERROR);
+
+}  /* edubfm_SubmitIO() */
+
+
+
+/*@================================
+ * edubfm_PollIO()
+ *================================*/
+/*
+ * Function: Boolean edubfm_PollIO(BfMIORequest_T*)
+ *
+ * Description:
+ *  Check whether a request submitted is done, without waiting.
+ *
+ * Returns:
+ *  TRUE if the request is done, FALSE otherwise
+ */
+Boolean edubfm_PollIO(
+    BfMIORequest_T      *req)           /* IN request submitted */
+{
+    return(__atomic_load_n(&req->done, __ATOMIC_ACQUIRE) ? TRUE : FALSE);
+
+}  /* edubfm_PollIO() */
+
+
+
+/*@================================
+ * edubfm_WaitIO()
+ *================================*/
+/*
+ * Function: Four edubfm_WaitIO(BfMIORequest_T*)
+ *
+ * Description:
+ *  Wait until a request submitted is done.
+ *
+ * Returns:
+ *  error code of the request
+ */
+Four edubfm_WaitIO(
+    BfMIORequest_T      *req)           /* IN request submitted */
+{
+    if (!edubfm_PollIO(req)) {
+        pthread_mutex_lock(&edubfm_ioLatch);
+        while (!req->done)
+            pthread_cond_wait(&edubfm_ioDone, &edubfm_ioLatch);
+        pthread_mutex_unlock(&edubfm_ioLatch);
+    }
+
+    return(req->status);
+
+}  /* edubfm_WaitIO() */
+
+
+
+/*@================================
+ * edubfm_StartIOEngine()
+ *================================*/
+/*
+ * Function: Four edubfm_StartIOEngine(Four)
+ *
+ * Description:
+ *  Start the given number of worker threads, stopping the running ones
+ *  first. With 0, the requests are done synchronously on submission.
+ *  No request may be in flight.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad # of threads
+ *    eTHREADCREATEFAILED_EDUBFM - a worker thread cannot be created
+ */
+Four edubfm_StartIOEngine(
+    Four                nThreads)       /* IN # of worker threads */
+{
+    Four                e;              /* for error */
+
+
+    if (nThreads < 0 || nThreads > BFM_IO_MAXTHREADS) ERR(eBADPARAMETER_EDUBFM);
+
+    e = edubfm_StopIOEngine();
+    if (e < 0) ERR(e);
+
+    for ( ; edubfm_ioNThreads < nThreads; edubfm_ioNThreads++) {
+        if (pthread_create(&edubfm_ioThread[edubfm_ioNThreads], NULL, edubfm_IOWorker, NULL) != 0) {
+            edubfm_StopIOEngine();
+            ERR(eTHREADCREATEFAILED_EDUBFM);
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_StartIOEngine() */
+
+
+
+/*@================================
+ * edubfm_StopIOEngine()
+ *================================*/
+/*
+ * Function: Four edubfm_StopIOEngine(void)
+ *
+ * Description:
+ *  Stop all the worker threads after the requests queued are done.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_StopIOEngine(void)
+{
+    Four                i;              /* index */
+
+
+    if (edubfm_ioNThreads == 0) return(eNOERROR);
+
+    pthread_mutex_lock(&edubfm_ioLatch);
+    edubfm_ioStop = TRUE;
+    pthread_cond_broadcast(&edubfm_ioWork);
+    pthread_mutex_unlock(&edubfm_ioLatch);
+
+    for (i = 0; i < edubfm_ioNThreads; i++)
+        pthread_join(edubfm_ioThread[i], NULL);
+
+    edubfm_ioNThreads = 0;
+    edubfm_ioStop = FALSE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StopIOEngine() */
+
+
+
+/*@================================
+ * edubfm_IsIOEngineRunning()
+ *================================*/
+/*
+ * Function: Boolean edubfm_IsIOEngineRunning(void)
+ *
+ * Description:
+ *  Check whether the engine has worker threads, i.e. whether a request
+ *  submitted may still be in flight when edubfm_SubmitIO() returns.
+ *
+ * Returns:
+ *  TRUE if the engine has worker threads, FALSE otherwise
+ */
+Boolean edubfm_IsIOEngineRunning(void)
+{
+    return((edubfm_ioNThreads > 0) ? TRUE : FALSE);
+
+}  /* edubfm_IsIOEngineRunning() */
@@ -0,0 +1,304 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Latch.c
+ *
+ * Description :
+ *  Latches used when the buffer pools are placed in the shared segment.
+ *  The pool latch of a buffer type protects its buffer table, hash table
+ *  and next victim; the frame latch of a buffer element protects the I/O
+ *  on the buffer element so that no process sees a half read train.
+ *  When the buffer pools are private to the process, all functions simply
+ *  return without doing anything.
+ *
+ * Exports:
+ *  Four edubfm_LatchPool(Four)
+ *  Four edubfm_UnlatchPool(Four)
+ *  Four edubfm_LatchFrame(Four, Four)
+ *  Four edubfm_UnlatchFrame(Four, Four)
+ */
+
+
+#include <errno.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* shared segment attached by EduBfM_AttachSharedPool(); NULL if not attached */
+BfMSharedSegment *edubfm_sharedSegment = NULL;
+
+/* private buffer pools of this process saved while the shared segment is attached */
+BufferInfo edubfm_privateBufInfo[NUM_BUF_TYPES];
+
+/* versions of the buffer elements of the private buffer pools */
+UFour edubfm_privateVersionTable[NUM_BUF_TYPES][BFM_MAXNBUFS];
+
+/* versions of the buffer elements in use; in the shared segment while it is attached */
+UFour *edubfm_versionTable[NUM_BUF_TYPES] = { edubfm_privateVersionTable[0], edubfm_privateVersionTable[1] };
+
+/* name of the attached shared segment */
+char edubfm_sharedSegmentName[BFM_SHAREDSEGMENT_NAMELEN];
+
+/* # of fixes held by the threads of this process; no train may be fixed when the segment is detached */
+Four edubfm_nFixed = 0;
+
+
+/*@================================
+ * edubfm_AcquireLatch()
+ *================================*/
+/*
+ * Function: static Four edubfm_AcquireLatch(pthread_mutex_t*)
+ *
+ * Description :
+ *  Acquire a process-shared latch. The latches are robust mutexes; if the
+ *  previous holder died while holding it, it may have left the buffer
+ *  table, the hash table or a buffer half changed, which cannot be
+ *  repaired. The shared segment is then marked suspect and the latch is
+ *  made consistent and released, and every later acquisition fails, so
+ *  the processes can only detach the segment.
+ *
+ * Returns:
+ *  error code
+ *    eSHAREDPOOLSUSPECT_EDUBFM - a process died holding a latch of the segment
+ *    eMUTEXLOCKDEADLK_BFM - the caller already holds the latch
+ *    eMUTEXLOCKUNKNOWN_BFM - unknown error
+ */
+static Four edubfm_AcquireLatch(
+    pthread_mutex_t     *latch)         /* IN latch to acquire */
+{
+    Four                rc;             /* return code of pthread calls */
+
+
+    rc = pthread_mutex_lock(latch);
+    if (rc == EOWNERDEAD) {
+        edubfm_sharedSegment->suspect = TRUE;
+        if (pthread_mutex_consistent(latch) == 0) pthread_mutex_unlock(latch);
+        ERR(eSHAREDPOOLSUSPECT_EDUBFM);
+    }
+
+    if (rc == EDEADLK) ERR(eMUTEXLOCKDEADLK_BFM);
+    if (rc != 0) ERR(eMUTEXLOCKUNKNOWN_BFM);
+
+    if (edubfm_sharedSegment->suspect) {
+        pthread_mutex_unlock(latch);
+        ERR(eSHAREDPOOLSUSPECT_EDUBFM);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_AcquireLatch() */
+
+
+
+/*@================================
+ * edubfm_ReleaseLatch()
+ *================================*/
+/*
+ * Function: static Four edubfm_ReleaseLatch(pthread_mutex_t*)
+ *
+ * Description :
+ *  Release a process-shared latch.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXUNLOCKPERM_BFM - the caller does not hold the latch
+ *    eMUTEXUNLOCKUNKNOWN_BFM - unknown error
+ */
+static Four edubfm_ReleaseLatch(
+    pthread_mutex_t     *latch)         /* IN latch to release */
+{
+    Four                rc;             /* return code of pthread calls */
+
+
+    rc = pthread_mutex_unlock(latch);
+    if (rc == EPERM) ERR(eMUTEXUNLOCKPERM_BFM);
+    if (rc != 0) ERR(eMUTEXUNLOCKUNKNOWN_BFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_ReleaseLatch() */
+
+
+
+/*@================================
+ * edubfm_LatchPool()
+ *================================*/
+/*
+ * Function: Four edubfm_LatchPool(Four)
+ *
+ * Description :
+ *  Acquire the pool latch of the given buffer type.
+ *  When several pool latches are needed, they must be acquired in the
+ *  increasing order of the buffer type.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    some errors caused by function calls
+ */
+Four edubfm_LatchPool(
+    Four                type)           /* IN buffer type */
+{
+    Four                e;              /* for error */
+
+
+    if (!IS_SHARED_BUFFERPOOL()) return(eNOERROR);
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    e = edubfm_AcquireLatch(&(edubfm_sharedSegment->pool[type].poolLatch));
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_LatchPool() */
+
+
+
+/*@================================
+ * edubfm_UnlatchPool()
+ *================================*/
+/*
+ * Function: Four edubfm_UnlatchPool(Four)
+ *
+ * Description :
+ *  Release the pool latch of the given buffer type.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    some errors caused by function calls
+ */
+Four edubfm_UnlatchPool(
+    Four                type)           /* IN buffer type */
+{
+    Four                e;              /* for error */
+
+
+    if (!IS_SHARED_BUFFERPOOL()) return(eNOERROR);
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    e = edubfm_ReleaseLatch(&(edubfm_sharedSegment->pool[type].poolLatch));
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_UnlatchPool() */
+
+
+
+/*@================================
+ * edubfm_LatchFrame()
+ *================================*/
+/*
+ * Function: Four edubfm_LatchFrame(Four, Four)
+ *
+ * Description :
+ *  Acquire the latch of a buffer element.
+ *  A process reading a train into a buffer element holds the frame latch
+ *  until the read is done; other processes fixing the same train wait on
+ *  it after they release the pool latch.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eBADBUFINDEX_BFM - bad index value for buffer table
+ *    some errors caused by function calls
+ */
+Four edubfm_LatchFrame(
+    Four                type,           /* IN buffer type */
+    Four                index)          /* IN index of the buffer element */
+{
+    Four                e;              /* for error */
+
+
+    if (!IS_SHARED_BUFFERPOOL()) return(eNOERROR);
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+    if (index < 0 || index >= BI_NBUFS(type)) ERR(eBADBUFINDEX_BFM);
+
+    e = edubfm_AcquireLatch(BI_FRAMELATCH(type, index));
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_LatchFrame() */
+
+
+
+/*@================================
+ * edubfm_UnlatchFrame()
+ *================================*/
+/*
+ * Function: Four edubfm_UnlatchFrame(Four, Four)
+ *
+ * Description :
+ *  Release the latch of a buffer element.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eBADBUFINDEX_BFM - bad index value for buffer table
+ *    some errors caused by function calls
+ */
+Four edubfm_UnlatchFrame(
+    Four                type,           /* IN buffer type */
+    Four                index)          /* IN index of the buffer element */
+{
+    Four                e;              /* for error */
+
+
+    if (!IS_SHARED_BUFFERPOOL()) return(eNOERROR);
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+    if (index < 0 || index >= BI_NBUFS(type)) ERR(eBADBUFINDEX_BFM);
+
+    e = edubfm_ReleaseLatch(BI_FRAMELATCH(type, index));
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_UnlatchFrame() */
@@ -0,0 +1,576 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_ReadAhead.c
+ *
+ * Description:
+ *  Detect sequential accesses and read the following trains ahead
+ *  into the buffer pool.
+ *  Read-ahead is done at best effort; its errors are returned without
+ *  being printed, and the caller goes on without the trains.
+ *  With the worker threads of the I/O engine, the reads of a window are
+ *  left in flight and completed by the first reference of each train, by
+ *  edubfm_CompleteReadAhead(), or all at once by edubfm_DrainReadAhead().
+ *
+ * Exports:
+ *  Four edubfm_ReadAhead(TrainID *, Four)
+ *  Four edubfm_CompleteReadAhead(Four, Four)
+ *  void edubfm_DrainReadAhead(void)
+ */
+
+
+#include <pthread.h>
+#include "EduBfM_common.h"
+#include "RM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * type definitions
+ */
+/* reads of a window left in flight */
+typedef struct {
+    Four                nReqs;          /* # of reads; 0 if the entry is free */
+    Four                nLeft;          /* # of reads not completed yet */
+    Four                type;           /* buffer type */
+    BfMIORequest_T      req[BFM_RA_MAXWINDOW];          /* reads */
+    Four                index[BFM_RA_MAXWINDOW];        /* buffers of the reads */
+    Boolean             completed[BFM_RA_MAXWINDOW];    /* TRUE if the read is completed */
+} edubfm_RaBatch_T;
+
+
+
+/*@
+ * global variables
+ */
+/* maximum window of read-ahead (unit: # of trains); 0 disables read-ahead */
+Four edubfm_raMaxWindow = 0;
+
+/* statistics of read-ahead */
+BfMReadAheadStat edubfm_raStat;
+
+/* protects the detectors and the reads in flight among the threads of the process */
+static pthread_mutex_t edubfm_raLatch = PTHREAD_MUTEX_INITIALIZER;
+
+/* detectors of sequential accesses */
+static BfMReadAheadDetector edubfm_raDetector[BFM_RA_NDETECTORS];
+static Four edubfm_raNextDetector = 0;
+static Boolean edubfm_raInitialized = FALSE;
+
+/* windows whose reads are in flight */
+static edubfm_RaBatch_T edubfm_raBatch[BFM_RA_MAXBATCHES];
+
+
+
+/*@================================
+ * edubfm_GetDetector()
+ *================================*/
+/*
+ * Function: static BfMReadAheadDetector *edubfm_GetDetector(VolNo, Four)
+ *
+ * Description:
+ *  Return the detector tracking the given volume and buffer type.
+ *  If there is none, the detectors are reused in round robin.
+ *  The caller holds edubfm_raLatch.
+ *
+ * Returns:
+ *  pointer to the detector
+ */
+static BfMReadAheadDetector *edubfm_GetDetector(
+    VolNo               volNo,          /* IN volume accessed */
+    Four                type)           /* IN buffer type */
+{
+    BfMReadAheadDetector *det;          /* detector to return */
+    Four                i;              /* index */
+
+
+    if (!edubfm_raInitialized) {
+        for (i = 0; i < BFM_RA_NDETECTORS; i++)
+            edubfm_raDetector[i].volNo = NIL;
+        edubfm_raInitialized = TRUE;
+    }
+
+    for (i = 0; i < BFM_RA_NDETECTORS; i++) {
+        det = &edubfm_raDetector[i];
+        if (det->volNo == volNo && det->type == type) return(det);
+    }
+
+    det = &edubfm_raDetector[edubfm_raNextDetector];
+    edubfm_raNextDetector = (edubfm_raNextDetector + 1) % BFM_RA_NDETECTORS;
+
+    det->volNo = volNo;
+    det->type = type;
+    det->lastPageNo = NIL;
+    det->raEndPageNo = NIL;
+    det->runLength = 0;
+    det->window = 0;
+
+    return(det);
+
+}  /* edubfm_GetDetector() */
+
+
+
+/*@================================
+ * edubfm_BeginPrefetch()
+ *================================*/
+/*
+ * Function: static Four edubfm_BeginPrefetch(TrainID *, Four, Four *)
+ *
+ * Description:
+ *  Allocate a buffer for a train to read ahead, unless the train is
+ *  already in the buffer pool or every buffer is fixed, in which case no
+ *  victim could be found. The buffer is fixed and marked READING, and in
+ *  the shared pool its frame latch is held, until edubfm_EndPrefetch() is
+ *  called after the read; this is the same protocol as EduBfM_GetTrain().
+ *
+ * Returns:
+ *  error code
+ *    eNOUNFIXEDBUF_BFM - every buffer is fixed
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter index
+ *     index of the buffer allocated; NIL if the train is in the pool
+ */
+static Four edubfm_BeginPrefetch(
+    TrainID             *trainId,       /* IN train to read ahead */
+    Four                type,           /* IN buffer type */
+    Four                *index)         /* OUT index of the buffer allocated */
+{
+    Four                e;              /* for error */
+    Four                i;              /* index of the buffer pool */
+
+
+    *index = NIL;
+
+    e = edubfm_LatchPool(type);
+    if (e < 0) return(e);
+
+    if (edubfm_LookUp((BfMHashKey*)trainId, type) != NOTFOUND_IN_HTABLE) {
+        e = edubfm_UnlatchPool(type);
+        if (e < 0) return(e);
+        return(eNOERROR);
+    }
+
+    for (i = 0; i < BI_NBUFS(type) && BI_FIXED(type, i) > 0; i++);
+    if (i == BI_NBUFS(type)) {
+        edubfm_UnlatchPool(type);
+        return(eNOUNFIXEDBUF_BFM);
+    }
+
+    i = edubfm_AllocTrain(type);
+    if (i < 0) {
+        edubfm_UnlatchPool(type);
+        return(i);
+    }
+    BI_BEGINCHANGE(type, i);
+    BI_KEY(type, i) = *((BfMHashKey*)trainId);
+    e = edubfm_Insert((BfMHashKey*)trainId, i, type);
+    if (e < 0) {
+        SET_NILBFMHASHKEY(BI_KEY(type, i));
+        BI_ENDCHANGE(type, i);
+        edubfm_UnlatchPool(type);
+        return(e);
+    }
+    BI_FIXED(type, i)++;
+    BI_BITS(type, i) = READING;
+
+    e = edubfm_LatchFrame(type, i);
+    if (e < 0) {
+        edubfm_UnlatchPool(type);
+        return(e);
+    }
+    e = edubfm_UnlatchPool(type);
+    if (e < 0) return(e);
+
+    *index = i;
+
+    return(eNOERROR);
+
+}  /* edubfm_BeginPrefetch() */
+
+
+
+/*@================================
+ * edubfm_EndPrefetch()
+ *================================*/
+/*
+ * Function: static void edubfm_EndPrefetch(TrainID *, Four, Four, Four)
+ *
+ * Description:
+ *  Finish reading a train ahead into the buffer allocated by
+ *  edubfm_BeginPrefetch(). If the read succeeded, the buffer is marked
+ *  PREFETCH to count whether it is referenced, and REFER so that it
+ *  survives the next round of the replacement until the reader reaches
+ *  it; otherwise the train is removed from the buffer pool.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_EndPrefetch(
+    TrainID             *trainId,       /* IN train read ahead */
+    Four                type,           /* IN buffer type */
+    Four                index,          /* IN index of the buffer */
+    Four                status)         /* IN error code of the read */
+{
+    edubfm_LatchPool(type);
+    if (status < 0) {
+        edubfm_Delete((BfMHashKey*)trainId, type);
+        SET_NILBFMHASHKEY(BI_KEY(type, index));
+        BI_BITS(type, index) = ALL_0;
+    }
+    else {
+        BI_BITS(type, index) = PREFETCH | REFER;
+        edubfm_raStat.nPrefetched++;
+    }
+    BI_ENDCHANGE(type, index);
+    BI_FIXED(type, index)--;
+    edubfm_UnlatchPool(type);
+    edubfm_UnlatchFrame(type, index);
+
+}  /* edubfm_EndPrefetch() */
+
+
+
+/*@================================
+ * edubfm_FinishRead()
+ *================================*/
+/*
+ * Function: static void edubfm_FinishRead(edubfm_RaBatch_T *, Four)
+ *
+ * Description:
+ *  Wait for a read left in flight and finish it by edubfm_EndPrefetch().
+ *  A read which the worker could not do without RDsM is redone here.
+ *  The entry of the window is freed with its last read. The caller holds
+ *  edubfm_raLatch.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_FinishRead(
+    edubfm_RaBatch_T    *batch,         /* INOUT window of the read */
+    Four                i)              /* IN index of the read in the window */
+{
+    BfMIORequest_T      *req = &batch->req[i];  /* read to finish */
+    Four                status;         /* error code of the read */
+
+
+    status = edubfm_WaitIO(req);
+    if (status == eVOLUMEIODEFERRED_EDUBFM)
+        status = BFM_STORAGE_READ(&req->trainId, req->buf, req->nPages);
+
+    edubfm_EndPrefetch(&req->trainId, batch->type, batch->index[i], status);
+
+    batch->completed[i] = TRUE;
+    if (--batch->nLeft == 0) batch->nReqs = 0;
+
+}  /* edubfm_FinishRead() */
+
+
+
+/*@================================
+ * edubfm_CompleteReadAhead()
+ *================================*/
+/*
+ * Function: Four edubfm_CompleteReadAhead(Four, Four)
+ *
+ * Description:
+ *  Complete the read ahead into the given buffer, if this process left it
+ *  in flight. EduBfM_GetTrain() calls this, out of the pool latch, for
+ *  the first reference of a buffer marked READING. If the read failed,
+ *  the train is removed from the buffer pool; the caller finds another
+ *  key in the buffer and retries.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_CompleteReadAhead(
+    Four                type,           /* IN buffer type */
+    Four                index)          /* IN index of the buffer */
+{
+    edubfm_RaBatch_T    *batch;         /* window in flight */
+    Four                b, i;           /* indexes */
+
+
+    pthread_mutex_lock(&edubfm_raLatch);
+
+    for (b = 0; b < BFM_RA_MAXBATCHES; b++) {
+        batch = &edubfm_raBatch[b];
+        if (batch->nReqs == 0 || batch->type != type) continue;
+
+        for (i = 0; i < batch->nReqs; i++)
+            if (!batch->completed[i] && batch->index[i] == index) {
+                edubfm_FinishRead(batch, i);
+                pthread_mutex_unlock(&edubfm_raLatch);
+                return(eNOERROR);
+            }
+    }
+
+    pthread_mutex_unlock(&edubfm_raLatch);
+
+    return(eNOERROR);
+
+}  /* edubfm_CompleteReadAhead() */
+
+
+
+/*@================================
+ * edubfm_DrainReadAhead()
+ *================================*/
+/*
+ * Function: void edubfm_DrainReadAhead(void)
+ *
+ * Description:
+ *  Complete all the reads left in flight by this process. This is called
+ *  before the buffer pool, the backend or the I/O engine is changed, and
+ *  by EduBfM_FlushAll() and EduBfM_DiscardAll().
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_DrainReadAhead(void)
+{
+    edubfm_RaBatch_T    *batch;         /* window in flight */
+    Four                b, i;           /* indexes */
+    Four                nReqs;          /* # of reads of the window */
+
+
+    pthread_mutex_lock(&edubfm_raLatch);
+
+    for (b = 0; b < BFM_RA_MAXBATCHES; b++) {
+        batch = &edubfm_raBatch[b];
+        for (nReqs = batch->nReqs, i = 0; i < nReqs; i++)
+            if (!batch->completed[i]) edubfm_FinishRead(batch, i);
+    }
+
+    pthread_mutex_unlock(&edubfm_raLatch);
+
+}  /* edubfm_DrainReadAhead() */
+
+
+
+/*@================================
+ * edubfm_ReadAhead()
+ *================================*/
+/*
+ * Function: Four edubfm_ReadAhead(TrainID *, Four)
+ *
+ * Description:
+ *  Feed an access to the detector and read the following trains ahead
+ *  if the access continues a sequential run.
+ *  EduBfM_GetTrain() calls this after the requested train is fixed, for
+ *  a miss or for the first reference of a train read ahead; the hits on
+ *  other trains do not change the detector.
+ *  The buffers for the whole window are allocated first, and the reads
+ *  are submitted to the I/O engine in one batch. Since they stay fixed
+ *  until the reads are done, the window is limited to the number of the
+ *  unfixed buffers, and it is cut short when no buffer is left.
+ *  If the engine has worker threads, the buffer pool is private, the
+ *  volume is striped or compressed and half of the buffers would stay
+ *  unfixed, the reads are left in flight and
+ *  this returns right after submitting them; each buffer is completed by
+ *  the first reference of its train (see edubfm_CompleteReadAhead()).
+ *  The workers then read only the device files and the side file; a
+ *  train still in the volume is read when it is completed, as RDsM may
+ *  be used by the caller meanwhile. Otherwise, the reads are waited for
+ *  here; in the shared pool, the frame latches held on the buffers can
+ *  only be released by this thread.
+ *  Read-ahead is done only while it is enabled by EduBfM_SetReadAhead().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_ReadAhead(
+    TrainID             *trainId,       /* IN train accessed */
+    Four                type)           /* IN buffer type */
+{
+    Four                e;              /* for error */
+    BfMReadAheadDetector *det;          /* detector of the volume */
+    Four                stride;         /* distance of consecutive trains */
+    Four                maxWindow;      /* maximum window for the buffer pool */
+    TrainID             raTrainId;      /* train to read ahead */
+    PageNo              endPageNo;      /* last train number to read ahead */
+    PageNo              windowEndPageNo;    /* last train number of the window */
+    BfMIORequest_T      waitedReq[BFM_RA_MAXWINDOW];    /* reads of the window waited for here */
+    Four                waitedIndex[BFM_RA_MAXWINDOW];  /* buffers of the reads */
+    BfMIORequest_T      *req;           /* reads of the window */
+    Four                *index;         /* buffers of the reads */
+    edubfm_RaBatch_T    *batch;         /* entry of the window if left in flight; NULL otherwise */
+    Four                nReqs;          /* # of reads */
+    Four                nUnfixed;       /* # of unfixed buffers */
+    Four                i;              /* index */
+
+
+    if (edubfm_raMaxWindow <= 0) return(eNOERROR);
+
+	/* Error check whether using not supported functionality by EduBfM */
+	if (RM_IS_ROLLBACK_REQUIRED()) return(eNOTSUPPORTED_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_raLatch);
+
+    det = edubfm_GetDetector(trainId->volNo, type);
+    stride = BI_BUFSIZE(type);
+
+    if (det->lastPageNo != NIL && trainId->pageNo == det->lastPageNo + stride) {
+        det->runLength++;
+    }
+    else {
+        /* random access; collapse the window */
+        det->runLength = 1;
+        det->window = 0;
+        det->raEndPageNo = NIL;
+    }
+    det->lastPageNo = trainId->pageNo;
+
+    if (det->runLength < BFM_RA_MINRUN) {
+        pthread_mutex_unlock(&edubfm_raLatch);
+        return(eNOERROR);
+    }
+
+    maxWindow = BI_NBUFS(type) / 2;
+    if (edubfm_raMaxWindow < maxWindow) maxWindow = edubfm_raMaxWindow;
+    if (BFM_RA_MAXWINDOW < maxWindow) maxWindow = BFM_RA_MAXWINDOW;
+    for (nUnfixed = 0, i = 0; i < BI_NBUFS(type); i++)
+        if (BI_FIXED(type, i) == 0) nUnfixed++;
+    if (nUnfixed < maxWindow) maxWindow = nUnfixed;
+    det->window = (det->window == 0) ? BFM_RA_INITWINDOW : det->window * 2;
+    if (det->window > maxWindow) det->window = maxWindow;
+
+    raTrainId.volNo = trainId->volNo;
+    raTrainId.pageNo = trainId->pageNo + stride;
+    if (det->raEndPageNo != NIL && det->raEndPageNo >= raTrainId.pageNo)
+        raTrainId.pageNo = det->raEndPageNo + stride;
+    endPageNo = windowEndPageNo = trainId->pageNo + det->window * stride;
+
+    /* the other threads go on after this window */
+    if (det->raEndPageNo == NIL || det->raEndPageNo < endPageNo) det->raEndPageNo = endPageNo;
+
+    /*@ leave the reads in flight if possible; half of the buffers are left to the caller */
+    batch = NULL;
+    if (!IS_SHARED_BUFFERPOOL() && edubfm_IsIOEngineRunning() &&
+        nUnfixed - det->window >= BI_NBUFS(type) / 2 &&
+        (edubfm_IsStripedVolume(trainId->volNo) || edubfm_IsCompressedVolume(trainId->volNo))) {
+        for (i = 0; i < BFM_RA_MAXBATCHES; i++)
+            if (edubfm_raBatch[i].nReqs == 0) {
+                batch = &edubfm_raBatch[i];
+                break;
+            }
+    }
+    if (batch != NULL) {
+        req = batch->req;
+        index = batch->index;
+    }
+    else {
+        req = waitedReq;
+        index = waitedIndex;
+        pthread_mutex_unlock(&edubfm_raLatch);
+    }
+
+    /*@ allocate the buffers of the window */
+    nReqs = 0;
+    e = eNOERROR;
+    for ( ; raTrainId.pageNo <= endPageNo; raTrainId.pageNo += stride) {
+        e = edubfm_BeginPrefetch(&raTrainId, type, &index[nReqs]);
+        if (e == eNOUNFIXEDBUF_BFM) {
+            /* read the rest when the buffers are unfixed */
+            e = eNOERROR;
+            endPageNo = raTrainId.pageNo - stride;
+            break;
+        }
+        if (e < 0) break;
+        if (index[nReqs] == NIL) continue;
+
+        req[nReqs].op = BFM_IO_READ;
+        req[nReqs].trainId = raTrainId;
+        req[nReqs].buf = BI_BUFFER(type, index[nReqs]);
+        req[nReqs].nPages = BI_BUFSIZE(type);
+        req[nReqs].deferVolume = (batch != NULL) ? TRUE : FALSE;
+        nReqs++;
+    }
+
+    /*@ read them in a batch; the batch never exceeds BFM_IO_MAXBATCH */
+    if (batch != NULL) {
+        for (i = 0; i < nReqs; i++) batch->completed[i] = FALSE;
+        batch->type = type;
+        batch->nReqs = batch->nLeft = nReqs;
+        (void) edubfm_SubmitIO(req, nReqs);
+        edubfm_raStat.nAsync += nReqs;
+    }
+    else {
+        (void) edubfm_SubmitIO(req, nReqs);
+        for (i = 0; i < nReqs; i++) {
+            edubfm_EndPrefetch(&req[i].trainId, type, index[i], edubfm_WaitIO(&req[i]));
+            if (req[i].status < 0 && e >= 0) e = req[i].status;
+        }
+
+        pthread_mutex_lock(&edubfm_raLatch);
+    }
+
+    /* the detector may have been given to another volume meanwhile */
+    if (det->volNo == trainId->volNo && det->type == type) {
+        if (e < 0) {
+            /* e.g. the end of the volume; stop until the next run */
+            det->runLength = 0;
+            det->window = 0;
+            det->raEndPageNo = NIL;
+        }
+        else if (endPageNo < windowEndPageNo && det->raEndPageNo == windowEndPageNo)
+            det->raEndPageNo = endPageNo;       /* cut short */
+    }
+
+    pthread_mutex_unlock(&edubfm_raLatch);
+
+    if (e < 0) return(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_ReadAhead() */
@@ -79,6 +79,8 @@
  *  when RDsM_ReadTrain() is called, simply return it.  The function has
  *  no code for checking input parameters since this will be done RDsM,
  *  especially RDsM_ReadTrain().
+ *  The train is read through the current storage backend (see
+ *  edubfm_Storage.c), which calls RDsM_ReadTrain() by default.
  *
  * Returns;
  *  error code
@@ -100,7 +102,7 @@ Four edubfm_ReadTrain(
 	if (RM_IS_ROLLBACK_REQUIRED()) ERR(eNOTSUPPORTED_EDUBFM);
     if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
 
-    e = RDsM_ReadTrain(trainId, aTrain, BI_BUFSIZE(type));
+    e = BFM_STORAGE_READ(trainId, aTrain, BI_BUFSIZE(type));
     if ( e < 0 ) ERR( e );
 
     return( eNOERROR );
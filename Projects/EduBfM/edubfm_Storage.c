@@ -0,0 +1,905 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Storage.c
+ *
+ * Description:
+ *  Storage backends under the buffer manager.
+ *  - file backend: the volume devices through RDsM_ReadTrain() and
+ *    RDsM_WriteTrain(); the default. RDsM is not reentrant and owns the
+ *    file descriptors of the volumes, so its calls are serialized by a
+ *    latch and never overlap, even with the worker threads of the I/O
+ *    engine. The trains of a compressed volume go to its side file
+ *    instead (see edubfm_Compress.c), and those of a striped volume to
+ *    its device files (see edubfm_Stripe.c); these are read and written
+ *    by edubfm_FileIO() outside the latch.
+ *  - RAM backend: keeps the pages written in the memory of the process;
+ *    a page never written is read from the file backend once. Nothing
+ *    written reaches the volume, so it is for benchmarks only; the pages
+ *    kept are freed when the backend stops being used and at exit.
+ *  - delay backend: wraps another backend and emulates devices with one
+ *    queue each, as SSDs and HDDs seen through one channel: each I/O
+ *    takes the latency plus the transfer time at the given bandwidth,
+ *    after the I/Os queued before it on its device, so that concurrent
+ *    I/Os share the bandwidth of a device instead of overlapping their
+ *    delays. The volumes share one device, and the device files of a
+ *    striped volume have one device each, so that striping pays off as
+ *    it would on separate disks.
+ *
+ * Exports:
+ *  BfMStorage_T *edubfm_storage
+ *  Four edubfm_SetStorage(Four, Four, Four)
+ *  __thread Boolean edubfm_deferVolumeIO
+ *  Four edubfm_VolumeRead(TrainID *, char *, Two)
+ *  Four edubfm_VolumeWrite(TrainID *, char *, Two)
+ *  Four edubfm_RecordVolumeMode(VolNo, char *, Four)
+ *  Four edubfm_CheckVolumeMode(VolNo)
+ *  Boolean edubfm_IsRamStorage(void)
+ *  Boolean edubfm_IsFileStorage(void)
+ */
+
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "EduBfM_common.h"
+#include "RDsM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * type definitions
+ */
+/* a page kept by the RAM backend */
+typedef struct edubfm_RamPage_T_tag {
+    BfMHashKey                      key;        /* page kept */
+    struct edubfm_RamPage_T_tag     *next;      /* next page in the bucket */
+    char                            data[PAGESIZE];
+} edubfm_RamPage_T;
+
+/* private data of the RAM backend */
+typedef struct {
+    pthread_mutex_t     latch;          /* protects the buckets */
+    edubfm_RamPage_T    *bucket[BFM_RAMSTORAGE_NBUCKETS];
+} edubfm_RamStorageData_T;
+
+/* modes of a volume read from its meta dictionary */
+typedef struct {
+    VolNo               volNo;          /* volume; NIL if unused */
+    Four                compressed;     /* TRUE if recorded as compressed */
+    Four                nDevices;       /* # of devices recorded; 0 if not striped */
+} edubfm_VolumeMode_T;
+
+/* private data of the delay backend */
+typedef struct {
+    Four                latency;        /* latency per I/O (usec) */
+    Four                bandwidth;      /* bandwidth (KB/sec); 0 if unlimited */
+    pthread_mutex_t     latch;          /* protects busyUntil */
+    long long           busyUntil[BFM_DELAY_NDEVICES];  /* when the I/Os queued on a device are done (usec) */
+} edubfm_DelayStorageData_T;
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: BFM_RAMSTORAGE_HASH(k)
+ * Description: return the bucket of the RAM backend for the key
+ */
+#define BFM_RAMSTORAGE_HASH(k)  ((((UFour)(k)->volNo << 20) ^ (UFour)(k)->pageNo) % BFM_RAMSTORAGE_NBUCKETS)
+
+
+/*@
+ * function prototypes
+ */
+static Four edubfm_FileRead(BfMStorage_T *, TrainID *, char *, Two);
+static Four edubfm_FileWrite(BfMStorage_T *, TrainID *, char *, Two);
+static Four edubfm_RamRead(BfMStorage_T *, TrainID *, char *, Two);
+static Four edubfm_RamWrite(BfMStorage_T *, TrainID *, char *, Two);
+static Four edubfm_DelayRead(BfMStorage_T *, TrainID *, char *, Two);
+static Four edubfm_DelayWrite(BfMStorage_T *, TrainID *, char *, Two);
+static void edubfm_RamRelease(void);
+
+
+/*@
+ * global variables
+ */
+static pthread_mutex_t edubfm_fileLatch = PTHREAD_MUTEX_INITIALIZER;   /* serializes the calls to RDsM */
+static edubfm_RamStorageData_T edubfm_ramStorageData = { PTHREAD_MUTEX_INITIALIZER, { NULL } };
+static edubfm_DelayStorageData_T edubfm_delayStorageData = { 0, 0, PTHREAD_MUTEX_INITIALIZER, { 0 } };
+
+static pthread_mutex_t edubfm_volumeModeLatch = PTHREAD_MUTEX_INITIALIZER;  /* protects edubfm_volumeMode */
+static edubfm_VolumeMode_T edubfm_volumeMode[BFM_MODE_MAXVOLUMES];
+static Four edubfm_nVolumeModes = 0;    /* # of entries of edubfm_volumeMode used */
+
+static BfMStorage_T edubfm_fileStorage =
+    { "file", edubfm_FileRead, edubfm_FileWrite, NULL, NULL };
+static BfMStorage_T edubfm_ramStorage =
+    { "ram", edubfm_RamRead, edubfm_RamWrite, &edubfm_fileStorage, &edubfm_ramStorageData };
+static BfMStorage_T edubfm_delayStorage =
+    { "delay", edubfm_DelayRead, edubfm_DelayWrite, NULL, &edubfm_delayStorageData };
+
+/* current backend */
+BfMStorage_T *edubfm_storage = &edubfm_fileStorage;
+
+/* TRUE while a worker does a read left in flight by the read-ahead; RDsM must not be called */
+__thread Boolean edubfm_deferVolumeIO = FALSE;
+
+
+
+/*@================================
+ * edubfm_VolumeRead()
+ *================================*/
+/*
+ * Function: Four edubfm_VolumeRead(TrainID*, char*, Two)
+ *
+ * Description:
+ *  Read nPages pages from the volume device by RDsM_ReadTrain(), bypassing
+ *  the side file and the device files. RDsM is not reentrant, so the
+ *  worker threads of the I/O engine call it one at a time, and not at all
+ *  for the reads which the read-ahead leaves in flight, since the caller
+ *  may then be using RDsM directly; these are failed without an error
+ *  log, to be redone by the thread waiting for them.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIODEFERRED_EDUBFM - the volume cannot be read by this thread now
+ *    some errors caused by RDsM_ReadTrain()
+ */
+Four edubfm_VolumeRead(
+    TrainID             *trainId,       /* IN first page to read */
+    char                *buf,           /* OUT buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    Four                e;              /* for error */
+
+
+    if (edubfm_deferVolumeIO) return(eVOLUMEIODEFERRED_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_fileLatch);
+    e = RDsM_ReadTrain(trainId, buf, nPages);
+    pthread_mutex_unlock(&edubfm_fileLatch);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_VolumeRead() */
+
+
+
+/*@================================
+ * edubfm_VolumeWrite()
+ *================================*/
+/*
+ * Function: Four edubfm_VolumeWrite(TrainID*, char*, Two)
+ *
+ * Description:
+ *  Write nPages pages to the volume device by RDsM_WriteTrain(), bypassing
+ *  the side file and the device files.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by RDsM_WriteTrain()
+ */
+Four edubfm_VolumeWrite(
+    TrainID             *trainId,       /* IN first page to write */
+    char                *buf,           /* IN buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    Four                e;              /* for error */
+
+
+    pthread_mutex_lock(&edubfm_fileLatch);
+    e = RDsM_WriteTrain(buf, trainId, nPages);
+    pthread_mutex_unlock(&edubfm_fileLatch);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_VolumeWrite() */
+
+
+
+/*@================================
+ * edubfm_GetVolumeMode()
+ *================================*/
+/*
+ * Function: static Four edubfm_GetVolumeMode(VolNo, char*, Four*)
+ *
+ * Description:
+ *  Read a mode of the volume from its meta dictionary; a mode never
+ *  recorded is 0. The meta dictionary is read by RDsM through the buffer
+ *  manager of COSMOS, which works on the same buffer table, so the pool
+ *  of pages is latched meanwhile. The caller holds the latch of the
+ *  cached modes, and not the latch of the pool.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_GetVolumeMode(
+    VolNo               volNo,          /* IN volume */
+    char                *name,          /* IN name of the mode */
+    Four                *value)         /* OUT value of the mode */
+{
+    Four                e;              /* for error */
+
+
+    *value = 0;
+
+    e = edubfm_LatchPool(PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    pthread_mutex_lock(&edubfm_fileLatch);
+    e = RDsM_GetMetaEntry(volNo, name, (char*)value, sizeof(Four));
+    pthread_mutex_unlock(&edubfm_fileLatch);
+
+    edubfm_UnlatchPool(PAGE_BUF);
+    if (e == eMETADICTENTRYNOTFOUND_RDSM) return(eNOERROR);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_GetVolumeMode() */
+
+
+
+/*@================================
+ * edubfm_CheckVolumeMode()
+ *================================*/
+/*
+ * Function: Four edubfm_CheckVolumeMode(VolNo)
+ *
+ * Description:
+ *  Check that the volume is compressed in this process if it is recorded
+ *  so in the volume, and striped over as many devices if it is recorded
+ *  as striped. It is called before a train of the volume is placed
+ *  in the buffer pool, without the latch of the pool. The modes are read
+ *  from the volume the first time, and after they are recorded; if the
+ *  cache is full, the modes of the volume cached first are dropped.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEMODEMISMATCH_EDUBFM - the side file or the device files of the
+ *                                 volume were not given
+ *    some errors caused by edubfm_GetVolumeMode()
+ */
+Four edubfm_CheckVolumeMode(
+    VolNo               volNo)          /* IN volume */
+{
+    Four                e;              /* for error */
+    edubfm_VolumeMode_T mode;           /* modes of the volume */
+    Four                i;              /* index */
+
+
+    pthread_mutex_lock(&edubfm_volumeModeLatch);
+
+    for (i = 0; i < edubfm_nVolumeModes; i++)
+        if (edubfm_volumeMode[i].volNo == volNo) break;
+
+    if (i < edubfm_nVolumeModes)
+        mode = edubfm_volumeMode[i];
+    else {
+        mode.volNo = volNo;
+        e = edubfm_GetVolumeMode(volNo, BFM_MODE_COMPRESSION, &mode.compressed);
+        if (e >= 0) e = edubfm_GetVolumeMode(volNo, BFM_MODE_STRIPING, &mode.nDevices);
+        if (e < 0) {
+            pthread_mutex_unlock(&edubfm_volumeModeLatch);
+            ERR(e);
+        }
+
+        if (edubfm_nVolumeModes == BFM_MODE_MAXVOLUMES) {
+            memmove(&edubfm_volumeMode[0], &edubfm_volumeMode[1], (BFM_MODE_MAXVOLUMES - 1) * sizeof(edubfm_VolumeMode_T));
+            edubfm_nVolumeModes--;
+        }
+        edubfm_volumeMode[edubfm_nVolumeModes++] = mode;
+    }
+
+    pthread_mutex_unlock(&edubfm_volumeModeLatch);
+
+    if (mode.compressed && !edubfm_IsCompressedVolume(volNo)) ERR(eVOLUMEMODEMISMATCH_EDUBFM);
+    if (mode.nDevices > 0 && edubfm_GetStripedDevices(volNo) != mode.nDevices) ERR(eVOLUMEMODEMISMATCH_EDUBFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_CheckVolumeMode() */
+
+
+
+/*@================================
+ * edubfm_RecordVolumeMode()
+ *================================*/
+/*
+ * Function: Four edubfm_RecordVolumeMode(VolNo, char*, Four)
+ *
+ * Description:
+ *  Record a mode of the volume in its meta dictionary, so that other
+ *  processes refuse the volume unless they set the same mode, and drop
+ *  the modes of the volume cached. The meta dictionary is changed through
+ *  the buffer manager of COSMOS, and written at once to the volume by
+ *  BfM_FlushAll() of COSMOS, which writes by RDsM directly: so the caller
+ *  makes sure that no other buffer is dirty, and the page of the meta
+ *  dictionary is never kept in the side file or the device files.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by RDsM_InsertMetaEntry() and BfM_FlushAll()
+ */
+Four edubfm_RecordVolumeMode(
+    VolNo               volNo,          /* IN volume */
+    char                *name,          /* IN name of the mode */
+    Four                value)          /* IN value of the mode */
+{
+    Four                e;              /* for error */
+    Four                i;              /* index */
+
+
+    pthread_mutex_lock(&edubfm_volumeModeLatch);
+
+    pthread_mutex_lock(&edubfm_fileLatch);
+    e = RDsM_InsertMetaEntry(volNo, name, (char*)&value, sizeof(Four));
+    if (e >= 0) e = BfM_FlushAll();
+    pthread_mutex_unlock(&edubfm_fileLatch);
+
+    for (i = 0; i < edubfm_nVolumeModes; i++) {
+        if (edubfm_volumeMode[i].volNo != volNo) continue;
+
+        edubfm_nVolumeModes--;
+        memmove(&edubfm_volumeMode[i], &edubfm_volumeMode[i+1], (edubfm_nVolumeModes - i) * sizeof(edubfm_VolumeMode_T));
+        break;
+    }
+
+    pthread_mutex_unlock(&edubfm_volumeModeLatch);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_RecordVolumeMode() */
+
+
+
+/*@================================
+ * edubfm_FileRead()
+ *================================*/
+/*
+ * Function: static Four edubfm_FileRead(BfMStorage_T*, TrainID*, char*, Two)
+ *
+ * Description:
+ *  Read nPages pages from the volume device, or from the side file or the
+ *  device files if the volume is compressed or striped and the train was
+ *  written there.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by edubfm_VolumeRead()
+ *    some errors caused by edubfm_CompressedRead()
+ *    some errors caused by edubfm_StripedRead()
+ */
+static Four edubfm_FileRead(
+    BfMStorage_T        *storage,       /* IN this backend */
+    TrainID             *trainId,       /* IN first page to read */
+    char                *buf,           /* OUT buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    Four                e;              /* for error */
+
+
+    e = edubfm_CompressedRead(trainId, buf, nPages);
+    if (e == eNOTFOUND_BFM) e = edubfm_StripedRead(trainId, buf, nPages);
+    if (e != eNOTFOUND_BFM) {
+        if (e == eVOLUMEIODEFERRED_EDUBFM) return(e);
+        if (e < 0) ERR(e);
+        return(eNOERROR);
+    }
+
+    e = edubfm_VolumeRead(trainId, buf, nPages);
+    if (e == eVOLUMEIODEFERRED_EDUBFM) return(e);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_FileRead() */
+
+
+
+/*@================================
+ * edubfm_FileWrite()
+ *================================*/
+/*
+ * Function: static Four edubfm_FileWrite(BfMStorage_T*, TrainID*, char*, Two)
+ *
+ * Description:
+ *  Write nPages pages to the volume device, or to the side file or the
+ *  device files if the volume is compressed or striped.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by edubfm_VolumeWrite()
+ *    some errors caused by edubfm_CompressedWrite()
+ *    some errors caused by edubfm_StripedWrite()
+ */
+static Four edubfm_FileWrite(
+    BfMStorage_T        *storage,       /* IN this backend */
+    TrainID             *trainId,       /* IN first page to write */
+    char                *buf,           /* IN buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    Four                e;              /* for error */
+
+
+    e = edubfm_CompressedWrite(trainId, buf, nPages);
+    if (e == eNOTFOUND_BFM) e = edubfm_StripedWrite(trainId, buf, nPages);
+    if (e != eNOTFOUND_BFM) {
+        if (e < 0) ERR(e);
+        return(eNOERROR);
+    }
+
+    e = edubfm_VolumeWrite(trainId, buf, nPages);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_FileWrite() */
+
+
+
+/*@================================
+ * edubfm_RamFind()
+ *================================*/
+/*
+ * Function: static edubfm_RamPage_T *edubfm_RamFind(edubfm_RamStorageData_T*, BfMHashKey*)
+ *
+ * Description:
+ *  Find a page kept by the RAM backend. The caller holds the latch.
+ *
+ * Returns:
+ *  pointer to the page; NULL if the page is not kept
+ */
+static edubfm_RamPage_T *edubfm_RamFind(
+    edubfm_RamStorageData_T *ram,       /* IN data of the RAM backend */
+    BfMHashKey          *key)           /* IN page to find */
+{
+    edubfm_RamPage_T    *page;          /* page in the bucket */
+
+
+    for (page = ram->bucket[BFM_RAMSTORAGE_HASH(key)]; page != NULL; page = page->next)
+        if (EQUALKEY(&page->key, key)) return(page);
+
+    return(NULL);
+
+}  /* edubfm_RamFind() */
+
+
+
+/*@================================
+ * edubfm_RamKeep()
+ *================================*/
+/*
+ * Function: static Four edubfm_RamKeep(edubfm_RamStorageData_T*, BfMHashKey*, char*)
+ *
+ * Description:
+ *  Keep the content of a page in the RAM backend, replacing the old one.
+ *  The caller holds the latch.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCFAILED_EDUBFM - no memory for the page
+ */
+static Four edubfm_RamKeep(
+    edubfm_RamStorageData_T *ram,       /* IN data of the RAM backend */
+    BfMHashKey          *key,           /* IN page to keep */
+    char                *data)          /* IN content of the page */
+{
+    edubfm_RamPage_T    *page;          /* page kept */
+    UFour               bucket;         /* bucket of the page */
+
+
+    page = edubfm_RamFind(ram, key);
+    if (page == NULL) {
+        page = (edubfm_RamPage_T*)malloc(sizeof(edubfm_RamPage_T));
+        if (page == NULL) ERR(eMEMALLOCFAILED_EDUBFM);
+
+        page->key = *key;
+        bucket = BFM_RAMSTORAGE_HASH(key);
+        page->next = ram->bucket[bucket];
+        ram->bucket[bucket] = page;
+    }
+
+    memcpy(page->data, data, PAGESIZE);
+
+    return(eNOERROR);
+
+}  /* edubfm_RamKeep() */
+
+
+
+/*@================================
+ * edubfm_RamRelease()
+ *================================*/
+/*
+ * Function: static void edubfm_RamRelease(void)
+ *
+ * Description:
+ *  Free all the pages kept by the RAM backend. It is called when the RAM
+ *  backend stops being current, so that the pages written to it are not
+ *  seen again if it is selected later, and at the exit of the process.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_RamRelease(void)
+{
+    edubfm_RamStorageData_T *ram = &edubfm_ramStorageData;
+    edubfm_RamPage_T    *page;          /* page to free */
+    Four                i;              /* index */
+
+
+    pthread_mutex_lock(&ram->latch);
+
+    for (i = 0; i < BFM_RAMSTORAGE_NBUCKETS; i++) {
+        while (ram->bucket[i] != NULL) {
+            page = ram->bucket[i];
+            ram->bucket[i] = page->next;
+            free(page);
+        }
+    }
+
+    pthread_mutex_unlock(&ram->latch);
+
+}  /* edubfm_RamRelease() */
+
+
+
+/*@================================
+ * edubfm_RamRead()
+ *================================*/
+/*
+ * Function: static Four edubfm_RamRead(BfMStorage_T*, TrainID*, char*, Two)
+ *
+ * Description:
+ *  Read nPages pages from the RAM backend. A page not kept yet is read
+ *  from the wrapped backend and kept.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_RamRead(
+    BfMStorage_T        *storage,       /* IN this backend */
+    TrainID             *trainId,       /* IN first page to read */
+    char                *buf,           /* OUT buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    edubfm_RamStorageData_T *ram = (edubfm_RamStorageData_T*)storage->data;
+    Four                e;              /* for error */
+    Four                i;              /* index */
+    BfMHashKey          key;            /* page being read */
+    edubfm_RamPage_T    *page;          /* page kept */
+
+
+    pthread_mutex_lock(&ram->latch);
+
+    key = *((BfMHashKey*)trainId);
+    for (i = 0; i < nPages; i++, key.pageNo++) {
+        page = edubfm_RamFind(ram, &key);
+        if (page != NULL) {
+            memcpy(buf + i*PAGESIZE, page->data, PAGESIZE);
+            continue;
+        }
+
+        e = storage->inner->read(storage->inner, (TrainID*)&key, buf + i*PAGESIZE, 1);
+        if (e >= 0) e = edubfm_RamKeep(ram, &key, buf + i*PAGESIZE);
+        if (e < 0) {
+            pthread_mutex_unlock(&ram->latch);
+            if (e == eVOLUMEIODEFERRED_EDUBFM) return(e);
+            ERR(e);
+        }
+    }
+
+    pthread_mutex_unlock(&ram->latch);
+
+    return(eNOERROR);
+
+}  /* edubfm_RamRead() */
+
+
+
+/*@================================
+ * edubfm_RamWrite()
+ *================================*/
+/*
+ * Function: static Four edubfm_RamWrite(BfMStorage_T*, TrainID*, char*, Two)
+ *
+ * Description:
+ *  Write nPages pages to the RAM backend.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_RamWrite(
+    BfMStorage_T        *storage,       /* IN this backend */
+    TrainID             *trainId,       /* IN first page to write */
+    char                *buf,           /* IN buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    edubfm_RamStorageData_T *ram = (edubfm_RamStorageData_T*)storage->data;
+    Four                e;              /* for error */
+    Four                i;              /* index */
+    BfMHashKey          key;            /* page being written */
+
+
+    pthread_mutex_lock(&ram->latch);
+
+    key = *((BfMHashKey*)trainId);
+    for (i = 0; i < nPages; i++, key.pageNo++) {
+        e = edubfm_RamKeep(ram, &key, buf + i*PAGESIZE);
+        if (e < 0) {
+            pthread_mutex_unlock(&ram->latch);
+            ERR(e);
+        }
+    }
+
+    pthread_mutex_unlock(&ram->latch);
+
+    return(eNOERROR);
+
+}  /* edubfm_RamWrite() */
+
+
+
+/*@================================
+ * edubfm_Delay()
+ *================================*/
+/*
+ * Function: static void edubfm_Delay(edubfm_DelayStorageData_T*, TrainID*, Two)
+ *
+ * Description:
+ *  Queue an I/O of nPages pages on the emulated device of the train, and
+ *  sleep until it is done, i.e. for its latency and its transfer time
+ *  after the I/Os queued before it. The device is the one of the stripe
+ *  of the train if the volume is striped, or else the one of the
+ *  volumes. The sleep is resumed if a signal interrupts it.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_Delay(
+    edubfm_DelayStorageData_T *delay,   /* IN parameters of the delay */
+    TrainID             *trainId,       /* IN first page transferred */
+    Two                 nPages)         /* IN # of pages transferred */
+{
+    Four                device;         /* emulated device of the I/O */
+    long long           usec;           /* time taken by the I/O on the device */
+    long long           now;            /* current time (usec) */
+    long long           done;           /* when the I/O is done (usec) */
+    struct timespec     ts;             /* current time; time to wake up */
+
+
+    usec = delay->latency;
+    if (delay->bandwidth > 0)
+        usec += (long long)nPages * PAGESIZE * 1000000 / ((long long)delay->bandwidth * 1024);
+
+    device = edubfm_GetStripeDevice(trainId) + 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+    pthread_mutex_lock(&delay->latch);
+    done = ((delay->busyUntil[device] > now) ? delay->busyUntil[device] : now) + usec;
+    delay->busyUntil[device] = done;
+    pthread_mutex_unlock(&delay->latch);
+
+    ts.tv_sec = done / 1000000;
+    ts.tv_nsec = (done % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+
+}  /* edubfm_Delay() */
+
+
+
+/*@================================
+ * edubfm_DelayRead()
+ *================================*/
+/*
+ * Function: static Four edubfm_DelayRead(BfMStorage_T*, TrainID*, char*, Two)
+ *
+ * Description:
+ *  Read nPages pages from the wrapped backend after the delay.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_DelayRead(
+    BfMStorage_T        *storage,       /* IN this backend */
+    TrainID             *trainId,       /* IN first page to read */
+    char                *buf,           /* OUT buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    edubfm_Delay((edubfm_DelayStorageData_T*)storage->data, trainId, nPages);
+
+    return(storage->inner->read(storage->inner, trainId, buf, nPages));
+
+}  /* edubfm_DelayRead() */
+
+
+
+/*@================================
+ * edubfm_DelayWrite()
+ *================================*/
+/*
+ * Function: static Four edubfm_DelayWrite(BfMStorage_T*, TrainID*, char*, Two)
+ *
+ * Description:
+ *  Write nPages pages to the wrapped backend after the delay.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_DelayWrite(
+    BfMStorage_T        *storage,       /* IN this backend */
+    TrainID             *trainId,       /* IN first page to write */
+    char                *buf,           /* IN buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    edubfm_Delay((edubfm_DelayStorageData_T*)storage->data, trainId, nPages);
+
+    return(storage->inner->write(storage->inner, trainId, buf, nPages));
+
+}  /* edubfm_DelayWrite() */
+
+
+
+/*@================================
+ * edubfm_IsRamStorage()
+ *================================*/
+/*
+ * Function: Boolean edubfm_IsRamStorage(void)
+ *
+ * Description:
+ *  Tell whether the current backend keeps the pages written in the RAM
+ *  backend, directly or through the delay backend.
+ *
+ * Returns:
+ *  TRUE if the RAM backend is used; FALSE otherwise
+ */
+Boolean edubfm_IsRamStorage(void)
+{
+    return((edubfm_storage == &edubfm_ramStorage ||
+            (edubfm_storage == &edubfm_delayStorage && edubfm_delayStorage.inner == &edubfm_ramStorage)) ? TRUE : FALSE);
+
+}  /* edubfm_IsRamStorage() */
+
+
+
+/*@================================
+ * edubfm_IsFileStorage()
+ *================================*/
+/*
+ * Function: Boolean edubfm_IsFileStorage(void)
+ *
+ * Description:
+ *  Tell whether the current backend is the file backend without delay.
+ *
+ * Returns:
+ *  TRUE if the file backend is used directly; FALSE otherwise
+ */
+Boolean edubfm_IsFileStorage(void)
+{
+    return((edubfm_storage == &edubfm_fileStorage) ? TRUE : FALSE);
+
+}  /* edubfm_IsFileStorage() */
+
+
+
+/*@================================
+ * edubfm_SetStorage()
+ *================================*/
+/*
+ * Function: Four edubfm_SetStorage(Four, Four, Four)
+ *
+ * Description:
+ *  Make the given backend current; if latency or bandwidth is positive,
+ *  it is wrapped by the delay backend. The caller makes sure that no
+ *  buffer holds a train of the previous backend.
+ *  If the RAM backend is no longer used, the pages kept by it are freed;
+ *  they are freed at exit if it is still used then.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad backend or delay
+ */
+Four edubfm_SetStorage(
+    Four                backend,        /* IN BFM_STORAGE_FILE or BFM_STORAGE_RAM */
+    Four                latency,        /* IN latency per I/O (usec); 0 for none */
+    Four                bandwidth)      /* IN bandwidth (KB/sec); 0 for unlimited */
+{
+    static Boolean      registered = FALSE; /* TRUE if edubfm_RamRelease() runs at exit */
+    BfMStorage_T        *storage;       /* backend selected */
+    Boolean             wasRam;         /* TRUE if the previous backend uses the RAM backend */
+
+
+    if (latency < 0 || bandwidth < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    switch (backend) {
+      case BFM_STORAGE_FILE:
+        storage = &edubfm_fileStorage;
+        break;
+      case BFM_STORAGE_RAM:
+        storage = &edubfm_ramStorage;
+        break;
+      default:
+        ERR(eBADPARAMETER_EDUBFM);
+    }
+
+    wasRam = edubfm_IsRamStorage();
+
+    if (storage == &edubfm_ramStorage && !registered) {
+        if (atexit(edubfm_RamRelease) == 0) registered = TRUE;
+    }
+
+    if (latency > 0 || bandwidth > 0) {
+        edubfm_delayStorageData.latency = latency;
+        edubfm_delayStorageData.bandwidth = bandwidth;
+        memset(edubfm_delayStorageData.busyUntil, 0, sizeof(edubfm_delayStorageData.busyUntil));
+        edubfm_delayStorage.inner = storage;
+        storage = &edubfm_delayStorage;
+    }
+
+    edubfm_storage = storage;
+
+    if (wasRam && backend != BFM_STORAGE_RAM) edubfm_RamRelease();
+
+    return(eNOERROR);
+
+}  /* edubfm_SetStorage() */
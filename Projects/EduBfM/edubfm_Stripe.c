@@ -0,0 +1,589 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Stripe.c
+ *
+ * Description:
+ *  Striping of the file backend.
+ *  The trains of a striped volume are kept in several device files, in
+ *  units of BFM_STRIPE_NPAGES pages assigned to the devices round robin
+ *  (see the striping section of EduBfM_Internal.h). The device files are
+ *  read and written by edubfm_FileIO(), which, unlike RDsM, may be called
+ *  by several worker threads of the I/O engine at a time; without worker
+ *  threads, the trains of a batch are read or written together by it.
+ *
+ * Exports:
+ *  Four edubfm_SetStriping(VolNo, Four, char **)
+ *  Four edubfm_StripedRead(TrainID *, char *, Two)
+ *  Four edubfm_StripedWrite(TrainID *, char *, Two)
+ *  void edubfm_StripedBatch(BfMIORequest_T *, Four)
+ *  Boolean edubfm_IsStripedVolume(VolNo)
+ *  Four edubfm_GetStripedDevices(VolNo)
+ *  Four edubfm_GetStripeDevice(TrainID *)
+ */
+
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * type definitions
+ */
+/* a striped volume */
+typedef struct {
+    VolNo               volNo;          /* volume striped; NIL if unused */
+    Four                nDevices;       /* # of devices */
+    int                 fd[BFM_STRIPE_MAXDEVICES];     /* device files */
+} edubfm_StripedVolume_T;
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: BFM_STRIPE_DEVICE(vol, pageNo), BFM_STRIPE_OFFSET(vol, pageNo)
+ * Description: return the device holding the page and the offset of the page in it
+ */
+#define BFM_STRIPE_DEVICE(vol, pageNo)  (((pageNo) / BFM_STRIPE_NPAGES) % (vol)->nDevices)
+#define BFM_STRIPE_OFFSET(vol, pageNo) \
+    (((off_t)((pageNo) / BFM_STRIPE_NPAGES / (vol)->nDevices) * BFM_STRIPE_NPAGES + \
+      (pageNo) % BFM_STRIPE_NPAGES) * PAGESIZE)
+
+
+/*@
+ * global variables
+ */
+static edubfm_StripedVolume_T edubfm_stripedVolume[BFM_STRIPE_MAXVOLUMES] = {
+    { NIL, 0, { -1 } }, { NIL, 0, { -1 } }, { NIL, 0, { -1 } }, { NIL, 0, { -1 } },
+    { NIL, 0, { -1 } }, { NIL, 0, { -1 } }, { NIL, 0, { -1 } }, { NIL, 0, { -1 } }
+};
+
+
+
+/*@================================
+ * edubfm_FindStripedVolume()
+ *================================*/
+/*
+ * Function: static edubfm_StripedVolume_T *edubfm_FindStripedVolume(VolNo)
+ *
+ * Description:
+ *  Find the entry of a striped volume.
+ *
+ * Returns:
+ *  pointer to the entry; NULL if the volume is not striped
+ */
+static edubfm_StripedVolume_T *edubfm_FindStripedVolume(
+    VolNo               volNo)          /* IN volume to find */
+{
+    Four                i;              /* index */
+
+
+    for (i = 0; i < BFM_STRIPE_MAXVOLUMES; i++)
+        if (edubfm_stripedVolume[i].volNo == volNo) return(&edubfm_stripedVolume[i]);
+
+    return(NULL);
+
+}  /* edubfm_FindStripedVolume() */
+
+
+
+/*@================================
+ * edubfm_IsStripedVolume()
+ *================================*/
+/*
+ * Function: Boolean edubfm_IsStripedVolume(VolNo)
+ *
+ * Description:
+ *  Tell whether the volume is striped.
+ *
+ * Returns:
+ *  TRUE if the volume is striped; FALSE otherwise
+ */
+Boolean edubfm_IsStripedVolume(
+    VolNo               volNo)          /* IN volume */
+{
+    return((edubfm_FindStripedVolume(volNo) != NULL) ? TRUE : FALSE);
+
+}  /* edubfm_IsStripedVolume() */
+
+
+
+/*@================================
+ * edubfm_GetStripedDevices()
+ *================================*/
+/*
+ * Function: Four edubfm_GetStripedDevices(VolNo)
+ *
+ * Description:
+ *  Return the # of devices the volume is striped over.
+ *
+ * Returns:
+ *  # of devices; 0 if the volume is not striped
+ */
+Four edubfm_GetStripedDevices(
+    VolNo               volNo)          /* IN volume */
+{
+    edubfm_StripedVolume_T *vol;        /* entry of the volume */
+
+
+    vol = edubfm_FindStripedVolume(volNo);
+
+    return((vol != NULL) ? vol->nDevices : 0);
+
+}  /* edubfm_GetStripedDevices() */
+
+
+
+/*@================================
+ * edubfm_GetStripeDevice()
+ *================================*/
+/*
+ * Function: Four edubfm_GetStripeDevice(TrainID*)
+ *
+ * Description:
+ *  Return the device which the train is read from and written to.
+ *
+ * Returns:
+ *  index of the device; NIL if the volume is not striped
+ */
+Four edubfm_GetStripeDevice(
+    TrainID             *trainId)       /* IN train */
+{
+    edubfm_StripedVolume_T *vol;        /* entry of the volume */
+
+
+    vol = edubfm_FindStripedVolume(trainId->volNo);
+
+    return((vol != NULL) ? BFM_STRIPE_DEVICE(vol, trainId->pageNo) : NIL);
+
+}  /* edubfm_GetStripeDevice() */
+
+
+
+/*@================================
+ * edubfm_UnstripeVolume()
+ *================================*/
+/*
+ * Function: static Four edubfm_UnstripeVolume(edubfm_StripedVolume_T*)
+ *
+ * Description:
+ *  Write every page kept in the device files back to the volume, and
+ *  empty the device files so that they do not hide the volume when given
+ *  again. The holes of the device files are skipped.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOFAILED_EDUBFM - a device file cannot be read or emptied
+ *    some errors caused by function calls
+ */
+static Four edubfm_UnstripeVolume(
+    edubfm_StripedVolume_T *vol)        /* IN entry of the volume */
+{
+    Four                e;              /* for error */
+    Four                d;              /* device */
+    off_t               offset;         /* offset of the next data in the device */
+    PageNo              n;              /* # of the page in the device */
+    TrainID             pageId;         /* page written back */
+    char                page[PAGESIZE]; /* page read */
+
+
+    pageId.volNo = vol->volNo;
+    for (d = 0; d < vol->nDevices; d++) {
+        for (offset = 0; ; offset = (off_t)(n + 1) * PAGESIZE) {
+
+            offset = lseek(vol->fd[d], offset, SEEK_DATA);
+            if (offset < 0) break;      /* no more data */
+
+            n = offset / PAGESIZE;
+            if (pread(vol->fd[d], page, PAGESIZE, (off_t)n * PAGESIZE) != PAGESIZE)
+                ERR(eFILEIOFAILED_EDUBFM);
+
+            /* inverse of BFM_STRIPE_DEVICE() and BFM_STRIPE_OFFSET() */
+            pageId.pageNo = ((n / BFM_STRIPE_NPAGES) * vol->nDevices + d) * BFM_STRIPE_NPAGES +
+                            n % BFM_STRIPE_NPAGES;
+            e = edubfm_VolumeWrite(&pageId, page, 1);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    for (d = 0; d < vol->nDevices; d++)
+        if (ftruncate(vol->fd[d], 0) < 0) ERR(eFILEIOFAILED_EDUBFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_UnstripeVolume() */
+
+
+
+/*@================================
+ * edubfm_SetStriping()
+ *================================*/
+/*
+ * Function: Four edubfm_SetStriping(VolNo, Four, char**)
+ *
+ * Description:
+ *  Stripe the trains of the volume over the given device files, which are
+ *  created if they do not exist; with no device, stop striping the volume.
+ *  If the volume was striped, the pages kept in its previous device files
+ *  are written back to the volume and the files are emptied first; if
+ *  they cannot all be written back, the striping is left as it was.
+ *  The caller makes sure that no I/O on the volume is in progress.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad # of devices, the volume is not striped,
+ *                           too many volumes, or the volume is compressed
+ *    eCREATEFILEFAILED_BFM - a device file cannot be opened
+ *    some errors caused by edubfm_UnstripeVolume()
+ */
+Four edubfm_SetStriping(
+    VolNo               volNo,          /* IN volume */
+    Four                nDevices,       /* IN # of devices; 0 to stop striping */
+    char                **paths)        /* IN device files */
+{
+    Four                e;              /* for error */
+    edubfm_StripedVolume_T *vol;        /* entry of the volume */
+    int                 fd[BFM_STRIPE_MAXDEVICES];     /* device files opened */
+    Four                i;              /* index */
+
+
+    if (nDevices < 0 || nDevices > BFM_STRIPE_MAXDEVICES) ERR(eBADPARAMETER_EDUBFM);
+    if (nDevices > 0 && edubfm_IsCompressedVolume(volNo)) ERR(eBADPARAMETER_EDUBFM);
+
+    vol = edubfm_FindStripedVolume(volNo);
+
+    if (nDevices == 0) {
+        if (vol == NULL) ERR(eBADPARAMETER_EDUBFM);
+    }
+    else {
+        if (vol == NULL) {
+            vol = edubfm_FindStripedVolume(NIL);
+            if (vol == NULL) ERR(eBADPARAMETER_EDUBFM);
+        }
+
+        for (i = 0; i < nDevices; i++) {
+            fd[i] = open(paths[i], O_RDWR | O_CREAT, 0644);
+            if (fd[i] < 0) {
+                while (--i >= 0) close(fd[i]);
+                ERR(eCREATEFILEFAILED_BFM);
+            }
+        }
+    }
+
+    /*@ move the pages of the previous device files back and close them */
+    if (vol->volNo != NIL) {
+        e = edubfm_UnstripeVolume(vol);
+        if (e < 0) {
+            for (i = 0; i < nDevices; i++) close(fd[i]);
+            ERR(e);
+        }
+
+        for (i = 0; i < vol->nDevices; i++) close(vol->fd[i]);
+    }
+
+    vol->volNo = (nDevices > 0) ? volNo : NIL;
+    vol->nDevices = nDevices;
+    for (i = 0; i < nDevices; i++) vol->fd[i] = fd[i];
+
+    return(eNOERROR);
+
+}  /* edubfm_SetStriping() */
+
+
+
+/*@================================
+ * edubfm_StripePieces()
+ *================================*/
+/*
+ * Function: static Four edubfm_StripePieces(edubfm_StripedVolume_T*, Four, TrainID*, char*, Two, BfMFileIO_T*, struct iovec*)
+ *
+ * Description:
+ *  Fill in the I/Os of a train of a striped volume, one for each piece of
+ *  the train in a striping unit; a train crossing striping units, which
+ *  RDsM does not allocate, has several pieces.
+ *
+ * Returns:
+ *  # of I/Os filled in; at most BFM_STRIPE_MAXPIECES
+ */
+static Four edubfm_StripePieces(
+    edubfm_StripedVolume_T *vol,        /* IN entry of the volume */
+    Four                op,             /* IN BFM_IO_READ or BFM_IO_WRITE */
+    TrainID             *trainId,       /* IN train */
+    char                *buf,           /* IN buffer of the train */
+    Two                 nPages,         /* IN # of pages */
+    BfMFileIO_T         *ios,           /* OUT I/Os of the pieces */
+    struct iovec        *iov)           /* OUT buffers of the pieces */
+{
+    PageNo              pageNo;         /* first page of a piece in a unit */
+    Four                n;              /* # of pages of the piece */
+    Four                nPieces;        /* # of pieces */
+    Four                i;              /* index */
+
+
+    for (nPieces = 0, i = 0; i < nPages; i += n, nPieces++) {
+        pageNo = trainId->pageNo + i;
+        n = BFM_STRIPE_NPAGES - pageNo % BFM_STRIPE_NPAGES;
+        if (n > nPages - i) n = nPages - i;
+
+        iov[nPieces].iov_base = &buf[i*PAGESIZE];
+        iov[nPieces].iov_len = n*PAGESIZE;
+        ios[nPieces].op = op;
+        ios[nPieces].fd = vol->fd[BFM_STRIPE_DEVICE(vol, pageNo)];
+        ios[nPieces].iov = &iov[nPieces];
+        ios[nPieces].iovcnt = 1;
+        ios[nPieces].offset = BFM_STRIPE_OFFSET(vol, pageNo);
+    }
+
+    return(nPieces);
+
+}  /* edubfm_StripePieces() */
+
+
+
+/*@================================
+ * edubfm_StripeDone()
+ *================================*/
+/*
+ * Function: static Four edubfm_StripeDone(edubfm_StripedVolume_T*, TrainID*, char*, Two, BfMFileIO_T*, Four)
+ *
+ * Description:
+ *  Check the I/Os of the pieces of a train of a striped volume once they
+ *  are done. A page read as zeros may be a hole, i.e. a page never
+ *  written to the device; then the train is read from the volume. The
+ *  trains are always written as a whole, so a hole in any page means the
+ *  train was never written there.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - the train was never written to its device; read it
+ *                    from the volume
+ *    eFILEIOFAILED_EDUBFM - the device file cannot be read or written
+ */
+static Four edubfm_StripeDone(
+    edubfm_StripedVolume_T *vol,        /* IN entry of the volume */
+    TrainID             *trainId,       /* IN train */
+    char                *buf,           /* IN buffer of the train */
+    Two                 nPages,         /* IN # of pages */
+    BfMFileIO_T         *ios,           /* IN I/Os of the pieces */
+    Four                nPieces)        /* IN # of pieces */
+{
+    PageNo              pageNo;         /* page of the train */
+    off_t               offset;         /* offset of the page in the device */
+    Four                i, j;           /* indexes */
+
+
+    for (i = 0; i < nPieces; i++) {
+        if (ios[i].result < 0) ERR(eFILEIOFAILED_EDUBFM);
+        if (ios[i].result == ios[i].iov[0].iov_len) continue;
+
+        if (ios[i].op == BFM_IO_WRITE) ERR(eFILEIOFAILED_EDUBFM);
+        return(eNOTFOUND_BFM);          /* beyond the end of the device */
+    }
+
+    if (ios[0].op == BFM_IO_WRITE) return(eNOERROR);
+
+    /*@ look for the holes */
+    for (i = 0; i < nPages; i++) {
+        for (j = 0; j < PAGESIZE && buf[i*PAGESIZE + j] == 0; j++);
+        if (j < PAGESIZE) continue;
+
+        pageNo = trainId->pageNo + i;
+        offset = BFM_STRIPE_OFFSET(vol, pageNo);
+        if (lseek(vol->fd[BFM_STRIPE_DEVICE(vol, pageNo)], offset, SEEK_DATA) != offset)
+            return(eNOTFOUND_BFM);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_StripeDone() */
+
+
+
+/*@================================
+ * edubfm_StripedRead()
+ *================================*/
+/*
+ * Function: Four edubfm_StripedRead(TrainID*, char*, Two)
+ *
+ * Description:
+ *  Read a train of a striped volume from its device; the pieces of a
+ *  train crossing striping units are read together.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - the volume is not striped, or the train was never
+ *                    written to its device; read it from the volume
+ *    eFILEIOFAILED_EDUBFM - the device file cannot be read
+ */
+Four edubfm_StripedRead(
+    TrainID             *trainId,       /* IN train to read */
+    char                *buf,           /* OUT buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    edubfm_StripedVolume_T *vol;        /* entry of the volume */
+    BfMFileIO_T         ios[BFM_STRIPE_MAXPIECES];     /* reads of the pieces */
+    struct iovec        iov[BFM_STRIPE_MAXPIECES];     /* buffers of the pieces */
+    Four                nPieces;        /* # of pieces */
+
+
+    vol = edubfm_FindStripedVolume(trainId->volNo);
+    if (vol == NULL) return(eNOTFOUND_BFM);
+
+    if (nPages > BFM_CLUSTER_MAXPAGES) ERR(eBADPARAMETER_EDUBFM);
+
+    nPieces = edubfm_StripePieces(vol, BFM_IO_READ, trainId, buf, nPages, ios, iov);
+    (void) edubfm_FileIO(ios, nPieces);
+
+    return(edubfm_StripeDone(vol, trainId, buf, nPages, ios, nPieces));
+
+}  /* edubfm_StripedRead() */
+
+
+
+/*@================================
+ * edubfm_StripedWrite()
+ *================================*/
+/*
+ * Function: Four edubfm_StripedWrite(TrainID*, char*, Two)
+ *
+ * Description:
+ *  Write a train of a striped volume to its device; the pieces of a
+ *  train crossing striping units are written together.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - the volume is not striped; write it to the volume
+ *    eFILEIOFAILED_EDUBFM - the device file cannot be written
+ */
+Four edubfm_StripedWrite(
+    TrainID             *trainId,       /* IN train to write */
+    char                *buf,           /* IN buffer */
+    Two                 nPages)         /* IN # of pages */
+{
+    edubfm_StripedVolume_T *vol;        /* entry of the volume */
+    BfMFileIO_T         ios[BFM_STRIPE_MAXPIECES];     /* writes of the pieces */
+    struct iovec        iov[BFM_STRIPE_MAXPIECES];     /* buffers of the pieces */
+    Four                nPieces;        /* # of pieces */
+
+
+    vol = edubfm_FindStripedVolume(trainId->volNo);
+    if (vol == NULL) return(eNOTFOUND_BFM);
+
+    if (nPages > BFM_CLUSTER_MAXPAGES) ERR(eBADPARAMETER_EDUBFM);
+
+    nPieces = edubfm_StripePieces(vol, BFM_IO_WRITE, trainId, buf, nPages, ios, iov);
+    (void) edubfm_FileIO(ios, nPieces);
+
+    return(edubfm_StripeDone(vol, trainId, buf, nPages, ios, nPieces));
+
+}  /* edubfm_StripedWrite() */
+
+
+
+/*@================================
+ * edubfm_StripedBatch()
+ *================================*/
+/*
+ * Function: void edubfm_StripedBatch(BfMIORequest_T*, Four)
+ *
+ * Description:
+ *  Do the requests of a batch on striped volumes together, so that the
+ *  I/Os on different devices overlap without worker threads, and mark
+ *  them done; the other requests are left to the caller. A train never
+ *  written to its device is read from the volume. The caller makes sure
+ *  that the file backend is used without delay.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StripedBatch(
+    BfMIORequest_T      *reqs,          /* INOUT requests of the batch */
+    Four                nReqs)          /* IN # of requests */
+{
+    edubfm_StripedVolume_T *vol[BFM_IO_MAXBATCH];      /* entry of the volume of each request */
+    Four                first[BFM_IO_MAXBATCH];        /* first I/O of each request */
+    Four                nPieces[BFM_IO_MAXBATCH];      /* # of I/Os of each request */
+    BfMFileIO_T         ios[BFM_IO_MAXBATCH * BFM_STRIPE_MAXPIECES];   /* I/Os of the pieces */
+    struct iovec        iov[BFM_IO_MAXBATCH * BFM_STRIPE_MAXPIECES];   /* buffers of the pieces */
+    Four                nIOs;           /* # of I/Os */
+    BfMIORequest_T      *req;           /* request */
+    Four                i;              /* index */
+
+
+    for (nIOs = 0, i = 0; i < nReqs; i++) {
+        req = &reqs[i];
+        vol[i] = edubfm_FindStripedVolume(req->trainId.volNo);
+        if (vol[i] == NULL || req->nPages > BFM_CLUSTER_MAXPAGES) continue;
+
+        first[i] = nIOs;
+        nPieces[i] = edubfm_StripePieces(vol[i], req->op, &req->trainId, req->buf, req->nPages,
+                                         &ios[nIOs], &iov[nIOs]);
+        nIOs += nPieces[i];
+    }
+    if (nIOs == 0) return;
+
+    (void) edubfm_FileIO(ios, nIOs);
+
+    for (i = 0; i < nReqs; i++) {
+        req = &reqs[i];
+        if (vol[i] == NULL || req->nPages > BFM_CLUSTER_MAXPAGES) continue;
+
+        req->status = edubfm_StripeDone(vol[i], &req->trainId, req->buf, req->nPages,
+                                        &ios[first[i]], nPieces[i]);
+        if (req->status == eNOTFOUND_BFM && req->op == BFM_IO_READ)
+            req->status = edubfm_VolumeRead(&req->trainId, req->buf, req->nPages);
+        req->done = TRUE;
+    }
+
+}  /* edubfm_StripedBatch() */
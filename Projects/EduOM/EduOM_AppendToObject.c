@@ -0,0 +1,355 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_AppendToObject.c
+ *
+ * Description :
+ *  EduOM_AppendToObject() appends data to the end of an object.
+ *
+ * Exports:
+ *  Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * eduom_CollapseMovedObject()
+ *================================*/
+/*
+ * Function: static Four eduom_CollapseMovedObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Bring a moved object, whose 'length' bytes of 'data' are read from its
+ *  forwarded record by the caller, back into the slot of its stub so that
+ *  it can be converted into a large object rooted there. The stub is
+ *  replaced by a small object holding as much of the data as the stub
+ *  takes in the page, the forwarded record is destroyed, and the rest of
+ *  the data is appended to the object.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+static Four eduom_CollapseMovedObject(
+    ObjectID 	*catObjForFile,	/* IN file containing the object */
+    ObjectID 	*oid,		/* IN moved object */
+    Four     	length,		/* IN length of the object */
+    char     	*data,		/* IN data of the object */
+    Pool     	*dlPool,	/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four     	e;              /* error code */
+    PageID 	pid;		/* page containing object specified by 'oid' */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the stub in the slotted page */
+    ObjectID	fwdOid;		/* forwarded record of the object */
+    Four	inStub;		/* # of bytes of data kept in the place of the stub */
+    Four	shrink;		/* # of bytes the stub shrinks by */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    if (!(obj->header.properties & P_MOVED) || obj->header.length != length)
+        ERRBC2(eBADOBJECTID_OM, &pid, PAGE_BUF, catObjForFile);
+
+    fwdOid = *(ObjectID*)obj->data;
+
+    e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    inStub = (length < (Four)ALIGNED_LENGTH(sizeof(ObjectID))) ? length : ALIGNED_LENGTH(sizeof(ObjectID));
+    shrink = OM_STUB_LENGTH - (sizeof(ObjectHdr) + ALIGNED_LENGTH(inStub));
+
+    if (apage->slot[-(oid->slotNo)].offset + OM_STUB_LENGTH == apage->header.free)
+        apage->header.free -= shrink;
+    else
+        apage->header.unused += shrink;
+
+    obj->header.properties = P_CLEAR;
+    obj->header.length = inStub;
+    memcpy(obj->data, data, inStub);
+
+    e = eduom_PutInAvailSpace(catObjForFile, catEntry, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    e = BfM_SetDirty((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    e = eduom_FreeCatalogEntry(catObjForFile);
+    if (e < 0) ERR(e);
+
+    e = eduom_DestroyObject(catObjForFile, &fwdOid, TRUE, dlPool, dlHead);
+    if (e < 0) ERR(e);
+
+    return(EduOM_AppendToObject(catObjForFile, oid, length - inStub, &data[inStub], dlPool, dlHead));
+
+} /* eduom_CollapseMovedObject() */
+
+
+
+/*@================================
+ * EduOM_AppendToObject()
+ *================================*/
+/*
+ * Function: Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  (1) What to do?
+ *  EduOM_AppendToObject() appends 'length' bytes of 'data' to the end of
+ *  the object identified by 'oid'. A small object grows in its page while
+ *  it fits there; otherwise it is converted into a large object, whose data
+ *  is kept in the leaves of an LOT tree rooted at the slot of the object,
+ *  so the ObjectID is not changed. A large object is written in pieces by
+ *  calling this function repeatedly without keeping all the data in memory.
+ *
+ *  (2) How to do?
+ *  a. Read in the slotted page
+ *  b. IF moved object THEN
+ *	   IF the object stays small after appending THEN
+ *	       rewrite the object with the data appended by EduOM_UpdateObject()
+ *	   ELSE
+ *	       bring the object back into the slot of its stub
+ *	       append the data to the object, which becomes a large object
+ *	   ENDIF
+ *	   return
+ *     ENDIF
+ *  c. Remove this page from the 'availSpaceList'
+ *  d. IF large object THEN
+ *	   call the large object manager's LOT_AppendToObject()
+ *     ELSE IF the object fits in the page after appending THEN
+ *	   compact the page to put the object at the end of the data area if needed
+ *	   copy the data after the object
+ *     ELSE
+ *	   convert the object into a large object by LOT_ConvertToLarge()
+ *	   call the large object manager's LOT_AppendToObject()
+ *     ENDIF
+ *  e. Update the length of the object
+ *  f. Put this page into the proper 'availSpaceList'
+ *  g. Free the buffer page
+ *  h. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eMEMALLOCFAILED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_AppendToObject(
+    ObjectID 	*catObjForFile,	/* IN file containing the object */
+    ObjectID 	*oid,		/* IN object to append to */
+    Four     	length,		/* IN amount of data to append */
+    char     	*data,		/* IN data to append */
+    Pool     	*dlPool,	/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four     	e;              /* error code */
+    PageID 	pid;		/* page containing object specified by 'oid' */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    Four	alignedLen;	/* aligned length of the object */
+    Four	growth;		/* # of bytes the object grows by in the page */
+    Four	oldLength;	/* length of a moved object before appending */
+    char	*buf;		/* data of a moved object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    if (length == 0) return(eNOERROR);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRBC2(eBADOBJECTID_OM, &pid, PAGE_BUF, catObjForFile);
+
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    /*
+     * a moved object is rewritten as a whole by EduOM_UpdateObject() while it
+     * stays small; otherwise it becomes a large object rooted at its stub
+     */
+    if (obj->header.properties & P_MOVED) {
+        oldLength = obj->header.length;
+
+        e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+        if (e < 0) ERRBC1(e, catObjForFile);
+        e = eduom_FreeCatalogEntry(catObjForFile);
+        if (e < 0) ERR(e);
+
+        if (ALIGNED_LENGTH(oldLength + length) <= LRGOBJ_THRESHOLD) {
+            buf = (char*)malloc(oldLength + length);
+            if (buf == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+            e = EduOM_ReadObject(oid, 0, oldLength, buf);
+            if (e >= 0) {
+                memcpy(&buf[oldLength], data, length);
+                e = EduOM_UpdateObject(catObjForFile, oid, oldLength + length, buf, dlPool, dlHead);
+            }
+            free(buf);
+            if (e < 0) ERR(e);
+
+            return(eNOERROR);
+        }
+
+        buf = (char*)malloc(oldLength > 0 ? oldLength : 1);
+        if (buf == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+        e = EduOM_ReadObject(oid, 0, oldLength, buf);
+        if (e >= 0)
+            e = eduom_CollapseMovedObject(catObjForFile, oid, oldLength, buf, dlPool, dlHead);
+        free(buf);
+        if (e < 0) ERR(e);
+
+        return(EduOM_AppendToObject(catObjForFile, oid, length, data, dlPool, dlHead));
+    }
+
+    /*
+     * LOT_ConvertToLarge() takes an empty object for one of ALIGN bytes,
+     * so an empty object to be converted is given its first ALIGN bytes first
+     */
+    if (!(obj->header.properties & P_LRGOBJ) && obj->header.length == 0 && length > ALIGN &&
+        (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD || ALIGNED_LENGTH(length) > SP_FREE(apage))) {
+        e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+        if (e < 0) ERRBC1(e, catObjForFile);
+        e = eduom_FreeCatalogEntry(catObjForFile);
+        if (e < 0) ERR(e);
+
+        e = EduOM_AppendToObject(catObjForFile, oid, ALIGN, data, dlPool, dlHead);
+        if (e < 0) ERR(e);
+
+        return(EduOM_AppendToObject(catObjForFile, oid, length - ALIGN, &data[ALIGN], dlPool, dlHead));
+    }
+
+    e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    if (obj->header.properties & P_LRGOBJ) {
+        e = LOT_AppendToObject(catObjForFile, &pid, oid->slotNo, length, data);
+        if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+    }
+    else {
+        alignedLen = ALIGNED_LENGTH(obj->header.length);
+        growth = ALIGNED_LENGTH(obj->header.length + length) - alignedLen;
+
+        if (alignedLen + growth <= LRGOBJ_THRESHOLD && growth <= SP_FREE(apage)) {
+            /* the object grows into the contiguous free space after it */
+            if (apage->slot[-(oid->slotNo)].offset + sizeof(ObjectHdr) + alignedLen != apage->header.free ||
+                growth > SP_CFREE(apage)) {
+                e = EduOM_CompactPage(apage, oid->slotNo);
+                if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+                obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+            }
+            memcpy(&(obj->data[obj->header.length]), data, length);
+            apage->header.free += growth;
+        }
+        else {
+            e = LOT_ConvertToLarge(catObjForFile, (Page*)apage, oid->slotNo, dlPool, dlHead);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+            e = LOT_AppendToObject(catObjForFile, &pid, oid->slotNo, length, data);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+        }
+    }
+
+    /* the root of a large object may have been moved in the page */
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    obj->header.length += length;
+
+    e = eduom_PutInAvailSpace(catObjForFile, catEntry, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    e = BfM_SetDirty((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    e = eduom_FreeCatalogEntry(catObjForFile);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_AppendToObject() */
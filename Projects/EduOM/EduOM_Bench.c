@@ -0,0 +1,1092 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Bench.c
+ *
+ * Description : 
+ *  Benchmarks of the extensions of EduOM. The program is built by
+ *  'make bench' by linking this module in place of EduOM_Test.o, and
+ *  prints one table per benchmark.
+ *  - create: small objects created one by one by EduOM_CreateObject()
+ *    and in batches by EduOM_CreateObjects(), and a batch with large
+ *    objects mixed in.
+ *  - scan: full scans of a file of small objects by OM_NextObject(),
+ *    EduOM_ScanNext() and EduOM_NextObjects().
+ *  - pin: point lookups of objects of 100 bytes to 2 KB by copying them
+ *    with EduOM_ReadObject() and by EduOM_PinObject()/EduOM_UnpinObject().
+ *  - parallel scan: a scan doing some CPU work per object, by one thread
+ *    and by EduOM_ParallelScan() with 1 to 8 workers.
+ *  - compaction: EduOM_CompactPage() and the original OM_CompactPage() on
+ *    full pages with holes in different places, in memory.
+ *  - open file: destroys, creates and updates of small objects in a file
+ *    not open and in a file opened by EduOM_OpenFile().
+ *  'make bench' runs each benchmark in a process of its own, choosing it
+ *  by the environment variable EDUOM_BENCH, so that each one has the
+ *  500-page volume formatted by EduOM_TestModule.c to itself.
+ *
+ * Exports:
+ *  Four EduOM_Test(Four, Four)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+/*@ Constant definitions */
+#define BENCH_CREATE_NOBJECTS   4000    /* # of small objects created per creation method */
+#define BENCH_CREATE_BATCH      1000    /* max # of objects per EduOM_CreateObjects() call */
+#define BENCH_CREATE_NMIXED     200     /* # of objects of the batch with large objects */
+#define BENCH_CREATE_LRGEVERY   50      /* every BENCH_CREATE_LRGEVERY-th object of it is large */
+#define BENCH_CREATE_LRGLENGTH  10000   /* length of the large objects */
+#define BENCH_SCAN_NOBJECTS     10000   /* # of objects created by the scan benchmark */
+#define BENCH_SCAN_NSCANS       400     /* # of full scans per scan method */
+#define BENCH_SCAN_BATCH        256     /* max # of objects per EduOM_NextObjects() call */
+#define BENCH_PIN_NOBJECTS      64      /* # of objects of each size looked up */
+#define BENCH_PIN_NLOOKUPS      200000  /* # of lookups per object size and method */
+#define BENCH_PIN_MAXLENGTH     2048    /* max length of the objects looked up */
+#define BENCH_PSCAN_NOBJECTS    8000    /* # of objects created by the parallel scan benchmark */
+#define BENCH_PSCAN_WORK        400     /* # of passes over the data of each object */
+#define BENCH_COMPACT_NCALLS    20000   /* # of compactions per page and method */
+#define BENCH_COMPACT_MINGAIN   256     /* 'minGain' given to EduOM_CompactPageIfNeeded() */
+#define BENCH_OPEN_NOBJECTS     1000    /* # of objects of each file of the open file benchmark */
+#define BENCH_OPEN_NROUNDS      4       /* # of rounds of destroys, creates and updates */
+
+
+/* sums of a worker of the parallel scan benchmark */
+typedef struct {
+    long	sum;		/* sum of the first bytes of the objects */
+    UFour	hash;		/* hash of the data, to keep the work from being optimized out */
+} bench_ScanSums;
+
+
+/* the original COSMOS functions which the extensions are compared with */
+Four OM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+Four OM_CompactPage(SlottedPage*, Two);
+
+
+
+/*@================================
+ * bench_Now()
+ *================================*/
+/*
+ * Function: static double bench_Now(void)
+ *
+ * Description:
+ *  Return the time of the monotonic clock.
+ *
+ * Returns:
+ *  time in seconds
+ */
+static double bench_Now(void)
+{
+    struct timespec ts;		/* current time */
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec + ts.tv_nsec / 1e9);
+
+}  /* bench_Now() */
+
+
+
+/*@================================
+ * bench_CreateFile()
+ *================================*/
+/*
+ * Function: static Four bench_CreateFile(Four, Four, Four, char*, FileID*, ObjectID*, ObjectID*)
+ *
+ * Description:
+ *  Create a data file holding 'nObjects' objects of 'length' bytes of
+ *  'data', and destroy every 'holeEvery'-th of them if 'holeEvery' > 0.
+ *  The destroyed objects have their pageNo set to NIL in 'oids'.
+ *
+ * Returns:
+ *  # of objects left in the file, or an error code
+ *    some errors caused by function calls
+ */
+static Four bench_CreateFile(
+    Four	volId,		/* IN volume of the file */
+    Four	nObjects,	/* IN # of objects to create */
+    Four	length,		/* IN length of each object */
+    char	*data,		/* IN data of each object */
+    Four	holeEvery,	/* IN destroy every holeEvery-th object, if > 0 */
+    FileID	*fid,		/* OUT file created */
+    ObjectID	*catObj,	/* OUT catalog object of the file */
+    ObjectID	*oids)		/* OUT objects created */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	nLeft;		/* # of objects left */
+    Four	*lengths;	/* length of each object */
+    char	**dataPtrs;	/* data of each object */
+
+
+    e = SM_CreateFile(volId, fid, FALSE, NULL);
+    if (e < eNOERROR) ERR(e);
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, fid, catObj);
+    if (e < eNOERROR) ERR(e);
+
+    lengths = (Four*)malloc(nObjects * sizeof(Four));
+    dataPtrs = (char**)malloc(nObjects * sizeof(char*));
+    if (lengths == NULL || dataPtrs == NULL) {
+        free(lengths);
+        free(dataPtrs);
+        ERR(eMEMALLOCFAILED_EDUOM);
+    }
+    for (i = 0; i < nObjects; i++) {
+        lengths[i] = length;
+        dataPtrs[i] = data;
+    }
+
+    e = EduOM_CreateObjects(catObj, NULL, nObjects, NULL, lengths, dataPtrs, oids);
+    free(lengths);
+    free(dataPtrs);
+    if (e < eNOERROR) ERR(e);
+
+    nLeft = nObjects;
+    for (i = 0; holeEvery > 0 && i < nObjects; i += holeEvery) {
+        e = EduOM_DestroyObject(catObj, &oids[i], &dlPool, &dlHead);
+        if (e < eNOERROR) ERR(e);
+        oids[i].pageNo = NIL;
+        nLeft--;
+    }
+
+    return(nLeft);
+
+}  /* bench_CreateFile() */
+
+
+
+/*@================================
+ * bench_CreateRun()
+ *================================*/
+/*
+ * Function: static Four bench_CreateRun(ObjectID*, Four, Four, Four*, char**, ObjectID*, char*, double*)
+ *
+ * Description:
+ *  Create the objects at the end of the file, one by one if 'method' is
+ *  0 or 1, with 'nearObj' being the previous object if it is 1, and in
+ *  batches of BENCH_CREATE_BATCH objects otherwise. The objects are read
+ *  back and checked.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - an object was read back with wrong data
+ *    some errors caused by function calls
+ */
+static Four bench_CreateRun(
+    ObjectID	*catObj,	/* IN catalog object of the file */
+    Four	method,		/* IN creation method */
+    Four	nObjects,	/* IN # of objects to create */
+    Four	*lengths,	/* IN length of each object */
+    char	**dataPtrs,	/* IN data of each object */
+    ObjectID	*oids,		/* OUT objects created */
+    char	*buf,		/* OUT buffer to read the objects back into */
+    double	*seconds)	/* OUT time taken by the creation */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+
+
+    *seconds = bench_Now();
+    if (method < 2)
+        for (i = 0; i < nObjects; i++) {
+            e = EduOM_CreateObject(catObj, (method == 1 && i > 0) ? &oids[i-1] : NULL, NULL,
+                                   lengths[i], dataPtrs[i], &oids[i]);
+            if (e < eNOERROR) ERR(e);
+        }
+    else
+        for (i = 0; i < nObjects; i += BENCH_CREATE_BATCH) {
+            e = EduOM_CreateObjects(catObj, (i > 0) ? &oids[i-1] : NULL,
+                                    (nObjects - i < BENCH_CREATE_BATCH) ? nObjects - i : BENCH_CREATE_BATCH,
+                                    NULL, &lengths[i], &dataPtrs[i], &oids[i]);
+            if (e < eNOERROR) ERR(e);
+        }
+    *seconds = bench_Now() - *seconds;
+
+    for (i = 0; i < nObjects; i++) {
+        e = EduOM_ReadObject(&oids[i], 0, REMAINDER, buf);
+        if (e < eNOERROR) ERR(e);
+        if (e != lengths[i] || memcmp(buf, dataPtrs[i], lengths[i]) != 0) ERR(eBADPARAMETER_OM);
+    }
+
+    return(eNOERROR);
+
+}  /* bench_CreateRun() */
+
+
+
+/*@================================
+ * bench_Create()
+ *================================*/
+/*
+ * Function: static Four bench_Create(Four)
+ *
+ * Description:
+ *  Create small objects of 8..107 bytes one by one with
+ *  EduOM_CreateObject() and in batches with EduOM_CreateObjects() at the
+ *  end of one file, and print the time per object. The last run mixes in a large object every
+ *  BENCH_CREATE_LRGEVERY-th, which EduOM_CreateObjects() creates by
+ *  EduOM_CreateObject().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - an object was read back with wrong data
+ *    some errors caused by function calls
+ */
+static Four bench_Create(
+    Four	volId)		/* IN volume of the files */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	m;		/* index of the creation method */
+    Four	n;		/* # of objects created by the method */
+    FileID	fid;		/* file of the objects */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	*oids;		/* objects created */
+    Four	*lengths;	/* length of each object */
+    char	**dataPtrs;	/* data of each object */
+    char	*data;		/* data of the objects */
+    char	*buf;		/* data read back */
+    double	seconds;	/* time taken */
+    char	*methods[] = { "CreateObject, nearObj NULL", "CreateObject, nearObj previous",
+                               "CreateObjects", "CreateObjects, large mixed in" };
+
+
+    oids = (ObjectID*)malloc(BENCH_CREATE_NOBJECTS * sizeof(ObjectID));
+    lengths = (Four*)malloc(BENCH_CREATE_NOBJECTS * sizeof(Four));
+    dataPtrs = (char**)malloc(BENCH_CREATE_NOBJECTS * sizeof(char*));
+    data = (char*)malloc(BENCH_CREATE_LRGLENGTH + 128);
+    buf = (char*)malloc(BENCH_CREATE_LRGLENGTH);
+    e = (oids == NULL || lengths == NULL || dataPtrs == NULL || data == NULL || buf == NULL) ?
+        eMEMALLOCFAILED_EDUOM : eNOERROR;
+
+    if (e == eNOERROR) {
+        for (i = 0; i < BENCH_CREATE_LRGLENGTH + 128; i++) data[i] = i % 251;
+
+        printf("create: %ld objects of 8..107 bytes, %ld per CreateObjects call\n",
+               (long)BENCH_CREATE_NOBJECTS, (long)BENCH_CREATE_BATCH);
+        printf("    %-32s %12s\n", "method", "ns/object");
+
+        e = SM_CreateFile(volId, &fid, FALSE, NULL);
+        if (e == eNOERROR)
+            e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObj);
+    }
+
+    for (m = 0; e == eNOERROR && m < sizeof(methods) / sizeof(methods[0]); m++) {
+        n = (m < 3) ? BENCH_CREATE_NOBJECTS : BENCH_CREATE_NMIXED;
+        for (i = 0; i < n; i++) {
+            lengths[i] = (m == 3 && i % BENCH_CREATE_LRGEVERY == BENCH_CREATE_LRGEVERY - 1) ?
+                BENCH_CREATE_LRGLENGTH : 8 + i % 100;
+            dataPtrs[i] = &data[i % 128];
+        }
+
+        e = bench_CreateRun(&catObj, (m < 3) ? m : 2, n, lengths, dataPtrs, oids, buf, &seconds);
+        if (e == eNOERROR)
+            printf("    %-32s %12.1f\n", methods[m], seconds / n * 1e9);
+    }
+
+    if (e == eNOERROR)
+        e = SM_DestroyFile(&fid, NULL);
+
+    free(oids);
+    free(lengths);
+    free(dataPtrs);
+    free(data);
+    free(buf);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_Create() */
+
+
+
+/*@================================
+ * bench_Scan()
+ *================================*/
+/*
+ * Function: static Four bench_Scan(Four)
+ *
+ * Description:
+ *  Scan a file of small objects, every 7th of them destroyed, with each
+ *  scan method and print the number of objects returned per second. The
+ *  number of objects of every scan, and the data returned by
+ *  EduOM_NextObjects(), are checked.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - a scan returned a wrong result
+ *    some errors caused by function calls
+ */
+static Four bench_Scan(
+    Four	volId)		/* IN volume of the file */
+{
+    Four	e;		/* for errors */
+    Four	r;		/* index of the scan */
+    Four	m;		/* index of the scan method */
+    Four	k;		/* index in the batch */
+    Four	n;		/* # of objects in the batch */
+    Four	nLeft;		/* # of objects in the file */
+    Four	count;		/* # of objects returned by the scans */
+    Four	nBad;		/* # of objects returned with wrong data */
+    FileID	fid;		/* file scanned */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oid;		/* object returned */
+    ObjectHdr	objHdr;		/* header of the object returned */
+    EduOM_ScanCursor cursor;	/* scan cursor */
+    ObjectID	*oids;		/* objects created */
+    ObjectID	batchOids[BENCH_SCAN_BATCH];	/* objects of a batch */
+    ObjectHdr	batchHdrs[BENCH_SCAN_BATCH];	/* headers of a batch */
+    char	*batchData[BENCH_SCAN_BATCH];	/* data of a batch */
+    double	seconds;	/* time taken */
+    char	*methods[] = { "OM_NextObject", "EduOM_ScanNext", "EduOM_NextObjects", "EduOM_NextObjects, IDs only" };
+
+
+    oids = (ObjectID*)malloc(BENCH_SCAN_NOBJECTS * sizeof(ObjectID));
+    if (oids == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+    nLeft = bench_CreateFile(volId, BENCH_SCAN_NOBJECTS, 8, "abcdefgh", 7, &fid, &catObj, oids);
+    free(oids);
+    if (nLeft < eNOERROR) ERR(nLeft);
+
+    printf("scan: %ld full scans of %ld 8-byte objects\n", (long)BENCH_SCAN_NSCANS, (long)nLeft);
+    printf("    %-28s %12s\n", "method", "Mobjects/s");
+
+    for (m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+        count = 0;
+        nBad = 0;
+        seconds = bench_Now();
+        for (r = 0; r < BENCH_SCAN_NSCANS; r++) {
+            if (m == 0) {
+                for (e = OM_NextObject(&catObj, NULL, &oid, &objHdr); e >= eNOERROR && e != EOS;
+                     e = OM_NextObject(&catObj, &oid, &oid, &objHdr))
+                    count++;
+                if (e < eNOERROR) ERR(e);
+                continue;
+            }
+
+            e = EduOM_OpenScan(&catObj, &cursor);
+            if (e < eNOERROR) ERR(e);
+            if (m == 1)
+                while ((e = EduOM_ScanNext(&cursor, &oid, &objHdr)) == eNOERROR) count++;
+            else if (m == 2) {
+                while ((e = EduOM_NextObjects(&cursor, BENCH_SCAN_BATCH, batchOids, batchHdrs, batchData, &n)) == eNOERROR)
+                    for (k = 0; k < n; k++, count++)
+                        if (batchHdrs[k].length != 8 || batchData[k][0] != 'a') nBad++;
+            }
+            else
+                while ((e = EduOM_NextObjects(&cursor, BENCH_SCAN_BATCH, batchOids, NULL, NULL, &n)) == eNOERROR)
+                    count += n;
+            if (e < eNOERROR) ERR(e);
+            e = EduOM_CloseScan(&cursor);
+            if (e < eNOERROR) ERR(e);
+        }
+        seconds = bench_Now() - seconds;
+
+        if (count != nLeft * BENCH_SCAN_NSCANS || nBad > 0) ERR(eBADPARAMETER_OM);
+
+        printf("    %-28s %12.1f\n", methods[m], count / seconds / 1e6);
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_Scan() */
+
+
+
+/*@================================
+ * bench_Pin()
+ *================================*/
+/*
+ * Function: static Four bench_Pin(Four)
+ *
+ * Description:
+ *  For each object size, look up objects in turn by copying them with
+ *  EduOM_ReadObject() and by pinning them, and print the time per lookup.
+ *  Each lookup reads one byte of the object; the sums of the bytes read
+ *  by both methods are checked to be the same.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - the methods read different data
+ *    some errors caused by function calls
+ */
+static Four bench_Pin(
+    Four	volId)		/* IN volume of the file */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	s;		/* index of the object size */
+    Four	len;		/* length of the object pinned */
+    Four	sizes[] = { 100, 500, 1000, 2000 };	/* object sizes benchmarked */
+    FileID	fid;		/* file of the objects */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oids[BENCH_PIN_NOBJECTS];	/* objects looked up */
+    EduOM_PinHandle handle;	/* handle of the object pinned */
+    char	*data;		/* data of the object pinned */
+    char	buf[BENCH_PIN_MAXLENGTH];	/* data of the objects */
+    long	sumRead;	/* sum of the bytes read by copying */
+    long	sumPin;		/* sum of the bytes read by pinning */
+    double	readSeconds;	/* time taken by copying */
+    double	pinSeconds;	/* time taken by pinning */
+
+
+    for (i = 0; i < BENCH_PIN_MAXLENGTH; i++) buf[i] = i % 251;
+
+    e = SM_CreateFile(volId, &fid, FALSE, NULL);
+    if (e < eNOERROR) ERR(e);
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObj);
+    if (e < eNOERROR) ERR(e);
+
+    printf("pin: %ld lookups over %ld objects of each size\n", (long)BENCH_PIN_NLOOKUPS, (long)BENCH_PIN_NOBJECTS);
+    printf("    %8s %18s %18s\n", "bytes", "ReadObject ns", "Pin+Unpin ns");
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (i = 0; i < BENCH_PIN_NOBJECTS; i++) {
+            e = EduOM_CreateObject(&catObj, (i > 0) ? &oids[i-1] : NULL, NULL, sizes[s], buf, &oids[i]);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        sumRead = 0;
+        readSeconds = bench_Now();
+        for (i = 0; i < BENCH_PIN_NLOOKUPS; i++) {
+            e = EduOM_ReadObject(&oids[i % BENCH_PIN_NOBJECTS], 0, REMAINDER, buf);
+            if (e < eNOERROR) ERR(e);
+            sumRead += buf[e / 2];
+        }
+        readSeconds = bench_Now() - readSeconds;
+
+        sumPin = 0;
+        pinSeconds = bench_Now();
+        for (i = 0; i < BENCH_PIN_NLOOKUPS; i++) {
+            e = EduOM_PinObject(&oids[i % BENCH_PIN_NOBJECTS], &data, &len, &handle);
+            if (e < eNOERROR) ERR(e);
+            sumPin += data[len / 2];
+            e = EduOM_UnpinObject(&handle);
+            if (e < eNOERROR) ERR(e);
+        }
+        pinSeconds = bench_Now() - pinSeconds;
+
+        if (sumRead != sumPin) ERR(eBADPARAMETER_OM);
+
+        printf("    %8ld %18.1f %18.1f\n", (long)sizes[s],
+               readSeconds / BENCH_PIN_NLOOKUPS * 1e9, pinSeconds / BENCH_PIN_NLOOKUPS * 1e9);
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_Pin() */
+
+
+
+/*@================================
+ * bench_ScanObject()
+ *================================*/
+/*
+ * Function: static Four bench_ScanObject(void*, ObjectID*, ObjectHdr*, char*)
+ *
+ * Description:
+ *  Hash the data of the object BENCH_PSCAN_WORK times and add its first
+ *  byte to the sums of the worker.
+ *
+ * Returns:
+ *  eNOERROR
+ */
+static Four bench_ScanObject(
+    void	*arg,		/* INOUT sums of the worker */
+    ObjectID	*oid,		/* IN object scanned */
+    ObjectHdr	*objHdr,	/* IN header of the object */
+    char	*data)		/* IN data of the object */
+{
+    bench_ScanSums *sums = (bench_ScanSums*)arg; /* sums of the worker */
+    Four	i, k;		/* loop indices */
+
+
+    for (k = 0; k < BENCH_PSCAN_WORK; k++)
+        for (i = 0; i < objHdr->length; i++)
+            sums->hash = sums->hash * 31 + data[i];
+    sums->sum += data[0];
+
+    return(eNOERROR);
+
+}  /* bench_ScanObject() */
+
+
+
+/*@================================
+ * bench_ParallelScan()
+ *================================*/
+/*
+ * Function: static Four bench_ParallelScan(Four)
+ *
+ * Description:
+ *  Scan a file of small objects, every 5th of them destroyed, calling
+ *  bench_ScanObject() on each object by a scan cursor with pinning in
+ *  the calling thread, and by EduOM_ParallelScan() with 1, 2, 4 and 8
+ *  workers, and print the time taken. The sums and the numbers of
+ *  objects of the workers are checked against the single thread.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - a scan returned a wrong result
+ *    some errors caused by function calls
+ */
+static Four bench_ParallelScan(
+    Four	volId)		/* IN volume of the file */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	w;		/* index of the worker */
+    Four	nWorkers;	/* # of workers */
+    Four	nLeft;		/* # of objects in the file */
+    Four	len;		/* length of the object pinned */
+    Four	count;		/* # of objects scanned */
+    Four	nObjects[OM_PARALLELSCAN_MAXWORKERS];	/* # of objects scanned by each worker */
+    FileID	fid;		/* file scanned */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oid;		/* object returned */
+    ObjectHdr	objHdr;		/* header of the object returned */
+    EduOM_ScanCursor cursor;	/* scan cursor */
+    EduOM_PinHandle handle;	/* handle of the object pinned */
+    ObjectID	*oids;		/* objects created */
+    char	*data;		/* data of the object pinned */
+    char	buf[32];	/* data of the objects */
+    bench_ScanSums serial;	/* sums of the single thread */
+    bench_ScanSums sums[OM_PARALLELSCAN_MAXWORKERS];	/* sums of the workers */
+    void	*args[OM_PARALLELSCAN_MAXWORKERS];	/* arguments of the workers */
+    long	sum;		/* sum of the workers */
+    double	seconds;	/* time taken */
+
+
+    for (i = 0; i < sizeof(buf); i++) buf[i] = 'A' + i;
+
+    oids = (ObjectID*)malloc(BENCH_PSCAN_NOBJECTS * sizeof(ObjectID));
+    if (oids == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+    nLeft = bench_CreateFile(volId, BENCH_PSCAN_NOBJECTS, sizeof(buf), buf, 5, &fid, &catObj, oids);
+    free(oids);
+    if (nLeft < eNOERROR) ERR(nLeft);
+
+    printf("parallel scan: %ld %ld-byte objects, %ld hashing passes over each, %ld cores online\n",
+           (long)nLeft, (long)sizeof(buf), (long)BENCH_PSCAN_WORK, (long)sysconf(_SC_NPROCESSORS_ONLN));
+    printf("    %8s %10s\n", "workers", "ms");
+
+    memset(&serial, 0, sizeof(serial));
+    count = 0;
+    seconds = bench_Now();
+    e = EduOM_OpenScan(&catObj, &cursor);
+    if (e < eNOERROR) ERR(e);
+    while ((e = EduOM_ScanNext(&cursor, &oid, &objHdr)) == eNOERROR) {
+        e = EduOM_PinObject(&oid, &data, &len, &handle);
+        if (e < eNOERROR) ERR(e);
+        bench_ScanObject(&serial, &oid, &objHdr, data);
+        e = EduOM_UnpinObject(&handle);
+        if (e < eNOERROR) ERR(e);
+        count++;
+    }
+    if (e < eNOERROR) ERR(e);
+    e = EduOM_CloseScan(&cursor);
+    if (e < eNOERROR) ERR(e);
+    seconds = bench_Now() - seconds;
+
+    if (count != nLeft) ERR(eBADPARAMETER_OM);
+
+    printf("    %8s %10.1f\n", "serial", seconds * 1e3);
+
+    for (nWorkers = 1; nWorkers <= 8; nWorkers *= 2) {
+        memset(sums, 0, sizeof(sums));
+        for (w = 0; w < nWorkers; w++) args[w] = &sums[w];
+
+        seconds = bench_Now();
+        e = EduOM_ParallelScan(&catObj, nWorkers, bench_ScanObject, args, nObjects);
+        if (e < eNOERROR) ERR(e);
+        seconds = bench_Now() - seconds;
+
+        for (sum = 0, count = 0, w = 0; w < nWorkers; w++) {
+            sum += sums[w].sum;
+            count += nObjects[w];
+        }
+        if (sum != serial.sum || count != nLeft) ERR(eBADPARAMETER_OM);
+
+        printf("    %8ld %10.1f\n", (long)nWorkers, seconds * 1e3);
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_ParallelScan() */
+
+
+
+/*@================================
+ * bench_FillPage()
+ *================================*/
+/*
+ * Function: static void bench_FillPage(SlottedPage*)
+ *
+ * Description:
+ *  Fill the page, in memory, with objects of 20 to 219 bytes until the
+ *  next one does not fit.
+ *
+ * Returns:
+ *  None
+ */
+static void bench_FillPage(
+    SlottedPage	*apage)		/* OUT page filled */
+{
+    Object	*obj;		/* object added */
+    Four	length;		/* length of the object added */
+    Two		i;		/* slot of the object added */
+
+
+    memset(apage, 0, sizeof(SlottedPage));
+    apage->header.flags = SLOTTED_PAGE_TYPE;
+    apage->header.reserved = NIL;
+
+    for (i = 0; ; i++) {
+        length = 20 + rand() % 200;
+        apage->header.nSlots = i + 1;
+        if (sizeof(ObjectHdr) + ALIGNED_LENGTH(length) > SP_CFREE(apage)) break;
+
+        apage->slot[-i].offset = apage->header.free;
+        apage->slot[-i].unique = i;
+        obj = (Object*)&(apage->data[apage->header.free]);
+        obj->header.properties = P_CLEAR;
+        obj->header.tag = 0;
+        obj->header.length = length;
+        memset(obj->data, 'a' + i % 26, length);
+        apage->header.free += sizeof(ObjectHdr) + ALIGNED_LENGTH(length);
+    }
+    apage->header.nSlots = i;
+
+}  /* bench_FillPage() */
+
+
+
+/*@================================
+ * bench_EmptySlot()
+ *================================*/
+/*
+ * Function: static void bench_EmptySlot(SlottedPage*, Two)
+ *
+ * Description:
+ *  Destroy the object of the slot in the page, in memory, leaving a hole.
+ *
+ * Returns:
+ *  None
+ */
+static void bench_EmptySlot(
+    SlottedPage	*apage,		/* INOUT page of the slot */
+    Two		slotNo)		/* IN slot emptied */
+{
+    Object	*obj;		/* object destroyed */
+
+
+    if (apage->slot[-slotNo].offset == EMPTYSLOT) return;
+
+    obj = (Object*)&(apage->data[apage->slot[-slotNo].offset]);
+    apage->header.unused += sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
+    apage->slot[-slotNo].offset = EMPTYSLOT;
+
+}  /* bench_EmptySlot() */
+
+
+
+/*@================================
+ * bench_CheckCompaction()
+ *================================*/
+/*
+ * Function: static Four bench_CheckCompaction(SlottedPage*, SlottedPage*, Two, Four*)
+ *
+ * Description:
+ *  Check that the compacted page has every object of the page in its
+ *  slot and no unused bytes, with the object of 'slotNo', if not NIL, at
+ *  the end of the data area, and count the bytes of the objects moved.
+ *
+ * Returns:
+ *  bytes of the objects in the page, or an error code
+ *    eBADPARAMETER_OM - the compacted page is wrong
+ */
+static Four bench_CheckCompaction(
+    SlottedPage	*apage,		/* IN page with holes */
+    SlottedPage	*cpage,		/* IN page compacted */
+    Two		slotNo,		/* IN slot whose object is to be the last one */
+    Four	*moved)		/* OUT bytes of the objects moved, if not NULL */
+{
+    Four	live;		/* bytes of objects in the page */
+    Four	len;		/* length of an object in the page */
+    Object	*obj;		/* object of the page */
+    Two		i;		/* slot index */
+
+
+    if (cpage->header.unused != 0 || cpage->header.free != apage->header.free - apage->header.unused)
+        ERR(eBADPARAMETER_OM);
+
+    if (moved != NULL) *moved = 0;
+    live = 0;
+    for (i = 0; i < apage->header.nSlots; i++) {
+        if (apage->slot[-i].offset == EMPTYSLOT) continue;
+        obj = (Object*)&(apage->data[apage->slot[-i].offset]);
+        len = sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
+        if (memcmp(&(cpage->data[cpage->slot[-i].offset]), (char*)obj, len) != 0) ERR(eBADPARAMETER_OM);
+        if (i == slotNo && cpage->slot[-i].offset + len != cpage->header.free) ERR(eBADPARAMETER_OM);
+        if (moved != NULL && cpage->slot[-i].offset != apage->slot[-i].offset) *moved += len;
+        live += len;
+    }
+
+    return(live);
+
+}  /* bench_CheckCompaction() */
+
+
+
+/*@================================
+ * bench_Compaction()
+ *================================*/
+/*
+ * Function: static Four bench_Compaction(void)
+ *
+ * Description:
+ *  For full pages with one hole at the front, in the middle or at the
+ *  end, and with every 5th object destroyed, also with the object of
+ *  slot 1 to go to the end, compact a copy of the page
+ *  many times by EduOM_CompactPage() and by OM_CompactPage(), and print
+ *  the time per call and the bytes of objects moved. OM_CompactPage()
+ *  copies the whole page and then every object back. Whether
+ *  EduOM_CompactPageIfNeeded() compacts the page for a 'minGain' of
+ *  BENCH_COMPACT_MINGAIN is printed as well. Both compactions are checked
+ *  to give every slot its object and the same contiguous free space.
+ *  The times include copying the page. OM_CompactPage() is prebuilt with
+ *  optimization, so compare the times with the -O2 CFLAGS of the Makefile:
+ *      make clean; make bench CFLAGS="-w -O2 -fsigned-char -fPIC -fcommon -I./Header"
+ *  The table says whether this module was built with optimization.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - a compaction gave a wrong page
+ *    some errors caused by function calls
+ */
+static Four bench_Compaction(void)
+{
+    Four	e;		/* for errors */
+    Four	c;		/* index of the page */
+    Four	r;		/* index of the compaction */
+    Two		i;		/* slot index */
+    Two		slotNo;		/* slot whose object goes to the end, or NIL */
+    Four	moved;		/* bytes of objects moved by EduOM_CompactPage() */
+    Four	live;		/* bytes of objects in the page */
+    Boolean	compacted;	/* TRUE if EduOM_CompactPageIfNeeded() compacted the page */
+    double	eduomSeconds;	/* time taken by EduOM_CompactPage() */
+    double	omSeconds;	/* time taken by OM_CompactPage() */
+    SlottedPage	*pages;		/* page with holes, and its copies compacted by each method */
+    char	*cases[] = { "one hole at the front", "one hole in the middle", "one hole at the end", "every 5th object",
+                           "every 5th, slot 1 last" };
+
+
+    pages = (SlottedPage*)malloc(3 * sizeof(SlottedPage));
+    if (pages == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+#ifdef __OPTIMIZE__
+    printf("compaction: %ld compactions of a copy of each page, EduOM optimized\n", (long)BENCH_COMPACT_NCALLS);
+#else
+    printf("compaction: %ld compactions of a copy of each page, EduOM not optimized\n", (long)BENCH_COMPACT_NCALLS);
+#endif
+    printf("    %-24s %10s %10s %12s %12s %10s\n",
+           "holes", "EduOM ns", "OM ns", "EduOM bytes", "OM bytes", "IfNeeded");
+
+    srand(3);
+    for (c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        bench_FillPage(&pages[0]);
+        if (c == 0)
+            bench_EmptySlot(&pages[0], 0);
+        else if (c == 1)
+            bench_EmptySlot(&pages[0], pages[0].header.nSlots / 2);
+        else if (c == 2)
+            bench_EmptySlot(&pages[0], pages[0].header.nSlots - 2);
+        else
+            for (i = 0; i < pages[0].header.nSlots - 1; i += 5) bench_EmptySlot(&pages[0], i);
+        slotNo = (c == 4) ? 1 : NIL;
+
+        eduomSeconds = bench_Now();
+        for (r = 0; r < BENCH_COMPACT_NCALLS; r++) {
+            pages[1] = pages[0];
+            e = EduOM_CompactPage(&pages[1], slotNo);
+            if (e < eNOERROR) ERR(e);
+        }
+        eduomSeconds = bench_Now() - eduomSeconds;
+
+        omSeconds = bench_Now();
+        for (r = 0; r < BENCH_COMPACT_NCALLS; r++) {
+            pages[2] = pages[0];
+            e = OM_CompactPage(&pages[2], slotNo);
+            if (e < eNOERROR) ERR(e);
+        }
+        omSeconds = bench_Now() - omSeconds;
+
+        live = bench_CheckCompaction(&pages[0], &pages[1], slotNo, &moved);
+        if (live < eNOERROR) ERR(live);
+        e = bench_CheckCompaction(&pages[0], &pages[2], slotNo, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduOM_CompactPageIfNeeded(&pages[0], BENCH_COMPACT_MINGAIN, &compacted);
+        if (e < eNOERROR) ERR(e);
+
+        printf("    %-24s %10.1f %10.1f %12ld %12ld %10s\n", cases[c],
+               eduomSeconds / BENCH_COMPACT_NCALLS * 1e9, omSeconds / BENCH_COMPACT_NCALLS * 1e9,
+               (long)moved, (long)(PAGESIZE + live), compacted ? "yes" : "no");
+    }
+
+    free(pages);
+
+    return(eNOERROR);
+
+}  /* bench_Compaction() */
+
+
+
+/*@================================
+ * bench_OpenFile()
+ *================================*/
+/*
+ * Function: static Four bench_OpenFile(Four)
+ *
+ * Description:
+ *  Create a file of small objects of 20..199 bytes, and then, for a few
+ *  rounds, destroy half of them, create them again and update the other
+ *  half to new lengths. This is done once with the file closed and once,
+ *  on another file, with the file opened by EduOM_OpenFile(), and the
+ *  time per destroy, create and update is printed. The number of pages
+ *  in the available space lists of both files, walked from the heads in
+ *  their catalog objects after the open file is closed, is checked to be
+ *  the same.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - the files have different available space lists
+ *    some errors caused by function calls
+ */
+static Four bench_OpenFile(
+    Four	volId)		/* IN volume of the files */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	m;		/* 0 for the closed file, 1 for the open one */
+    Four	r;		/* round */
+    Four	k;		/* index of the available space list */
+    Four	nListed[2];	/* # of pages in the available space lists of each file */
+    FileID	fid;		/* file of the objects */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	*oids;		/* objects of the file */
+    ObjectHdr	objHdr;		/* header of the objects created */
+    char	*data;		/* data of the objects */
+    double	seconds[3];	/* time taken by the destroys, the creates and the updates */
+    double	start;		/* start of the calls timed */
+    PageID	pid;		/* page in an available space list */
+    SlottedPage	*apage;		/* buffer holding the page */
+    SlottedPage	*catPage;	/* buffer holding the catalog object */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+    ShortPageID	heads[5];	/* heads of the available space lists */
+    char	*modes[] = { "closed", "EduOM_OpenFile" };
+
+
+    oids = (ObjectID*)malloc(BENCH_OPEN_NOBJECTS * sizeof(ObjectID));
+    data = (char*)malloc(200);
+    if (oids == NULL || data == NULL) {
+        free(oids);
+        free(data);
+        ERR(eMEMALLOCFAILED_EDUOM);
+    }
+    for (i = 0; i < 200; i++) data[i] = i;
+    objHdr.properties = 0;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+
+    printf("open file: %ld objects of 20..199 bytes, half destroyed, created again and updated %ld times\n",
+           (long)BENCH_OPEN_NOBJECTS, (long)BENCH_OPEN_NROUNDS);
+    printf("    %-16s %12s %12s %12s %8s\n", "file", "destroy ns", "create ns", "update ns", "listed");
+
+    for (m = 0, e = eNOERROR; e == eNOERROR && m < 2; m++) {
+        e = SM_CreateFile(volId, &fid, FALSE, NULL);
+        if (e == eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObj);
+        if (e == eNOERROR && m == 1) e = EduOM_OpenFile(&catObj);
+
+        for (i = 0; e == eNOERROR && i < BENCH_OPEN_NOBJECTS; i++)
+            e = EduOM_CreateObject(&catObj, NULL, &objHdr, 20 + i * 37 % 180, data, &oids[i]);
+
+        seconds[0] = seconds[1] = seconds[2] = 0;
+        for (r = 0; e == eNOERROR && r < BENCH_OPEN_NROUNDS; r++) {
+            start = bench_Now();
+            for (i = r % 2; e == eNOERROR && i < BENCH_OPEN_NOBJECTS; i += 2)
+                e = EduOM_DestroyObject(&catObj, &oids[i], &dlPool, &dlHead);
+            seconds[0] += bench_Now() - start;
+
+            start = bench_Now();
+            for (i = r % 2; e == eNOERROR && i < BENCH_OPEN_NOBJECTS; i += 2)
+                e = EduOM_CreateObject(&catObj, NULL, &objHdr, 20 + (i + r) * 37 % 180, data, &oids[i]);
+            seconds[1] += bench_Now() - start;
+
+            start = bench_Now();
+            for (i = 1 - r % 2; e == eNOERROR && i < BENCH_OPEN_NOBJECTS; i += 2)
+                e = EduOM_UpdateObject(&catObj, &oids[i], 20 + (i + r) * 37 % 180, data, &dlPool, &dlHead);
+            seconds[2] += bench_Now() - start;
+        }
+
+        if (e == eNOERROR && m == 1) e = EduOM_CloseFile(&catObj);
+
+        /* walk the lists from the heads in the catalog object */
+        if (e == eNOERROR) e = BfM_GetTrain((TrainID*)&catObj, (char**)&catPage, PAGE_BUF);
+        if (e == eNOERROR) {
+            GET_PTR_TO_CATENTRY_FOR_DATA((&catObj), catPage, catEntry);
+            heads[0] = catEntry->availSpaceList10;
+            heads[1] = catEntry->availSpaceList20;
+            heads[2] = catEntry->availSpaceList30;
+            heads[3] = catEntry->availSpaceList40;
+            heads[4] = catEntry->availSpaceList50;
+            e = BfM_FreeTrain((TrainID*)&catObj, PAGE_BUF);
+        }
+        nListed[m] = 0;
+        for (k = 0; e == eNOERROR && k < 5; k++) {
+            MAKE_PAGEID(pid, catObj.volNo, heads[k]);
+            while (e == eNOERROR && pid.pageNo != NIL) {
+                e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+                if (e < eNOERROR) break;
+                nListed[m]++;
+                pid.pageNo = apage->header.spaceListNext;
+                e = BfM_FreeTrain((TrainID*)&apage->header.pid, PAGE_BUF);
+            }
+        }
+
+        if (e == eNOERROR)
+            printf("    %-16s %12.1f %12.1f %12.1f %8ld\n", modes[m],
+                   seconds[0] / (BENCH_OPEN_NROUNDS * BENCH_OPEN_NOBJECTS / 2) * 1e9,
+                   seconds[1] / (BENCH_OPEN_NROUNDS * BENCH_OPEN_NOBJECTS / 2) * 1e9,
+                   seconds[2] / (BENCH_OPEN_NROUNDS * BENCH_OPEN_NOBJECTS / 2) * 1e9, (long)nListed[m]);
+    }
+
+    if (e == eNOERROR && nListed[0] != nListed[1]) e = eBADPARAMETER_OM;
+
+    free(oids);
+    free(data);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* bench_OpenFile() */
+
+
+
+/*@================================
+ * EduOM_Test()
+ *================================*/
+/*
+ * Function: Four EduOM_Test(Four, Four)
+ *
+ * Description:
+ *  Run the benchmark named by the environment variable EDUOM_BENCH and
+ *  print its results. Each benchmark runs in a process of its own on a
+ *  newly formatted volume, because the pages of the files destroyed by a
+ *  benchmark are not given back before the transaction commits. If the
+ *  benchmark is unknown or failed, the process exits with status 1 so
+ *  that 'make bench' fails.
+ *
+ * Returns:
+ *  error code
+ */
+Four EduOM_Test(
+    Four	volId,		/* IN volume of the files */
+    Four	handle)		/* IN handle of the volume */
+{
+    Four	e;		/* for errors */
+    char	*name;		/* name of the benchmark */
+
+
+    name = getenv("EDUOM_BENCH");
+    if (name == NULL) name = "";
+
+    if (strcmp(name, "create") == 0)
+        e = bench_Create(volId);
+    else if (strcmp(name, "scan") == 0)
+        e = bench_Scan(volId);
+    else if (strcmp(name, "pin") == 0)
+        e = bench_Pin(volId);
+    else if (strcmp(name, "pscan") == 0)
+        e = bench_ParallelScan(volId);
+    else if (strcmp(name, "compaction") == 0)
+        e = bench_Compaction();
+    else if (strcmp(name, "openfile") == 0)
+        e = bench_OpenFile(volId);
+    else {
+        printf("EDUOM_BENCH must be one of create, scan, pin, pscan, compaction and openfile\n");
+        exit(1);
+    }
+
+    if (e < eNOERROR) {
+        printf("%s benchmark failed: %ld\n", name, (long)e);
+        exit(1);
+    }
+
+    return(eNOERROR);
+
+}  /* EduOM_Test() */
@@ -59,6 +59,7 @@
  */
 
 
+#include <stdlib.h>
 #include <string.h>
 #include "EduOM_common.h"
 #include "LOT.h"
@@ -81,21 +82,33 @@
  *  in the page are located contiguously "in the middle", between the tuples
  *  and the slot array. To compress out holes, objects must be moved toward
  *  the beginning of the page.
+ *  The objects are slid down in place in the order of their offsets, so
+ *  the objects before the first hole are not moved at all and the page is
+ *  not copied. Objects which lie next to each other are moved together by
+ *  one memmove(). The object in the slot 'slotNo', if not NIL, is put at
+ *  the end of the data area; it is staged in the contiguous free space of
+ *  the page if it fits there, and in a buffer of its own size otherwise.
  *
  *  (2) How to do?
- *  a. Save the given page into the temporary page
- *  b. FOR each nonempty slot DO
- *	Fill the original page by copying the object from the saved page
- *          to the data area of original page pointed by 'apageDataOffset'
- *	Update the slot offset
+ *  a. Sort the nonempty slots but 'slotNo' by the offsets of their objects
+ *  b. IF the object of 'slotNo' is not the last one THEN
+ *	Save it at the free end of the page or into a temporary buffer
+ *     ENDIF
+ *  c. FOR each slot in the order of offsets DO
+ *	IF the object does not follow the previous one THEN
+ *	    Move the run of objects so far down to its place
+ *	ENDIF
+ *	Update the slot offset to 'apageDataOffset'
  *	Get 'apageDataOffet' to point the next moved position
  *     ENDFOR
- *   c. Update the 'freeStart' and 'unused' field of the page
- *   d. Return
+ *  d. Move the last run down and put the object of 'slotNo' after it
+ *  e. Update the 'freeStart' and 'unused' field of the page
+ *  f. Return
  *	
  * Returns:
  *  error code
  *    eNOERROR
+ *    eMEMALLOCFAILED_EDUOM
  *
  * Side Effects :
  *  The slotted page is reorganized to comact the space.
@@ -105,33 +118,90 @@ Four EduOM_CompactPage(
     Two         slotNo)		/* IN slotNo to go to the end */
 {
 	/* These local variables are used in the solution code. However, you dont have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
-    SlottedPage	tpage;		/* temporay page used to save the given page */
+    char   *tobj;		/* staged copy of the object of 'slotNo', or NULL */
+    Boolean tobjAllocated;	/* TRUE if 'tobj' is malloc()ed */
+    Two    order[PAGESIZE / sizeof(SlottedPageSlot)]; /* nonempty slots in the order of offsets */
+    Two    offsets[PAGESIZE / sizeof(SlottedPageSlot)]; /* offsets of the objects of 'order' */
+    Two    nObjects;		/* # of slots in 'order' */
     Object *obj;		/* pointer to the object in the data area */
     Two    apageDataOffset;	/* where the next object is to be moved */
+    Two    runSrc;		/* offset of the run of adjacent objects to be moved */
+    Two    runDst;		/* where the run is to be moved */
+    Four   runLen;		/* length of the run */
     Four   len;			/* length of object + length of ObjectHdr */
-    Two    lastSlot;		/* last non empty slot */
+    Four   slotLen;		/* length of the object of 'slotNo' */
+    Two    offset;		/* offset of the object */
     Two    i, j;			/* index variable */
 
-    tpage = *apage;
 
-    apageDataOffset = 0;
-    lastSlot = apage->header.nSlots;
-    for(i=0; i < lastSlot; i++) {
-        if (slotNo == i || tpage.slot[-i].offset == EMPTYSLOT)
+    /*@ sort the slots by offsets; they are mostly in order already */
+    nObjects = 0;
+    for (i = 0; i < apage->header.nSlots; i++) {
+        offset = apage->slot[-i].offset;
+        if (i == slotNo || offset == EMPTYSLOT)
             continue;
-        obj = &(tpage.data[tpage.slot[-i].offset]);
-        len = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
-        memcpy(&(apage->data[apageDataOffset]), (char*)obj, len);
-        apage->slot[-i].offset = apageDataOffset;
-        apageDataOffset += len;
+        for (j = nObjects; j > 0 && offsets[j-1] > offset; j--) {
+            order[j] = order[j-1];
+            offsets[j] = offsets[j-1];
+        }
+        order[j] = i;
+        offsets[j] = offset;
+        nObjects++;
     }
+
+    /*@ keep the object to go to the end unless it is there already */
+    tobj = NULL;
+    tobjAllocated = FALSE;
     if (slotNo != NIL) {
-        obj = &(tpage.data[tpage.slot[-slotNo].offset]);
-        len = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
-        memcpy(&(apage->data[apageDataOffset]), (char*)obj, len);
-        apage->slot[-slotNo].offset = apageDataOffset;
+        offset = apage->slot[-slotNo].offset;
+        obj = (Object*)&(apage->data[offset]);
+        slotLen = OBJ_LENGTH_IN_PAGE(obj);
+        if (nObjects > 0 && offset < offsets[nObjects-1]) {
+            /* the objects only move down, so the free end is left alone */
+            if (SP_CFREE(apage) >= slotLen)
+                tobj = &(apage->data[apage->header.free]);
+            else {
+                tobj = (char*)malloc(slotLen);
+                if (tobj == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+                tobjAllocated = TRUE;
+            }
+            memcpy(tobj, (char*)obj, slotLen);
+        }
+        else {
+            order[nObjects] = slotNo;
+            offsets[nObjects++] = offset;
+        }
+    }
+
+    /*@ slide the objects down a run at a time; the ones before the first hole stay */
+    apageDataOffset = 0;
+    runSrc = runDst = 0;
+    runLen = 0;
+    for (j = 0; j < nObjects; j++) {
+        offset = offsets[j];
+        if (offset != runSrc + runLen) {
+            if (runSrc != runDst)
+                memmove(&(apage->data[runDst]), &(apage->data[runSrc]), runLen);
+            runSrc = offset;
+            runDst = apageDataOffset;
+            runLen = 0;
+        }
+        obj = (Object*)&(apage->data[offset]);
+        len = OBJ_LENGTH_IN_PAGE(obj);
+        apage->slot[-order[j]].offset = apageDataOffset;
+        runLen += len;
         apageDataOffset += len;
     }
+    if (runSrc != runDst)
+        memmove(&(apage->data[runDst]), &(apage->data[runSrc]), runLen);
+
+    if (tobj != NULL) {
+        memmove(&(apage->data[apageDataOffset]), tobj, slotLen);
+        apage->slot[-slotNo].offset = apageDataOffset;
+        apageDataOffset += slotLen;
+        if (tobjAllocated) free(tobj);
+    }
+
     apage->header.free = apageDataOffset;
     apage->header.unused = 0;
 
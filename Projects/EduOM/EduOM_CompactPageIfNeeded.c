@@ -0,0 +1,111 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CompactPageIfNeeded.c
+ *
+ * Description :
+ *  EduOM_CompactPageIfNeeded() compacts a slotted page only when it frees
+ *  enough contiguous space.
+ *
+ * Exports:
+ *  Four EduOM_CompactPageIfNeeded(SlottedPage*, Four, Boolean*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_CompactPageIfNeeded()
+ *================================*/
+/*
+ * Function: Four EduOM_CompactPageIfNeeded(SlottedPage*, Four, Boolean*)
+ *
+ * Description :
+ *  Compact the page by EduOM_CompactPage() only if the holes between its
+ *  objects, which the compaction adds to the contiguous free space, amount
+ *  to 'minGain' bytes or more. A page without holes is never compacted,
+ *  since the compaction would only move its objects.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter compacted
+ *     if not NULL, 'compacted' is set to TRUE if the page has been compacted.
+ */
+Four EduOM_CompactPageIfNeeded(
+    SlottedPage *apage,		/* INOUT slotted page to compact */
+    Four        minGain,	/* IN min # of bytes the compaction has to free */
+    Boolean     *compacted)	/* OUT TRUE if the page has been compacted */
+{
+    Four        e;		/* error number */
+
+
+    /*@ parameter checking */
+    if (apage == NULL) ERR(eBADPARAMETER_OM);
+
+    if (compacted != NULL) *compacted = FALSE;
+
+    if (apage->header.unused == 0 || apage->header.unused < minGain)
+        return(eNOERROR);
+
+    e = EduOM_CompactPage(apage, NIL);
+    if (e < 0) ERR(e);
+
+    if (compacted != NULL) *compacted = TRUE;
+
+    return(eNOERROR);
+
+} /* EduOM_CompactPageIfNeeded() */
@@ -59,6 +59,7 @@
 
 #include "EduOM_common.h"
 #include "EduOM_Internal.h"
+#include "EduOM.h"
 
 
 
@@ -126,9 +127,6 @@ Four EduOM_CreateObject(
 
     if (length > 0 && data == NULL) return(eBADUSERBUF_OM);
 
-	/* Error check whether using not supported functionality by EduOM */
-	if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
-    
     objectHdr.properties = 0;
     objectHdr.length = 0;
     objectHdr.tag = 0;
@@ -136,6 +134,22 @@ Four EduOM_CreateObject(
         objectHdr.tag = objHdr->tag;
     }
 
+    /*
+     * a large object is created empty, and then its data is appended; no
+     * dealloc list is given since the new object has no forwarded record,
+     * which is the only thing LOT_ConvertToLarge() and EduOM_AppendToObject()
+     * destroy
+     */
+    if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) {
+        e = eduom_CreateObject(catObjForFile, nearObj, &objectHdr, 0, NULL, oid);
+        if(e < 0) ERR(e);
+
+        e = EduOM_AppendToObject(catObjForFile, oid, length, data, NULL, NULL);
+        if(e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
     eduom_CreateObject(catObjForFile, nearObj, &objectHdr, length, data, oid);
     
     return(eNOERROR);
@@ -0,0 +1,145 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CreateObjects.c
+ * 
+ * Description :
+ *  EduOM_CreateObjects() creates new objects in a row near the specified
+ *  object.
+ *
+ * Exports:
+ *  Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_CreateObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ * 
+ * Description :
+ *  EduOM_CreateObjects() creates 'nObjects' new objects as
+ *  EduOM_CreateObject() does for each of them, but in one call. The
+ *  objects are put one after another into the page holding the near
+ *  object, or into the last page of the file if 'nearObj' is NULL, and
+ *  then into new pages appended behind it, so that bulk loading does not
+ *  pay the per object costs of the catalog and page fixes and of the
+ *  available space list updates.
+ *  A large object is created by EduOM_CreateObject() between the runs of
+ *  small objects around it, so the objects keep the order of the arrays.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    some error codes from the lower level
+ *
+ * Side Effects :
+ *  0) New objects are created.
+ *  1) parameter oids
+ *     oids[i] is set to the ObjectID of the i-th object created.
+ */
+Four EduOM_CreateObjects(
+    ObjectID  *catObjForFile,	/* IN file in which objects are to be placed */
+    ObjectID  *nearObj,		/* IN create the new objects near this object */
+    Four      nObjects,		/* IN # of objects to create */
+    ObjectHdr *objHdrs,		/* IN from which tags are to be set; may be NULL */
+    Four      *lengths,		/* IN amount of data of each object */
+    char      **data,		/* IN the initial data of each object */
+    ObjectID  *oids)		/* OUT the objects' ObjectIDs */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Four        first;		/* first object of the run of small objects */
+    ObjectID    *near;		/* object near which the next objects are created */
+
+
+    /*@ parameter checking */
+    
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nObjects < 0 || (nObjects > 0 && (lengths == NULL || data == NULL || oids == NULL)))
+        ERR(eBADPARAMETER_OM);
+
+    for (i = 0; i < nObjects; i++) {
+        if (lengths[i] < 0) ERR(eBADLENGTH_OM);
+
+        if (lengths[i] > 0 && data[i] == NULL) return(eBADUSERBUF_OM);
+    }
+
+    for (near = nearObj, first = 0, i = 0; i <= nObjects; i++) {
+        if (i < nObjects && ALIGNED_LENGTH(lengths[i]) <= LRGOBJ_THRESHOLD) continue;
+
+        if (i > first) {
+            e = eduom_CreateObjects(catObjForFile, near, i - first, (objHdrs != NULL) ? &objHdrs[first] : NULL,
+                                    &lengths[first], &data[first], &oids[first]);
+            if (e < 0) ERR(e);
+            near = &oids[i - 1];
+        }
+
+        if (i < nObjects) {
+            e = EduOM_CreateObject(catObjForFile, near, (objHdrs != NULL) ? &objHdrs[i] : NULL,
+                                   lengths[i], data[i], &oids[i]);
+            if (e < 0) ERR(e);
+            near = &oids[i];
+        }
+        first = i + 1;
+    }
+    
+    return(eNOERROR);
+}
@@ -54,6 +54,7 @@
  *
  * Exports:
  *  Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*)
+ *  Four eduom_DestroyObject(ObjectID*, ObjectID*, Boolean, Pool*, DeallocListElem*)
  */
 
 #include "EduOM_common.h"
@@ -84,7 +85,8 @@
  *  (2) How to do?
  *  a. Read in the slotted page
  *  b. Remove this page from the 'availSpaceList'
- *  c. Delete the object from the page
+ *  c. Delete the object from the page, dropping the LOT tree of a large object
+ *     or the forwarded record of a moved object
  *  d. Update the control information: 'unused', 'freeStart', 'slot offset'
  *  e. IF no more object in this page THEN
  *	   Remove this page from the filemap List
@@ -94,6 +96,9 @@
  *    ENDIF
  * f. Return
  *
+ *  The forwarded record of a moved object is reached through its stub
+ *  and cannot be destroyed by its own ObjectID.
+ *
  * Returns:
  *  error code
  *    eBADCATALOGOBJECT_OM
@@ -106,6 +111,38 @@ Four EduOM_DestroyObject(
     ObjectID *oid,		/* IN object to destroy */
     Pool     *dlPool,		/* INOUT pool of dealloc list elements */
     DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    return(eduom_DestroyObject(catObjForFile, oid, FALSE, dlPool, dlHead));
+
+} /* EduOM_DestroyObject() */
+
+
+
+/*@================================
+ * eduom_DestroyObject()
+ *================================*/
+/*
+ * Function: Four eduom_DestroyObject(ObjectID*, ObjectID*, Boolean, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  eduom_DestroyObject() does the work of EduOM_DestroyObject(). With
+ *  'forwarded' set it destroys the forwarded record of a moved object,
+ *  and the object must be one; otherwise the object must not be one.
+ *  A stale ObjectID is rejected before the page is changed, so the slot
+ *  is never put on the empty slot list twice.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_DestroyObject(
+    ObjectID *catObjForFile,	/* IN file containing the object */
+    ObjectID *oid,		/* IN object to destroy */
+    Boolean  forwarded,		/* IN TRUE if the object is a forwarded record */
+    Pool     *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
 {
 	/* These local variables are used in the solution code. However, you dont have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four        e;		/* error number */
@@ -113,14 +150,11 @@ Four EduOM_DestroyObject(
     FileID      fid;		/* ID of file where the object was placed */
     PageID	pid;		/* page on which the object resides */
     SlottedPage *apage;		/* pointer to the buffer holding the page */
-    Four        offset;		/* start offset of object in data area */
-    Object      *obj;		/* points to the object in data area */
-    Four        alignedLen;	/* aligned length of object */
     Boolean     last;		/* indicates the object is the last one */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     DeallocListElem *dlElem;	/* pointer to element of dealloc list */
     PhysicalFileID pFid;	/* physical ID of file */
+    Object      *obj;		/* points to the object in data area */
     
     
 
@@ -129,33 +163,30 @@ Four EduOM_DestroyObject(
 
     if (oid == NULL) ERR(eBADOBJECTID_OM);
 
-    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
     if(e < 0) ERR(e);
-    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
 
     MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
     e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
-    if(e < 0) ERR(e);
-    e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
-    if(e < 0) ERRB1(e, &pid, PAGE_BUF);
+    if(e < 0) ERRBC1(e, catObjForFile);
 
-    offset = apage->slot[-(oid->slotNo)].offset;
-    obj = (Object*)&(apage->data[offset]);
-    alignedLen = ALIGNED_LENGTH(obj->header.length);
+    if(oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRBC2(eBADOBJECTID_OM, &pid, PAGE_BUF, catObjForFile);
 
-    apage->slot[-(oid->slotNo)].offset = EMPTYSLOT;
-    if(oid->slotNo == apage->header.nSlots - 1) {
-        apage->header.nSlots -= 1;
-        apage->header.free -= alignedLen + sizeof(ObjectHdr);
-    }
-    else {
-        apage->header.unused += alignedLen + sizeof(ObjectHdr);
-    }
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    if(((obj->header.properties & P_FORWARDED) ? TRUE : FALSE) != forwarded)
+        ERRBC2(eBADOBJECTID_OM, &pid, PAGE_BUF, catObjForFile);
+
+    e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
+    if(e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = eduom_DestroyObjectInPage(catObjForFile, &pid, apage, oid->slotNo, dlPool, dlHead);
+    if(e < 0) ERRB1(e, &pid, PAGE_BUF);
 
     if(apage->header.nSlots == 0 && 
             apage->header.pid.pageNo != catEntry->firstPage) {
-        e = om_FileMapDeletePage(catObjForFile, &pid);
+        e = eduom_FileMapDeletePage(catObjForFile, catEntry, &pid);
         if(e < 0) ERRB1(e, &pid, PAGE_BUF);
         e = Util_getElementFromPool(dlPool, &dlElem);
         if(e < 0) ERR(e);
@@ -166,7 +197,7 @@ Four EduOM_DestroyObject(
         dlHead->next = dlElem;
     }
     else {
-        e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+        e = eduom_PutInAvailSpace(catObjForFile, catEntry, &pid, apage);
         if(e < 0) ERRB1(e, &pid, PAGE_BUF);
     }
     
@@ -174,9 +205,9 @@ Four EduOM_DestroyObject(
     if(e < 0) ERR(e);
     e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
     if(e < 0) ERR(e);
-    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    e = eduom_FreeCatalogEntry(catObjForFile);
     if(e < 0) ERR(e);
 
     return(eNOERROR);
     
-} /* EduOM_DestroyObject() */
+} /* eduom_DestroyObject() */
@@ -0,0 +1,264 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_DestroyObjects.c
+ *
+ * Description :
+ *  EduOM_DestroyObjects() destroys the specified objects in one call.
+ *
+ * Exports:
+ *  Four EduOM_DestroyObjects(ObjectID*, Four, ObjectID*, Pool*, DeallocListElem*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * eduom_CompareObjectID()
+ *================================*/
+/*
+ * Function: static int eduom_CompareObjectID(const void*, const void*)
+ *
+ * Description :
+ *  Order the ObjectIDs by volume, page and slot for qsort().
+ *
+ * Returns:
+ *  negative, zero or positive as the first is before, same as or after
+ *  the second
+ */
+static int eduom_CompareObjectID(
+    const void  *a,		/* IN first ObjectID */
+    const void  *b)		/* IN second ObjectID */
+{
+    const ObjectID *x = (const ObjectID*)a;
+    const ObjectID *y = (const ObjectID*)b;
+
+
+    if (x->volNo != y->volNo) return((x->volNo < y->volNo) ? -1 : 1);
+    if (x->pageNo != y->pageNo) return((x->pageNo < y->pageNo) ? -1 : 1);
+    if (x->slotNo != y->slotNo) return((x->slotNo < y->slotNo) ? -1 : 1);
+
+    return(0);
+
+} /* eduom_CompareObjectID() */
+
+
+
+/*@================================
+ * eduom_DestroyObjectsInPage()
+ *================================*/
+/*
+ * Function: static Four eduom_DestroyObjectsInPage(ObjectID*, sm_CatOverlayForData*, Four, ObjectID*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  Destroy the given objects, all of which are in the same page, fixing
+ *  the page and updating the available space list only once. The page is deallocated if no object is left in it.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+static Four eduom_DestroyObjectsInPage(
+    ObjectID    *catObjForFile,	/* IN file containing the objects */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Four        nObjects,	/* IN # of objects in the page */
+    ObjectID    *oids,		/* IN objects sorted by slot */
+    Pool        *dlPool,	/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    PageID      pid;		/* page holding the objects */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    DeallocListElem *dlElem;	/* pointer to element of dealloc list */
+
+
+    MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    for (i = 0; i < nObjects; i++)
+        if (oids[i].slotNo < 0 || oids[i].slotNo >= apage->header.nSlots ||
+            !IS_VALID_OBJECTID(&oids[i], apage) ||
+            (((Object*)&(apage->data[apage->slot[-oids[i].slotNo].offset]))->header.properties & P_FORWARDED))
+            ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    /* the highest slot first, so that the trailing slots are given back */
+    for (i = nObjects - 1; i >= 0; i--) {
+        e = eduom_DestroyObjectInPage(catObjForFile, &pid, apage, oids[i].slotNo, dlPool, dlHead);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    if (apage->header.nSlots == 0 && apage->header.pid.pageNo != catEntry->firstPage) {
+        e = eduom_FileMapDeletePage(catObjForFile, catEntry, &pid);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        e = Util_getElementFromPool(dlPool, &dlElem);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        dlElem->type = DL_PAGE;
+        dlElem->elem.pid = pid;
+        dlElem->next = dlHead->next;
+        dlHead->next = dlElem;
+    }
+    else {
+        e = eduom_PutInAvailSpace(catObjForFile, catEntry, &pid, apage);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    e = BfM_SetDirty((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_DestroyObjectsInPage() */
+
+
+
+/*@================================
+ * EduOM_DestroyObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_DestroyObjects(ObjectID*, Four, ObjectID*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  EduOM_DestroyObjects() destroys 'nObjects' objects as
+ *  EduOM_DestroyObject() does for each of them, but in one call. The
+ *  objects are sorted by page, so that the catalog page is fixed once for
+ *  the call, and each page is fixed, taken out of and put back into the
+ *  available space list once, however many of the objects are in it. An
+ *  ObjectID given more than once is destroyed once.
+ *  The emptied pages are put into the dealloc list as EduOM_DestroyObject()
+ *  does, to be deallocated together at the end of the transaction.
+ *  If an error occurs, the objects in the pages handled before it remain
+ *  destroyed.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    eMEMALLOCFAILED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_DestroyObjects(
+    ObjectID    *catObjForFile,	/* IN file containing the objects */
+    Four        nObjects,	/* IN # of objects to destroy */
+    ObjectID    *oids,		/* IN objects to destroy */
+    Pool        *dlPool,	/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Four        n;		/* # of distinct objects */
+    Four        first;		/* first object of the page being handled */
+    ObjectID    *sorted;	/* objects sorted by page */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nObjects < 0 || (nObjects > 0 && oids == NULL)) ERR(eBADPARAMETER_OM);
+
+    if (dlPool == NULL || dlHead == NULL) ERR(eBADPARAMETER_OM);
+
+    if (nObjects == 0) return(eNOERROR);
+
+    sorted = (ObjectID*)malloc(nObjects * sizeof(ObjectID));
+    if (sorted == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+    memcpy(sorted, oids, nObjects * sizeof(ObjectID));
+    qsort(sorted, nObjects, sizeof(ObjectID), eduom_CompareObjectID);
+
+    for (n = 0, i = 0; i < nObjects; i++)
+        if (n == 0 || eduom_CompareObjectID(&sorted[n-1], &sorted[i]) != 0 ||
+            sorted[n-1].unique != sorted[i].unique)
+            sorted[n++] = sorted[i];
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) {
+        free(sorted);
+        ERR(e);
+    }
+
+    for (first = 0, i = 1; i <= n; i++) {
+        if (i < n && sorted[i].volNo == sorted[first].volNo && sorted[i].pageNo == sorted[first].pageNo)
+            continue;
+
+        e = eduom_DestroyObjectsInPage(catObjForFile, catEntry, i - first, &sorted[first], dlPool, dlHead);
+        if (e < 0) {
+            free(sorted);
+            ERRBC1(e, catObjForFile);
+        }
+        first = i;
+    }
+
+    free(sorted);
+
+    e = eduom_FreeCatalogEntry(catObjForFile);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_DestroyObjects() */
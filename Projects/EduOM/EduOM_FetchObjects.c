@@ -0,0 +1,359 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_FetchObjects.c
+ *
+ * Description :
+ *  EduOM_FetchObjects() reads the objects of an ObjectID list in the
+ *  physical order of their pages.
+ *
+ * Exports:
+ *  Four EduOM_FetchObjects(Four, ObjectID*, Boolean, EduOM_FetchFunc, void*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+/*@
+ * type definitions
+ */
+/* object of the list with its index in the list */
+typedef struct {
+    ObjectID    oid;            /* object to fetch */
+    Four        index;          /* index of the object in the list */
+} eduom_FetchEntry_T;
+
+/* offsets of the objects copied out which have no data to hand out */
+#define OM_FETCH_NODATA     -1  /* a large or a moved object */
+#define OM_FETCH_BADOID     -2  /* a bad ObjectID */
+
+
+
+/*@================================
+ * eduom_CompareFetchEntry()
+ *================================*/
+/*
+ * Function: static int eduom_CompareFetchEntry(const void*, const void*)
+ *
+ * Description :
+ *  Order the objects of the list by volume and page, and the objects of a
+ *  page by their index in the list, for qsort().
+ *
+ * Returns:
+ *  negative, zero or positive as the first is before, same as or after
+ *  the second
+ */
+static int eduom_CompareFetchEntry(
+    const void  *a,		/* IN first entry */
+    const void  *b)		/* IN second entry */
+{
+    const eduom_FetchEntry_T *x = (const eduom_FetchEntry_T*)a;
+    const eduom_FetchEntry_T *y = (const eduom_FetchEntry_T*)b;
+
+
+    if (x->oid.volNo != y->oid.volNo) return((x->oid.volNo < y->oid.volNo) ? -1 : 1);
+    if (x->oid.pageNo != y->oid.pageNo) return((x->oid.pageNo < y->oid.pageNo) ? -1 : 1);
+    if (x->index != y->index) return((x->index < y->index) ? -1 : 1);
+
+    return(0);
+
+} /* eduom_CompareFetchEntry() */
+
+
+
+/*@================================
+ * eduom_StageObjects()
+ *================================*/
+/*
+ * Function: static Four eduom_StageObjects(Four, eduom_FetchEntry_T*, ObjectHdr*, Four*, char**)
+ *
+ * Description :
+ *  Fix each page of the sorted entries once and copy the headers and the
+ *  data of its objects out, by their indexes in the list. The data are
+ *  packed into '*stage', which is grown by realloc(), and 'offsets[i]' is
+ *  set to where the data of the i-th object start, to OM_FETCH_NODATA for
+ *  a large or a moved object, or to OM_FETCH_BADOID for a bad ObjectID,
+ *  which is reported when its turn in the list comes.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCFAILED_EDUOM
+ *    some errors caused by function calls
+ */
+static Four eduom_StageObjects(
+    Four        nObjects,	/* IN # of objects in the list */
+    eduom_FetchEntry_T *entries, /* IN objects sorted by page */
+    ObjectHdr   *hdrs,		/* OUT headers of the objects by list index */
+    Four        *offsets,	/* OUT offsets of their data in '*stage' */
+    char        **stage)	/* INOUT copies of the data of the objects */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Four        first;		/* first object of the page */
+    Four        used;		/* bytes of '*stage' in use */
+    Four        size;		/* size of '*stage' */
+    Four        index;		/* index of the object in the list */
+    char        *grown;		/* '*stage' after realloc() */
+    ObjectID    *oid;		/* object copied */
+    Object      *obj;		/* object in the page */
+    PageID      pid;		/* page fixed */
+    SlottedPage *apage;		/* buffer holding the page */
+
+
+    used = 0;
+    size = OM_FETCHOBJECTS_STAGESIZE;
+    for (first = 0; first < nObjects; first = i) {
+        MAKE_PAGEID(pid, entries[first].oid.volNo, entries[first].oid.pageNo);
+        e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        for (i = first; i < nObjects && entries[i].oid.volNo == pid.volNo &&
+             entries[i].oid.pageNo == pid.pageNo; i++) {
+            oid = &entries[i].oid;
+            index = entries[i].index;
+            if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage)) {
+                offsets[index] = OM_FETCH_BADOID;
+                continue;
+            }
+
+            obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+            hdrs[index] = obj->header;
+            if (obj->header.properties & (P_LRGOBJ | P_MOVED)) {
+                offsets[index] = OM_FETCH_NODATA;
+                continue;
+            }
+
+            if (used + obj->header.length > size || *stage == NULL) {
+                while (used + obj->header.length > size) size *= 2;
+                grown = (char*)realloc(*stage, size);
+                if (grown == NULL) ERRB1(eMEMALLOCFAILED_EDUOM, &pid, PAGE_BUF);
+                *stage = grown;
+            }
+
+            memcpy(&(*stage)[used], obj->data, obj->header.length);
+            offsets[index] = used;
+            used += obj->header.length;
+        }
+
+        e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_StageObjects() */
+
+
+
+/*@================================
+ * eduom_FetchObject()
+ *================================*/
+/*
+ * Function: static Four eduom_FetchObject(ObjectID*, Four, SlottedPage*, EduOM_FetchFunc, void*)
+ *
+ * Description :
+ *  Check the object in the fixed page and call the function on it.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    the negative value returned by the function
+ */
+static Four eduom_FetchObject(
+    ObjectID    *oid,		/* IN object to fetch */
+    Four        index,		/* IN index of the object in the list */
+    SlottedPage *apage,		/* IN buffer holding the page of the object */
+    EduOM_FetchFunc func,	/* IN function called on the object */
+    void        *arg)		/* IN argument to the function */
+{
+    Object      *obj;		/* object fetched */
+
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        return(eBADOBJECTID_OM);
+
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    return(func(arg, index, oid, &(obj->header),
+                (obj->header.properties & (P_LRGOBJ | P_MOVED)) ? NULL : obj->data));
+
+} /* eduom_FetchObject() */
+
+
+
+/*@================================
+ * EduOM_FetchObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_FetchObjects(Four, ObjectID*, Boolean, EduOM_FetchFunc, void*)
+ *
+ * Description :
+ *  Call func(arg, i, &oids[i], objHdr, data) on each object of the list,
+ *  'data' pointing to the data of the object in the buffer pool, or NULL
+ *  for a large or a moved object, whose data is not in its page and is
+ *  read by EduOM_ReadObject(). The pages of the objects are fixed in the
+ *  physical order of the pages, and each page is fixed once for the whole
+ *  list.
+ *  If 'pageOrder' is TRUE, the objects are handed out page by page while
+ *  the page is fixed, and in the order of the list within a page, with
+ *  'data' pointing into the page. Otherwise they are handed out in the
+ *  order of the list after all the pages are freed, with 'objHdr' and
+ *  'data' pointing to copies made while the pages were fixed. A bad
+ *  ObjectID stops the fetch when its turn comes in either order.
+ *  The function may read objects, but must not change them. It returns
+ *  eNOERROR to go on; a negative value stops the fetch and is returned by
+ *  EduOM_FetchObjects().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    eMEMALLOCFAILED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_FetchObjects(
+    Four        nObjects,	/* IN # of objects in the list */
+    ObjectID    *oids,		/* IN objects to fetch */
+    Boolean     pageOrder,	/* IN TRUE to hand the objects out in page order */
+    EduOM_FetchFunc func,	/* IN function called on each object */
+    void        *arg)		/* IN argument to the function */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Four        first;		/* first object of the page */
+    PageID      pid;		/* page fixed */
+    SlottedPage *apage;		/* buffer holding the page */
+    eduom_FetchEntry_T *entries; /* objects sorted by page */
+    ObjectHdr   *hdrs;		/* headers of the objects copied out */
+    Four        *offsets;	/* offsets of the data of the objects copied out */
+    char        *stage;		/* data of the objects copied out */
+
+
+    /*@ parameter checking */
+    if (nObjects < 0 || (nObjects > 0 && oids == NULL) || func == NULL) ERR(eBADPARAMETER_OM);
+
+    if (nObjects == 0) return(eNOERROR);
+
+    if (pageOrder) {
+        entries = (eduom_FetchEntry_T*)malloc(nObjects * sizeof(eduom_FetchEntry_T));
+        if (entries == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+        for (i = 0; i < nObjects; i++) {
+            entries[i].oid = oids[i];
+            entries[i].index = i;
+        }
+        qsort(entries, nObjects, sizeof(eduom_FetchEntry_T), eduom_CompareFetchEntry);
+
+        for (first = 0; first < nObjects; first = i) {
+            MAKE_PAGEID(pid, entries[first].oid.volNo, entries[first].oid.pageNo);
+            e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+            if (e < 0) {
+                free(entries);
+                ERR(e);
+            }
+
+            for (i = first; i < nObjects && entries[i].oid.volNo == pid.volNo &&
+                 entries[i].oid.pageNo == pid.pageNo; i++) {
+                e = eduom_FetchObject(&entries[i].oid, entries[i].index, apage, func, arg);
+                if (e < 0) {
+                    free(entries);
+                    ERRB1(e, &pid, PAGE_BUF);
+                }
+            }
+
+            e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+            if (e < 0) {
+                free(entries);
+                ERR(e);
+            }
+        }
+
+        free(entries);
+
+        return(eNOERROR);
+    }
+
+    /*@ copy the objects out in page order, and hand them out in the order of the list */
+    entries = (eduom_FetchEntry_T*)malloc(nObjects * sizeof(eduom_FetchEntry_T));
+    hdrs = (ObjectHdr*)malloc(nObjects * sizeof(ObjectHdr));
+    offsets = (Four*)malloc(nObjects * sizeof(Four));
+    stage = NULL;
+    if (entries == NULL || hdrs == NULL || offsets == NULL)
+        e = eMEMALLOCFAILED_EDUOM;
+    else {
+        for (i = 0; i < nObjects; i++) {
+            entries[i].oid = oids[i];
+            entries[i].index = i;
+        }
+        qsort(entries, nObjects, sizeof(eduom_FetchEntry_T), eduom_CompareFetchEntry);
+
+        e = eduom_StageObjects(nObjects, entries, hdrs, offsets, &stage);
+    }
+
+    for (i = 0; e >= 0 && i < nObjects; i++) {
+        if (offsets[i] == OM_FETCH_BADOID)
+            e = eBADOBJECTID_OM;
+        else
+            e = func(arg, i, &oids[i], &hdrs[i], (offsets[i] == OM_FETCH_NODATA) ? NULL : &stage[offsets[i]]);
+    }
+
+    free(entries);
+    free(hdrs);
+    free(offsets);
+    free(stage);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_FetchObjects() */
@@ -103,7 +103,6 @@ Four EduOM_NextObject(
     SlottedPage *apage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
     PhysicalFileID pFid;	/* file in which the objects are located */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
 
 
@@ -115,9 +114,8 @@ Four EduOM_NextObject(
     
     if (nextOID == NULL) ERR(eBADOBJECTID_OM);
 
-    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
     if(e < 0) ERR(e);
-    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
 
     if(curOID == NULL) {
@@ -168,7 +166,7 @@ Four EduOM_NextObject(
         if(e < 0) ERR(e);
     }
 
-    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    e = eduom_FreeCatalogEntry(catObjForFile);
     if(e < 0) ERR(e);
 
     return(EOS);		/* end of scan */
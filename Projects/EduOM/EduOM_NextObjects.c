@@ -0,0 +1,145 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_NextObjects.c
+ * 
+ * Description : 
+ *  EduOM_NextObjects() returns the next objects of a scan cursor in the
+ *  page the cursor is on.
+ *
+ * Exports:
+ *  Four EduOM_NextObjects(EduOM_ScanCursor*, Four, ObjectID*, ObjectHdr*, char**, Four*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_NextObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_NextObjects(EduOM_ScanCursor*, Four, ObjectID*, ObjectHdr*, char**, Four*)
+ * 
+ * Description : 
+ *  Move the cursor over up to 'maxN' objects and return them in arrays.
+ *  The objects returned by a call are taken from one page, the page of
+ *  the first of them, so the call stops at the end of that page. When
+ *  'dataPtrs' is given, dataPtrs[i] points to the data of the i-th object
+ *  in the buffer of the page, which stays fixed until the next call on
+ *  the cursor or until it is closed; the data must not be changed
+ *  through these pointers. It is NULL for a large or a moved object, whose
+ *  data is read by EduOM_ReadObject().
+ *
+ * Returns:
+ *  error code
+ *    EOS - end of the scan; no object is returned
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter nObjects
+ *     'nObjects' is set to the number of objects returned.
+ *  2) parameters oids, objHdrs, dataPtrs
+ *     their first 'nObjects' elements are set to the ObjectIDs, the
+ *     headers and the data of the objects; objHdrs and dataPtrs may be NULL.
+ */
+Four EduOM_NextObjects(
+    EduOM_ScanCursor *cursor,	/* INOUT cursor of the scan */
+    Four        maxN,		/* IN max # of objects to return */
+    ObjectID    *oids,		/* OUT objects returned */
+    ObjectHdr   *objHdrs,	/* OUT headers of the objects returned */
+    char        **dataPtrs,	/* OUT data of the objects returned */
+    Four        *nObjects)	/* OUT # of objects returned */
+{
+    Four        e;		/* error number */
+    SlottedPage *apage;		/* page the cursor is on */
+    Object      *obj;		/* object returned */
+    Four        n;		/* # of objects returned */
+    Two         i;		/* slot index */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL || maxN <= 0 || oids == NULL || nObjects == NULL) ERR(eBADPARAMETER_OM);
+
+    *nObjects = 0;
+
+    e = eduom_ScanNextSlot(cursor);
+    if (e < 0) ERR(e);
+    if (e == EOS) return(EOS);
+
+    apage = cursor->apage;
+    i = cursor->slotNo;
+
+    for (n = 0; ; ) {
+        MAKE_OBJECTID(oids[n], cursor->pid.volNo, cursor->pid.pageNo, i, apage->slot[-i].unique);
+
+        obj = (Object*)&(apage->data[apage->slot[-i].offset]);
+        if (objHdrs != NULL) objHdrs[n] = obj->header;
+        if (dataPtrs != NULL) dataPtrs[n] = (obj->header.properties & (P_LRGOBJ | P_MOVED)) ? NULL : obj->data;
+
+        cursor->slotNo = i;
+        if (++n == maxN) break;
+
+        e = eduom_ScanFindSlot(cursor, i + 1, &i);
+        if (e < 0) ERR(e);
+        if (i == apage->header.nSlots) {
+            /* the rest of the page has been filtered; do not filter it again */
+            cursor->slotNo = i - 1;
+            break;
+        }
+    }
+
+    *nObjects = n;
+
+    return(eNOERROR);
+    
+} /* EduOM_NextObjects() */
@@ -0,0 +1,317 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ParallelScan.c
+ *
+ * Description :
+ *  EduOM_ParallelScan() scans a data file with worker threads.
+ *
+ * Exports:
+ *  Four EduOM_ParallelScan(ObjectID*, Four, EduOM_ScanFunc, void**, Four*)
+ */
+
+
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+/*@
+ * constant definitions
+ */
+/* states of a queue entry */
+#define OM_PSCAN_FREE       0   /* not in use */
+#define OM_PSCAN_QUEUED     1   /* holds a fixed page no worker has taken */
+#define OM_PSCAN_TAKEN      2   /* holds a fixed page a worker is scanning */
+#define OM_PSCAN_DONE       3   /* holds a fixed page already scanned */
+
+
+/*@
+ * type definitions
+ */
+/* state of a parallel scan shared by the calling thread and the workers */
+typedef struct {
+    pthread_mutex_t latch;                              /* protects the fields below */
+    pthread_cond_t  changed;                            /* a queue entry or the end flag changed */
+    PageID          pid[OM_PARALLELSCAN_QUEUESIZE];     /* pages in the queue */
+    SlottedPage     *apage[OM_PARALLELSCAN_QUEUESIZE];  /* buffers holding them */
+    Four            state[OM_PARALLELSCAN_QUEUESIZE];   /* state of each entry */
+    Boolean         end;                                /* TRUE if no more page is to be queued */
+    Four            error;                              /* first error of the scan */
+    EduOM_ScanFunc  func;                               /* function called on each object */
+} eduom_ParallelScan_T;
+
+/* state of a worker */
+typedef struct {
+    eduom_ParallelScan_T *scan;                         /* scan of the worker */
+    void            *arg;                               /* argument to the function */
+    Four            nObjects;                           /* # of objects scanned */
+} eduom_ParallelScanWorker_T;
+
+
+
+/*@================================
+ * eduom_ParallelScanWorker()
+ *================================*/
+/*
+ * Function: static void *eduom_ParallelScanWorker(void*)
+ *
+ * Description :
+ *  Take the pages from the queue one by one and call the function on the
+ *  objects in them until the queue is emptied for good.
+ *
+ * Returns:
+ *  NULL
+ */
+static void *eduom_ParallelScanWorker(
+    void        *param)		/* IN state of the worker */
+{
+    eduom_ParallelScanWorker_T *worker = (eduom_ParallelScanWorker_T*)param;
+    eduom_ParallelScan_T *scan = worker->scan;
+    SlottedPage *apage;		/* page taken */
+    ObjectID    oid;		/* object scanned */
+    Object      *obj;		/* object in the page */
+    Four        e;		/* error number */
+    Four        q;		/* queue entry taken */
+    Two         i;		/* slot index */
+
+
+    pthread_mutex_lock(&scan->latch);
+
+    for (;;) {
+        for (q = 0; q < OM_PARALLELSCAN_QUEUESIZE && scan->state[q] != OM_PSCAN_QUEUED; q++);
+
+        if (q == OM_PARALLELSCAN_QUEUESIZE) {
+            if (scan->end) break;
+            pthread_cond_wait(&scan->changed, &scan->latch);
+            continue;
+        }
+
+        scan->state[q] = OM_PSCAN_TAKEN;
+        apage = scan->apage[q];
+        e = (scan->error < 0) ? scan->error : eNOERROR;
+        pthread_mutex_unlock(&scan->latch);
+
+        for (i = 0; i < apage->header.nSlots && e >= 0; i++) {
+            if (!IS_SCANNED_SLOT(apage, i)) continue;
+
+            obj = (Object*)&(apage->data[apage->slot[-i].offset]);
+            MAKE_OBJECTID(oid, scan->pid[q].volNo, scan->pid[q].pageNo, i, apage->slot[-i].unique);
+
+            e = (*scan->func)(worker->arg, &oid, &obj->header,
+                              (obj->header.properties & (P_LRGOBJ | P_MOVED)) ? NULL : obj->data);
+            worker->nObjects++;
+        }
+
+        pthread_mutex_lock(&scan->latch);
+        if (e < 0 && scan->error == eNOERROR) {
+            scan->error = e;
+            scan->end = TRUE;
+        }
+        scan->state[q] = OM_PSCAN_DONE;
+        pthread_cond_broadcast(&scan->changed);
+    }
+
+    pthread_mutex_unlock(&scan->latch);
+
+    return(NULL);
+
+} /* eduom_ParallelScanWorker() */
+
+
+
+/*@================================
+ * EduOM_ParallelScan()
+ *================================*/
+/*
+ * Function: Four EduOM_ParallelScan(ObjectID*, Four, EduOM_ScanFunc, void**, Four*)
+ *
+ * Description :
+ *  Scan the data file with 'nWorkers' worker threads. Each worker calls
+ *  func(args[w], oid, objHdr, data) on each object of the pages it takes,
+ *  'data' pointing to the data of the object in the buffer pool, or NULL
+ *  for a large or a moved object, whose data is not in its page; the
+ *  pages are handed out one at a time as the workers become free, so an
+ *  object is seen by exactly one worker, in no particular order. The
+ *  function must not call the object manager or the buffer manager. It
+ *  returns eNOERROR to go on; a negative value stops the scan and is
+ *  returned by EduOM_ParallelScan().
+ *  The calling thread fixes the pages for the workers in the order of
+ *  the page list, up to OM_PARALLELSCAN_QUEUESIZE pages ahead of them,
+ *  and unfixes the pages they are done with.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eTHREADCREATEFAILED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter nObjects
+ *     if not NULL, nObjects[w] is set to the # of objects the w-th worker scanned.
+ */
+Four EduOM_ParallelScan(
+    ObjectID    *catObjForFile,	/* IN file to scan */
+    Four        nWorkers,	/* IN # of worker threads */
+    EduOM_ScanFunc func,	/* IN function called on each object */
+    void        **args,		/* IN args[w] is passed to the function by the w-th worker; may be NULL */
+    Four        *nObjects)	/* OUT # of objects scanned by each worker */
+{
+    Four        e;		/* error number */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+    eduom_ParallelScan_T scan;	/* state of the scan */
+    eduom_ParallelScanWorker_T worker[OM_PARALLELSCAN_MAXWORKERS]; /* state of the workers */
+    pthread_t   thread[OM_PARALLELSCAN_MAXWORKERS]; /* the workers */
+    Four        nThreads;	/* # of workers started */
+    PageID      nextPid;	/* next page to queue */
+    PageID      donePid[OM_PARALLELSCAN_QUEUESIZE]; /* pages to unfix */
+    Four        nDone;		/* # of pages in donePid[] */
+    Four        nBusy;		/* # of entries in use */
+    Boolean     feed;		/* TRUE if a page is to be queued */
+    Four        q;		/* queue entry */
+    Four        w;		/* index of a worker */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nWorkers < 1 || nWorkers > OM_PARALLELSCAN_MAXWORKERS || func == NULL) ERR(eBADPARAMETER_OM);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+    MAKE_PAGEID(nextPid, catEntry->fid.volNo, catEntry->firstPage);
+    e = eduom_FreeCatalogEntry(catObjForFile);
+    if (e < 0) ERR(e);
+
+    pthread_mutex_init(&scan.latch, NULL);
+    pthread_cond_init(&scan.changed, NULL);
+    for (q = 0; q < OM_PARALLELSCAN_QUEUESIZE; q++) scan.state[q] = OM_PSCAN_FREE;
+    scan.end = FALSE;
+    scan.error = eNOERROR;
+    scan.func = func;
+
+    for (nThreads = 0; nThreads < nWorkers; nThreads++) {
+        worker[nThreads].scan = &scan;
+        worker[nThreads].arg = (args != NULL) ? args[nThreads] : NULL;
+        worker[nThreads].nObjects = 0;
+        if (pthread_create(&thread[nThreads], NULL, eduom_ParallelScanWorker, &worker[nThreads]) != 0) {
+            scan.error = eTHREADCREATEFAILED_EDUOM;
+            break;
+        }
+    }
+
+    /*@ feed the workers with the pages, unfixing those they are done with */
+    pthread_mutex_lock(&scan.latch);
+
+    for (;;) {
+        nDone = nBusy = 0;
+        for (q = 0; q < OM_PARALLELSCAN_QUEUESIZE; q++) {
+            if (scan.state[q] == OM_PSCAN_DONE) {
+                donePid[nDone++] = scan.pid[q];
+                scan.state[q] = OM_PSCAN_FREE;
+            }
+            if (scan.state[q] != OM_PSCAN_FREE) nBusy++;
+        }
+
+        if (scan.error < 0 || nThreads == 0) scan.end = TRUE;
+        if (scan.end && nBusy == 0 && nDone == 0) break;
+
+        feed = (!scan.end && nBusy < OM_PARALLELSCAN_QUEUESIZE) ? TRUE : FALSE;
+        if (nDone == 0 && !feed) {
+            pthread_cond_wait(&scan.changed, &scan.latch);
+            continue;
+        }
+
+        /*@ the free entries are touched by this thread only, so the latch is released here */
+        pthread_mutex_unlock(&scan.latch);
+
+        e = eNOERROR;
+        for (w = 0; w < nDone; w++) {
+            e = BfM_FreeTrain((TrainID*)&donePid[w], PAGE_BUF);
+            if (e < 0) break;
+        }
+
+        if (e >= 0 && feed) {
+            for (q = 0; scan.state[q] != OM_PSCAN_FREE; q++);
+
+            scan.pid[q] = nextPid;
+            e = BfM_GetTrain((TrainID*)&scan.pid[q], (char**)&scan.apage[q], PAGE_BUF);
+        }
+
+        pthread_mutex_lock(&scan.latch);
+
+        if (e < 0) {
+            if (scan.error == eNOERROR) scan.error = e;
+        }
+        else if (feed) {
+            nextPid.pageNo = scan.apage[q]->header.nextPage;
+            scan.state[q] = OM_PSCAN_QUEUED;
+            if (nextPid.pageNo == NIL) scan.end = TRUE;
+        }
+
+        pthread_cond_broadcast(&scan.changed);
+    }
+
+    pthread_mutex_unlock(&scan.latch);
+
+    for (w = 0; w < nThreads; w++) pthread_join(thread[w], NULL);
+
+    pthread_cond_destroy(&scan.changed);
+    pthread_mutex_destroy(&scan.latch);
+
+    if (nObjects != NULL)
+        for (w = 0; w < nWorkers; w++) nObjects[w] = (w < nThreads) ? worker[w].nObjects : 0;
+
+    if (scan.error < 0) ERR(scan.error);
+
+    return(eNOERROR);
+
+} /* EduOM_ParallelScan() */
@@ -0,0 +1,138 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_PinObject.c
+ * 
+ * Description : 
+ *  EduOM_PinObject() returns a pointer to the data of an object in the
+ *  buffer pool.
+ *
+ * Exports:
+ *  Four EduOM_PinObject(ObjectID*, char**, Four*, EduOM_PinHandle*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_PinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_PinObject(ObjectID*, char**, Four*, EduOM_PinHandle*)
+ * 
+ * Description : 
+ *  Fix the page of the object and return a pointer to its data in the
+ *  buffer of the page instead of copying the data as EduOM_ReadObject()
+ *  does. The page stays fixed, and the pointer valid, until
+ *  EduOM_UnpinObject() is called with the handle returned. The data must
+ *  not be changed through the pointer. A large object, whose data is not
+ *  kept in its page, cannot be pinned.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter data
+ *     'data' is set to point to the data of the object.
+ *  2) parameter length
+ *     'length' is set to the length of the object.
+ *  3) parameter handle
+ *     'handle' is set to be passed to EduOM_UnpinObject().
+ */
+Four EduOM_PinObject(
+    ObjectID 	*oid,		/* IN object to pin */
+    char     	**data,		/* OUT data of the object */
+    Four     	*length,	/* OUT length of the object */
+    EduOM_PinHandle *handle)	/* OUT handle to unpin the object */
+{
+    Four     	e;              /* error code */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ObjectID	fwdOid;		/* forwarded record of a moved object */
+
+
+    /*@ check parameters */
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+    
+    if (data == NULL || length == NULL || handle == NULL) ERR(eBADPARAMETER_OM);
+
+    MAKE_PAGEID(handle->pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&handle->pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &handle->pid, PAGE_BUF);
+
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    if (obj->header.properties & P_LRGOBJ) ERRB1(eNOTSUPPORTED_EDUOM, &handle->pid, PAGE_BUF);
+
+    /* the page of the forwarded record of a moved object is kept fixed instead */
+    if (obj->header.properties & P_MOVED) {
+        fwdOid = *(ObjectID*)obj->data;
+        e = BfM_FreeTrain((TrainID*)&handle->pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+        return(EduOM_PinObject(&fwdOid, data, length, handle));
+    }
+
+    *data = obj->data;
+    *length = obj->header.length;
+
+    return(eNOERROR);
+    
+} /* EduOM_PinObject() */
@@ -102,7 +102,6 @@ Four EduOM_PrevObject(
     PageNo pageNo;		/* a temporary var for previous page's PageNo */
     SlottedPage *apage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     PhysicalFileID pFid;
 
@@ -112,9 +111,8 @@ Four EduOM_PrevObject(
     
     if (prevOID == NULL) ERR(eBADOBJECTID_OM);
 
-    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
     if(e < 0) ERR(e);
-    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->lastPage);
 
     if(curOID == NULL) {
@@ -163,7 +161,7 @@ Four EduOM_PrevObject(
         if(e < 0) ERR(e);
     }
 
-    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    e = eduom_FreeCatalogEntry(catObjForFile);
     if(e < 0) ERR(e);
 
     return(EOS);
@@ -122,6 +122,7 @@ Four EduOM_ReadObject(
     SlottedPage	*apage;		/* pointer to the buffer of the page  */
     Object	*obj;		/* pointer to the object in the slotted page */
     Four	offset;		/* offset of the object in the page */
+    ObjectID	fwdOid;		/* forwarded record of a moved object */
 
     
     
@@ -140,12 +141,26 @@ Four EduOM_ReadObject(
     offset = apage->slot[-(oid->slotNo)].offset;
     obj = (Object*)&(apage->data[offset]);
 
-    if ((length < 0 && length != REMAINDER) || obj->header.length < start + length)
-        ERR(eBADLENGTH_OM);
-    //buf = &(obj->data[start]);
+    /* a moved object is read from its forwarded record */
+    if (obj->header.properties & P_MOVED) {
+        fwdOid = *(ObjectID*)obj->data;
+        e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+        if(e < 0) ERR(e);
+        return(EduOM_ReadObject(&fwdOid, start, length, buf));
+    }
+
     if(length == REMAINDER)
-        length = obj->header.length;
-    memcpy(buf, &(obj->data[start]), length);
+        length = obj->header.length - start;
+    if (length < 0 || obj->header.length < start + length)
+        ERRB1(eBADLENGTH_OM, &pid, PAGE_BUF);
+
+    /* the data of a large object is kept in the leaves of its LOT tree */
+    if (obj->header.properties & P_LRGOBJ) {
+        e = LOT_ReadObject(&pid, oid->slotNo, start, length, buf);
+        if(e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+    else
+        memcpy(buf, &(obj->data[start]), length);
 
     e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
     if(e < 0) ERR(e);
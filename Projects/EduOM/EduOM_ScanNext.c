@@ -0,0 +1,118 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ScanNext.c
+ * 
+ * Description : 
+ *  EduOM_ScanNext() returns the next object of a scan cursor.
+ *
+ * Exports:
+ *  Four EduOM_ScanNext(EduOM_ScanCursor*, ObjectID*, ObjectHdr*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_ScanNext()
+ *================================*/
+/*
+ * Function: Four EduOM_ScanNext(EduOM_ScanCursor*, ObjectID*, ObjectHdr*)
+ * 
+ * Description : 
+ *  Move the cursor to the next object of the file and return its ID and
+ *  header. No buffer manager call is made while the cursor stays on the
+ *  same page. The objects rejected by the filter of the cursor, if any,
+ *  are skipped.
+ *
+ * Returns:
+ *  error code
+ *    EOS - end of the scan
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oid
+ *     'oid' is set to the ObjectID of the next object.
+ *  2) parameter objHdr
+ *     if not NULL, 'objHdr' is set to the header of the next object.
+ */
+Four EduOM_ScanNext(
+    EduOM_ScanCursor *cursor,	/* INOUT cursor of the scan */
+    ObjectID    *oid,		/* OUT next object */
+    ObjectHdr   *objHdr)	/* OUT header of the next object */
+{
+    Four        e;		/* error number */
+    Object      *obj;		/* the next object */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    e = eduom_ScanNextSlot(cursor);
+    if (e < 0) ERR(e);
+    if (e == EOS) return(EOS);
+
+    MAKE_OBJECTID(*oid, cursor->pid.volNo, cursor->pid.pageNo, cursor->slotNo,
+                  cursor->apage->slot[-cursor->slotNo].unique);
+
+    if (objHdr != NULL) {
+        obj = (Object*)&(cursor->apage->data[cursor->apage->slot[-cursor->slotNo].offset]);
+        *objHdr = obj->header;
+    }
+
+    return(eNOERROR);
+    
+} /* EduOM_ScanNext() */
@@ -0,0 +1,118 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_SetScanFilter.c
+ * 
+ * Description : 
+ *  EduOM_SetScanFilter() sets the filter of the objects returned by a scan.
+ *
+ * Exports:
+ *  Four EduOM_SetScanFilter(EduOM_ScanCursor*, EduOM_ScanFilter*)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_SetScanFilter()
+ *================================*/
+/*
+ * Function: Four EduOM_SetScanFilter(EduOM_ScanCursor*, EduOM_ScanFilter*)
+ * 
+ * Description : 
+ *  Set the filter of an open cursor; a NULL filter removes it. Only the
+ *  objects for which all the conditions of the filter hold, and for which
+ *  the function of the filter, if any, returns TRUE, are returned by
+ *  EduOM_ScanNext() and EduOM_NextObjects() from then on. The filter is
+ *  evaluated on the page fixed by the cursor, so the objects skipped are
+ *  neither copied out nor returned to the caller.
+ *  The filter is not copied; it must be kept until the cursor is closed
+ *  or another filter is set.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_SetScanFilter(
+    EduOM_ScanCursor *cursor,	/* INOUT cursor of the scan */
+    EduOM_ScanFilter *filter)	/* IN filter to set; NULL for none */
+{
+    EduOM_FilterCond *cond;	/* condition checked */
+    Four        k;		/* index variable */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (filter != NULL) {
+        if (filter->nConds < 0 || filter->nConds > OM_FILTER_MAXCONDS) ERR(eBADPARAMETER_OM);
+
+        for (k = 0; k < filter->nConds; k++) {
+            cond = &filter->conds[k];
+
+            if (cond->field < OM_FILTER_TAG || cond->field > OM_FILTER_BYTES) ERR(eBADPARAMETER_OM);
+
+            if (cond->op < OM_FILTER_EQ || cond->op > OM_FILTER_GE) ERR(eBADPARAMETER_OM);
+
+            if (cond->start < 0) ERR(eBADPARAMETER_OM);
+
+            if (cond->field == OM_FILTER_BYTES &&
+                (cond->length < 1 || cond->length > OM_FILTER_MAXBYTES || cond->bytes == NULL))
+                ERR(eBADPARAMETER_OM);
+        }
+    }
+
+    cursor->filter = filter;
+
+    return(eNOERROR);
+    
+} /* EduOM_SetScanFilter() */
@@ -0,0 +1,1108 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_StressTest.c
+ *
+ * Description:
+ *  Stress tests of the extensions of EduOM which cannot be shown by
+ *  EduOM_Test(): large objects grown by appends and written across
+ *  their pages, also from a moved object, objects moved by updates,
+ *  stale ObjectIDs, batched destroys emptying pages, compactions staging
+ *  the object moved to the end, and the available space lists of an open
+ *  file. The program is built by 'make check' by linking this module in
+ *  place of EduOM_Test.o, and prints one line per test.
+ *
+ * Exports:
+ *  Four EduOM_Test(Four, Four)
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+/*@ Constant definitions */
+#define STRESS_LRGLENGTH        40000   /* max length of the large objects */
+#define STRESS_SMALLLENGTH      200     /* length of the small objects */
+#define STRESS_NBATCH           60      /* # of small objects of the batched destroy test */
+#define STRESS_NCHURN           100     /* # of objects of each file of the open file test */
+#define STRESS_MAXPAGES         500     /* max # of pages of a file walked */
+#define STRESS_FILLOBJECTS      (PAGESIZE / STRESS_SMALLLENGTH + 1)  /* max # of small objects filling a page */
+
+/* Macro: STRESS_CHECK(cond, msg)
+ * Description: print the failure and return FALSE from the test if 'cond' does not hold
+ */
+#define STRESS_CHECK(cond, msg) \
+BEGIN_MACRO \
+    if (!(cond)) { printf("    FAILED: %s\n", (msg)); return(FALSE); } \
+END_MACRO
+
+
+/* volume of the files of the tests */
+static Four stress_volId;
+
+/* data written to the objects, and the data read back */
+static char stress_data[STRESS_LRGLENGTH];
+static char stress_buf[STRESS_LRGLENGTH];
+
+
+
+/*@================================
+ * stress_CreateFile()
+ *================================*/
+/*
+ * Function: static Four stress_CreateFile(ObjectID*)
+ *
+ * Description:
+ *  Create an empty data file for a test.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four stress_CreateFile(
+    ObjectID	*catObj)	/* OUT catalog object of the file */
+{
+    Four	e;		/* for errors */
+    FileID	fid;		/* file created */
+
+
+    e = SM_CreateFile(stress_volId, &fid, FALSE, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, catObj);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* stress_CreateFile() */
+
+
+
+/*@================================
+ * stress_Count()
+ *================================*/
+/*
+ * Function: static Four stress_Count(ObjectID*)
+ *
+ * Description:
+ *  Scan a data file with a scan cursor.
+ *
+ * Returns:
+ *  # of objects returned, or -1 if a forwarded record was returned or
+ *  the scan failed
+ */
+static Four stress_Count(
+    ObjectID	*catObj)	/* IN catalog object of the file */
+{
+    Four	e;		/* for errors */
+    Four	n;		/* # of objects returned */
+    ObjectID	oid;		/* object returned */
+    ObjectHdr	objHdr;		/* header of the object returned */
+    EduOM_ScanCursor cursor;	/* scan cursor */
+
+
+    e = EduOM_OpenScan(catObj, &cursor);
+    if (e < eNOERROR) return(-1);
+
+    for (n = 0; (e = EduOM_ScanNext(&cursor, &oid, &objHdr)) == eNOERROR; n++)
+        if (objHdr.properties & P_FORWARDED) n = -STRESS_LRGLENGTH;
+
+    (void) EduOM_CloseScan(&cursor);
+
+    return((e == EOS && n >= 0) ? n : -1);
+
+}  /* stress_Count() */
+
+
+
+/*@================================
+ * stress_Properties()
+ *================================*/
+/*
+ * Function: static Four stress_Properties(ObjectID*)
+ *
+ * Description:
+ *  Look up the properties of the object in the slot of an ObjectID.
+ *
+ * Returns:
+ *  the properties, or an error code
+ *    some errors caused by function calls
+ */
+static Four stress_Properties(
+    ObjectID	*oid)		/* IN object */
+{
+    Four	e;		/* for errors */
+    Four	properties;	/* properties of the object */
+    PageID	pid;		/* page of the object */
+    SlottedPage	*apage;		/* buffer holding the page */
+
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    properties = ((Object*)&apage->data[apage->slot[-oid->slotNo].offset])->header.properties;
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(properties);
+
+}  /* stress_Properties() */
+
+
+
+/*@================================
+ * stress_Matches()
+ *================================*/
+/*
+ * Function: static Boolean stress_Matches(ObjectID*, Four, Four, char*)
+ *
+ * Description:
+ *  Read 'length' bytes of an object from 'start' and compare them with
+ *  'expected'.
+ *
+ * Returns:
+ *  TRUE if the object has the expected data
+ */
+static Boolean stress_Matches(
+    ObjectID	*oid,		/* IN object */
+    Four	start,		/* IN first byte read */
+    Four	length,		/* IN # of bytes read */
+    char	*expected)	/* IN data expected */
+{
+    memset(stress_buf, 0, length);
+
+    return(EduOM_ReadObject(oid, start, length, stress_buf) == length &&
+           memcmp(stress_buf, expected, length) == 0);
+
+}  /* stress_Matches() */
+
+
+
+/*@================================
+ * stress_FillPage()
+ *================================*/
+/*
+ * Function: static Four stress_FillPage(ObjectID*, ObjectID*)
+ *
+ * Description:
+ *  Create small objects in a new file, each near the previous one, until
+ *  one of them goes to a second page, so that the first page is full.
+ *  'oids' must have room for STRESS_FILLOBJECTS objects.
+ *
+ * Returns:
+ *  # of objects created, or an error code
+ *    eBADPARAMETER_OM - the objects did not fill the page
+ *    some errors caused by function calls
+ */
+static Four stress_FillPage(
+    ObjectID	*catObj,	/* OUT catalog object of the file */
+    ObjectID	*oids)		/* OUT objects created */
+{
+    Four	e;		/* for errors */
+    Four	n;		/* # of objects created */
+    ObjectHdr	objHdr;		/* header of the objects created */
+
+
+    objHdr.properties = P_CLEAR;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+
+    e = stress_CreateFile(catObj);
+    if (e < eNOERROR) ERR(e);
+
+    for (n = 0; n == 0 || oids[n-1].pageNo == oids[0].pageNo; n++) {
+        if (n == STRESS_FILLOBJECTS) ERR(eBADPARAMETER_OM);
+        e = EduOM_CreateObject(catObj, (n > 0) ? &oids[n-1] : NULL, &objHdr, STRESS_SMALLLENGTH,
+                               stress_data, &oids[n]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(n);
+
+}  /* stress_FillPage() */
+
+
+
+/*@================================
+ * stress_ForwardedOid()
+ *================================*/
+/*
+ * Function: static Four stress_ForwardedOid(ObjectID*, ObjectID*)
+ *
+ * Description:
+ *  Get the ObjectID kept in the stub of a moved object.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM - the object is not moved
+ *    some errors caused by function calls
+ */
+static Four stress_ForwardedOid(
+    ObjectID	*oid,		/* IN moved object */
+    ObjectID	*fwdOid)	/* OUT its forwarded record */
+{
+    Four	e;		/* for errors */
+    PageID	pid;		/* page of the object */
+    SlottedPage	*apage;		/* buffer holding the page */
+    Object	*obj;		/* the stub */
+
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    obj = (Object*)&apage->data[apage->slot[-oid->slotNo].offset];
+    if (!(obj->header.properties & P_MOVED)) ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+    *fwdOid = *(ObjectID*)obj->data;
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* stress_ForwardedOid() */
+
+
+
+/*@================================
+ * stress_CheckLists()
+ *================================*/
+/*
+ * Function: static Four stress_CheckLists(ObjectID*)
+ *
+ * Description:
+ *  Walk the available space lists of a data file from the heads in its
+ *  catalog object, and the page list of the file. Each page listed must
+ *  be in the list of its free space and point back at the page before
+ *  it, and each page of the file with at least 10% free must be listed.
+ *
+ * Returns:
+ *  # of pages listed, or -1 if the lists are wrong or could not be walked
+ */
+static Four stress_CheckLists(
+    ObjectID	*catObj)	/* IN catalog object of the file */
+{
+    Four	e;		/* for errors */
+    Four	k;		/* index of the list */
+    Four	ratio;		/* free space of a page in tenths */
+    Four	nListed;	/* # of pages listed */
+    Four	nFree;		/* # of pages of the file with at least 10% free */
+    PageID	pid;		/* page walked */
+    ShortPageID	prev;		/* page before it in its list */
+    SlottedPage	*apage;		/* buffer holding the page */
+    SlottedPage	*catPage;	/* buffer holding the catalog object */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+    ShortPageID	heads[5];	/* heads of the lists */
+    ShortPageID	firstPage;	/* first page of the file */
+
+
+    e = BfM_GetTrain((TrainID*)catObj, (char**)&catPage, PAGE_BUF);
+    if (e < eNOERROR) return(-1);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObj, catPage, catEntry);
+    heads[0] = catEntry->availSpaceList10;
+    heads[1] = catEntry->availSpaceList20;
+    heads[2] = catEntry->availSpaceList30;
+    heads[3] = catEntry->availSpaceList40;
+    heads[4] = catEntry->availSpaceList50;
+    firstPage = catEntry->firstPage;
+    e = BfM_FreeTrain((TrainID*)catObj, PAGE_BUF);
+    if (e < eNOERROR) return(-1);
+
+    nListed = 0;
+    for (k = 0; k < 5; k++) {
+        MAKE_PAGEID(pid, catObj->volNo, heads[k]);
+        for (prev = NIL; pid.pageNo != NIL; prev = apage->header.pid.pageNo, pid.pageNo = apage->header.spaceListNext) {
+            e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+            if (e < eNOERROR) return(-1);
+            ratio = 10 * SP_FREE(apage) / (PAGESIZE - SP_FIXED);
+            e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+            if (e < eNOERROR) return(-1);
+
+            if ((ratio < 5 ? ratio : 5) != k + 1 || apage->header.spaceListPrev != prev) return(-1);
+            if (++nListed > STRESS_MAXPAGES) return(-1);
+        }
+    }
+
+    nFree = 0;
+    for (MAKE_PAGEID(pid, catObj->volNo, firstPage); pid.pageNo != NIL; pid.pageNo = apage->header.nextPage) {
+        e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) return(-1);
+        if (SP_FREE(apage) * 10 >= PAGESIZE - SP_FIXED) nFree++;
+        e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+        if (e < eNOERROR) return(-1);
+    }
+
+    return((nFree == nListed) ? nListed : -1);
+
+}  /* stress_CheckLists() */
+
+
+
+/*@================================
+ * stress_LargeObjects()
+ *================================*/
+/*
+ * Function: static Boolean stress_LargeObjects(void)
+ *
+ * Description:
+ *  Grow a small object into a large one by appends, write ranges of it
+ *  spanning the leaves of its tree, create a large object directly, and
+ *  check the data after each step and the small object next to them.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_LargeObjects(void)
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	length;		/* length of the grown object */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	grown;		/* object grown by appends */
+    ObjectID	created;	/* large object created directly */
+    ObjectID	small;		/* small object after them */
+    ObjectHdr	objHdr;		/* header of the objects created */
+    char	*expected;	/* expected data of the grown object */
+    Four	appends[] = { 3000, 9000, 20000, STRESS_LRGLENGTH - 32100 };
+    Four	writes[][2] = { { 0, 10 }, { 3990, 200 }, { 5000, 12000 }, { STRESS_LRGLENGTH - 50, 50 } };
+
+
+    expected = (char*)malloc(STRESS_LRGLENGTH);
+    STRESS_CHECK(expected != NULL, "malloc");
+    memcpy(expected, stress_data, STRESS_LRGLENGTH);
+    objHdr.properties = P_CLEAR;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+
+    e = stress_CreateFile(&catObj);
+    STRESS_CHECK(e == eNOERROR, "create file");
+
+    length = 100;
+    e = EduOM_CreateObject(&catObj, NULL, &objHdr, length, stress_data, &grown);
+    STRESS_CHECK(e == eNOERROR, "create small object");
+
+    for (i = 0; i < sizeof(appends) / sizeof(appends[0]); i++) {
+        e = EduOM_AppendToObject(&catObj, &grown, appends[i], &stress_data[length], &dlPool, &dlHead);
+        STRESS_CHECK(e == eNOERROR, "append");
+        length += appends[i];
+        STRESS_CHECK(stress_Matches(&grown, 0, length, stress_data), "wrong data after an append");
+    }
+    STRESS_CHECK(length == STRESS_LRGLENGTH, "wrong length appended");
+    STRESS_CHECK(stress_Properties(&grown) & P_LRGOBJ, "grown object not large");
+
+    for (i = 0; i < sizeof(writes) / sizeof(writes[0]); i++) {
+        memset(&expected[writes[i][0]], 'a' + i, writes[i][1]);
+        e = EduOM_WriteObject(&grown, writes[i][0], writes[i][1], &expected[writes[i][0]]);
+        STRESS_CHECK(e == writes[i][1], "write");
+    }
+    STRESS_CHECK(stress_Matches(&grown, 0, STRESS_LRGLENGTH, expected), "wrong data after the writes");
+    STRESS_CHECK(stress_Matches(&grown, 4100, 900, &expected[4100]), "wrong data read from the middle");
+
+    e = EduOM_CreateObject(&catObj, &grown, &objHdr, STRESS_LRGLENGTH / 2, stress_data, &created);
+    STRESS_CHECK(e == eNOERROR, "create large object");
+    STRESS_CHECK(stress_Properties(&created) & P_LRGOBJ, "created object not large");
+    STRESS_CHECK(stress_Matches(&created, 0, STRESS_LRGLENGTH / 2, stress_data), "wrong data of the created object");
+
+    e = EduOM_CreateObject(&catObj, &created, &objHdr, STRESS_SMALLLENGTH, stress_data, &small);
+    STRESS_CHECK(e == eNOERROR, "create small object after them");
+    STRESS_CHECK(stress_Count(&catObj) == 3, "wrong # of objects scanned");
+
+    e = EduOM_DestroyObject(&catObj, &grown, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "destroy grown object");
+    e = EduOM_DestroyObject(&catObj, &created, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "destroy created object");
+    STRESS_CHECK(stress_Count(&catObj) == 1, "wrong # of objects after the destroys");
+    STRESS_CHECK(stress_Matches(&small, 0, STRESS_SMALLLENGTH, stress_data), "small object changed");
+
+    free(expected);
+
+    return(TRUE);
+
+}  /* stress_LargeObjects() */
+
+
+
+/*@================================
+ * stress_MovedToLarge()
+ *================================*/
+/*
+ * Function: static Boolean stress_MovedToLarge(void)
+ *
+ * Description:
+ *  Move an object out of a full page by an update, and grow it into a
+ *  large object by an append, which brings it back into the slot of its
+ *  stub.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_MovedToLarge(void)
+{
+    Four	e;		/* for errors */
+    Four	n;		/* # of objects created */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oids[STRESS_FILLOBJECTS]; /* objects created */
+
+
+    n = stress_FillPage(&catObj, oids);
+    STRESS_CHECK(n > 0, "fill a page");
+
+    e = EduOM_UpdateObject(&catObj, &oids[0], 1500, stress_data, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "update");
+    STRESS_CHECK(stress_Properties(&oids[0]) & P_MOVED, "updated object not moved");
+
+    e = EduOM_AppendToObject(&catObj, &oids[0], 10000, &stress_data[1500], &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "append");
+    STRESS_CHECK((stress_Properties(&oids[0]) & (P_LRGOBJ | P_MOVED)) == P_LRGOBJ,
+                 "grown object not large in the slot of its stub");
+    STRESS_CHECK(stress_Matches(&oids[0], 0, 11500, stress_data), "wrong data of the grown object");
+    STRESS_CHECK(stress_Matches(&oids[1], 0, STRESS_SMALLLENGTH, stress_data), "neighbor changed");
+    STRESS_CHECK(stress_Count(&catObj) == n, "wrong # of objects scanned");
+
+    return(TRUE);
+
+}  /* stress_MovedToLarge() */
+
+
+
+/*@================================
+ * stress_Forwarded()
+ *================================*/
+/*
+ * Function: static Boolean stress_Forwarded(void)
+ *
+ * Description:
+ *  Move an object out of a full page by updates, grow and shrink it, and
+ *  destroy it through its ObjectID. The object must always be reached in
+ *  one hop, come back into its slot when it fits there, never be returned
+ *  twice by a scan, and take its forwarded record along when destroyed.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_Forwarded(void)
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	n;		/* # of objects created */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oids[STRESS_FILLOBJECTS]; /* objects created */
+    ObjectID	fwdOid;		/* forwarded record of the moved object */
+    ObjectID	hop;		/* ObjectID in the stub of the forwarded record, if any */
+    Four	lengths[] = { 1500, 2500, 1000, 3000, 50, 1800 };
+
+
+    n = stress_FillPage(&catObj, oids);
+    STRESS_CHECK(n > 0, "fill a page");
+
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        e = EduOM_UpdateObject(&catObj, &oids[0], lengths[i], &stress_data[i], &dlPool, &dlHead);
+        STRESS_CHECK(e == eNOERROR, "update");
+        STRESS_CHECK(stress_Matches(&oids[0], 0, lengths[i], &stress_data[i]), "wrong data after an update");
+
+        if (lengths[i] <= STRESS_SMALLLENGTH) {
+            STRESS_CHECK(!(stress_Properties(&oids[0]) & P_MOVED), "object fitting its slot not brought back");
+            continue;
+        }
+
+        e = stress_ForwardedOid(&oids[0], &fwdOid);
+        STRESS_CHECK(e == eNOERROR, "object not moved");
+        STRESS_CHECK(stress_Properties(&fwdOid) == P_FORWARDED, "stub not pointing at a forwarded record");
+        STRESS_CHECK(stress_ForwardedOid(&fwdOid, &hop) == eBADOBJECTID_OM, "more than one hop");
+        STRESS_CHECK(stress_Count(&catObj) == n, "wrong # of objects scanned");
+    }
+
+    e = EduOM_DestroyObject(&catObj, &oids[0], &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "destroy moved object");
+    STRESS_CHECK(stress_Count(&catObj) == n - 1, "wrong # of objects after the destroy");
+    e = EduOM_DestroyObject(&catObj, &fwdOid, &dlPool, &dlHead);
+    STRESS_CHECK(e == eBADOBJECTID_OM, "forwarded record left behind");
+
+    return(TRUE);
+
+}  /* stress_Forwarded() */
+
+
+
+/*@================================
+ * stress_StaleObjectIDs()
+ *================================*/
+/*
+ * Function: static Boolean stress_StaleObjectIDs(void)
+ *
+ * Description:
+ *  Use the ObjectID of a destroyed object, also after its slot is given
+ *  to a new object, and the ObjectID of a forwarded record, with the
+ *  calls which change or pin objects. They must be rejected, and the
+ *  objects in the page must not change.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_StaleObjectIDs(void)
+{
+    Four	e;		/* for errors */
+    Four	r;		/* 0 before the slot is reused, 1 after */
+    Four	n;		/* # of objects created */
+    Four	length;		/* length of the pinned object */
+    char	*data;		/* data of the pinned object */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oids[STRESS_FILLOBJECTS]; /* objects created */
+    ObjectID	stale;		/* destroyed object */
+    ObjectID	reused;		/* new object in the slot of the destroyed one */
+    ObjectID	fwdOid;		/* forwarded record of a moved object */
+    ObjectHdr	objHdr;		/* header of the new object */
+    EduOM_PinHandle handle;	/* handle of a pinned object */
+
+
+    n = stress_FillPage(&catObj, oids);
+    STRESS_CHECK(n > 2, "fill a page");
+
+    stale = oids[1];
+    e = EduOM_DestroyObject(&catObj, &stale, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "destroy");
+
+    for (r = 0; r < 2; r++) {
+        e = EduOM_DestroyObject(&catObj, &stale, &dlPool, &dlHead);
+        STRESS_CHECK(e == eBADOBJECTID_OM, "stale ObjectID destroyed");
+        e = EduOM_DestroyObjects(&catObj, 1, &stale, &dlPool, &dlHead);
+        STRESS_CHECK(e == eBADOBJECTID_OM, "stale ObjectID destroyed in a batch");
+        e = EduOM_UpdateObject(&catObj, &stale, 10, stress_data, &dlPool, &dlHead);
+        STRESS_CHECK(e == eBADOBJECTID_OM, "stale ObjectID updated");
+        e = EduOM_WriteObject(&stale, 0, 10, stress_data);
+        STRESS_CHECK(e == eBADOBJECTID_OM, "stale ObjectID written");
+        e = EduOM_PinObject(&stale, &data, &length, &handle);
+        STRESS_CHECK(e == eBADOBJECTID_OM, "stale ObjectID pinned");
+
+        if (r == 0) {
+            objHdr.properties = P_CLEAR;
+            objHdr.tag = 0;
+            objHdr.length = 0;
+            e = EduOM_CreateObject(&catObj, &oids[0], &objHdr, 40, &stress_data[1], &reused);
+            STRESS_CHECK(e == eNOERROR, "create");
+            STRESS_CHECK(reused.pageNo == stale.pageNo && reused.slotNo == stale.slotNo, "slot not reused");
+        }
+    }
+    STRESS_CHECK(stress_Matches(&reused, 0, 40, &stress_data[1]), "object in the reused slot changed");
+
+    e = EduOM_UpdateObject(&catObj, &oids[0], 2000, stress_data, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "update");
+    e = stress_ForwardedOid(&oids[0], &fwdOid);
+    STRESS_CHECK(e == eNOERROR, "object not moved");
+
+    e = EduOM_DestroyObject(&catObj, &fwdOid, &dlPool, &dlHead);
+    STRESS_CHECK(e == eBADOBJECTID_OM, "forwarded record destroyed");
+    e = EduOM_DestroyObjects(&catObj, 1, &fwdOid, &dlPool, &dlHead);
+    STRESS_CHECK(e == eBADOBJECTID_OM, "forwarded record destroyed in a batch");
+    e = EduOM_UpdateObject(&catObj, &fwdOid, 10, stress_data, &dlPool, &dlHead);
+    STRESS_CHECK(e == eBADOBJECTID_OM, "forwarded record updated");
+    STRESS_CHECK(stress_Matches(&oids[0], 0, 2000, stress_data), "moved object changed");
+
+    for (r = 2; r < n; r++)
+        STRESS_CHECK(stress_Matches(&oids[r], 0, STRESS_SMALLLENGTH, stress_data), "other object changed");
+
+    return(TRUE);
+
+}  /* stress_StaleObjectIDs() */
+
+
+
+/*@================================
+ * stress_DestroyObjects()
+ *================================*/
+/*
+ * Function: static Boolean stress_DestroyObjects(void)
+ *
+ * Description:
+ *  Destroy in one call, backwards and with duplicates, all the objects of
+ *  the second page, some of the first and a moved object. The emptied
+ *  page must leave the file, the forwarded record must go with
+ *  its object, the other objects must not change, and the available
+ *  space lists must stay right.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_DestroyObjects(void)
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	n;		/* # of objects created */
+    Four	nFirst;		/* # of objects in the first page */
+    Four	nDestroyed;	/* # of objects destroyed */
+    Four	nList;		/* # of ObjectIDs in the list */
+    Boolean	destroyed[STRESS_NBATCH]; /* TRUE if the object is destroyed */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oids[STRESS_NBATCH]; /* objects created */
+    ObjectID	list[2*STRESS_NBATCH]; /* objects destroyed */
+    ObjectID	fwdOid;		/* forwarded record of the moved object */
+    ObjectHdr	objHdr;		/* header of the objects created */
+    PageID	pid;		/* first page of the file */
+    SlottedPage	*apage;		/* buffer holding the page */
+    ShortPageID	nextPage;	/* page after it */
+
+
+    objHdr.properties = P_CLEAR;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+
+    e = stress_CreateFile(&catObj);
+    STRESS_CHECK(e == eNOERROR, "create file");
+
+    for (n = 0; n < STRESS_NBATCH; n++) {
+        e = EduOM_CreateObject(&catObj, (n > 0) ? &oids[n-1] : NULL, &objHdr, STRESS_SMALLLENGTH,
+                               stress_data, &oids[n]);
+        STRESS_CHECK(e == eNOERROR, "create object");
+    }
+    for (nFirst = 0; oids[nFirst].pageNo == oids[0].pageNo; nFirst++);
+    STRESS_CHECK(oids[n-1].pageNo != oids[nFirst].pageNo, "objects in less than three pages");
+
+    /* move the last object of the first page */
+    e = EduOM_UpdateObject(&catObj, &oids[nFirst-1], 1500, stress_data, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "update");
+    e = stress_ForwardedOid(&oids[nFirst-1], &fwdOid);
+    STRESS_CHECK(e == eNOERROR, "object not moved");
+
+    /* every 3rd object and the moved one of the first page and those of the second, each twice */
+    nList = 0;
+    for (i = n - 1; i >= 0; i--) {
+        destroyed[i] = (oids[i].pageNo == oids[nFirst].pageNo ||
+                        (oids[i].pageNo == oids[0].pageNo && (i % 3 == 0 || i == nFirst - 1)));
+        if (destroyed[i]) list[nList++] = oids[i];
+    }
+    nDestroyed = nList;
+    for (i = 0; i < nDestroyed; i++) list[nList++] = list[i];
+
+    e = EduOM_DestroyObjects(&catObj, nList, list, &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "destroy objects");
+
+    STRESS_CHECK(stress_Count(&catObj) == n - nDestroyed, "wrong # of objects left");
+    for (i = 0; i < n; i++)
+        if (destroyed[i]) {
+            e = EduOM_DestroyObject(&catObj, &oids[i], &dlPool, &dlHead);
+            STRESS_CHECK(e < eNOERROR, "object not destroyed");
+        }
+        else
+            STRESS_CHECK(stress_Matches(&oids[i], 0, STRESS_SMALLLENGTH, stress_data), "object left changed");
+
+    e = EduOM_DestroyObject(&catObj, &fwdOid, &dlPool, &dlHead);
+    STRESS_CHECK(e == eBADOBJECTID_OM, "forwarded record left behind");
+    STRESS_CHECK(stress_CheckLists(&catObj) >= 0, "available space lists wrong");
+
+    MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "get first page");
+    nextPage = apage->header.nextPage;
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    STRESS_CHECK(e == eNOERROR, "free first page");
+    STRESS_CHECK(nextPage != oids[nFirst].pageNo, "emptied page left in the file");
+
+    return(TRUE);
+
+}  /* stress_DestroyObjects() */
+
+
+
+/*@================================
+ * stress_CompactCopy()
+ *================================*/
+/*
+ * Function: static Four stress_CompactCopy(ObjectID*, Two, Boolean*)
+ *
+ * Description:
+ *  Compact a copy of the page of an object by EduOM_CompactPage() with
+ *  'slotNo' to go to the end, and check that every object of the page
+ *  keeps its data, that the objects are packed from the start of the
+ *  data area with the object of 'slotNo' last, and that the page is
+ *  otherwise unchanged.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM - the copy was compacted wrong
+ *    some errors caused by function calls
+ */
+static Four stress_CompactCopy(
+    ObjectID	*oid,		/* IN object in the page */
+    Two		slotNo,		/* IN slot to go to the end, or NIL */
+    Boolean	*staged)	/* OUT TRUE if the object of 'slotNo' had to be staged outside the page */
+{
+    Four	e;		/* for errors */
+    Two		i;		/* slot index */
+    Four	len;		/* length of an object in the page */
+    Four	packed;		/* length of the objects in the page */
+    Object	*obj;		/* object in the page */
+    PageID	pid;		/* page of the object */
+    SlottedPage	*apage;		/* buffer holding the page */
+    static SlottedPage before;	/* copy of the page */
+    static SlottedPage after;	/* copy compacted */
+
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    before = *apage;
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    obj = (Object*)&before.data[before.slot[-slotNo].offset];
+    *staged = (slotNo != NIL && SP_CFREE(&before) < OBJ_LENGTH_IN_PAGE(obj));
+
+    after = before;
+    e = EduOM_CompactPage(&after, slotNo);
+    if (e < eNOERROR) ERR(e);
+
+    if (after.header.nSlots != before.header.nSlots || after.header.unused != 0) ERR(eBADPARAMETER_OM);
+
+    packed = 0;
+    for (i = 0; i < before.header.nSlots; i++) {
+        if (before.slot[-i].offset == EMPTYSLOT) {
+            if (after.slot[-i].offset != EMPTYSLOT) ERR(eBADPARAMETER_OM);
+            continue;
+        }
+        obj = (Object*)&before.data[before.slot[-i].offset];
+        len = OBJ_LENGTH_IN_PAGE(obj);
+        if (after.slot[-i].offset < 0 || after.slot[-i].offset + len > after.header.free ||
+            after.slot[-i].unique != before.slot[-i].unique ||
+            memcmp(&after.data[after.slot[-i].offset], obj, len) != 0)
+            ERR(eBADPARAMETER_OM);
+        if (i == slotNo && after.slot[-i].offset + len != after.header.free) ERR(eBADPARAMETER_OM);
+        packed += len;
+    }
+    if (packed != after.header.free) ERR(eBADPARAMETER_OM);
+
+    return(eNOERROR);
+
+}  /* stress_CompactCopy() */
+
+
+
+/*@================================
+ * stress_CompactPage()
+ *================================*/
+/*
+ * Function: static Boolean stress_CompactPage(void)
+ *
+ * Description:
+ *  Compact copies of a page with holes and little room at its free end,
+ *  and of a page with much room there, moving the first object to the
+ *  end, so that the object is staged once in a temporary buffer and once
+ *  at the free end of the page; then compact the first page once more
+ *  without an object to move.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_CompactPage(void)
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	n;		/* # of objects created */
+    Boolean	staged;		/* TRUE if the object was staged outside the page */
+    ObjectID	catObj;		/* catalog object of the file */
+    ObjectID	oids[STRESS_FILLOBJECTS]; /* objects created */
+    ObjectID	roomy[4];	/* objects of the page with room */
+    ObjectHdr	objHdr;		/* header of the objects created */
+
+
+    n = stress_FillPage(&catObj, oids);
+    STRESS_CHECK(n > 4, "fill a page");
+
+    /* the page with room holds the object which did not fit in the full one */
+    objHdr.properties = P_CLEAR;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+    roomy[0] = oids[n-1];
+    for (i = 1; i < 4; i++) {
+        e = EduOM_CreateObject(&catObj, &roomy[i-1], &objHdr, 100 * i, &stress_data[i], &roomy[i]);
+        STRESS_CHECK(e == eNOERROR, "create object");
+    }
+    e = EduOM_DestroyObject(&catObj, &roomy[1], &dlPool, &dlHead);
+    STRESS_CHECK(e == eNOERROR, "destroy object");
+
+    for (i = 2; i < n - 1; i += 3) {
+        e = EduOM_DestroyObject(&catObj, &oids[i], &dlPool, &dlHead);
+        STRESS_CHECK(e == eNOERROR, "destroy object");
+    }
+
+    /* use up the free end of the full page so the first object no longer fits there */
+    e = EduOM_CreateObject(&catObj, &oids[0], &objHdr, STRESS_SMALLLENGTH + 100, stress_data, &oids[n-1]);
+    STRESS_CHECK(e == eNOERROR && oids[n-1].pageNo == oids[0].pageNo, "create object in the full page");
+
+    e = stress_CompactCopy(&oids[0], oids[0].slotNo, &staged);
+    STRESS_CHECK(e == eNOERROR && staged, "full page compacted wrong");
+    e = stress_CompactCopy(&roomy[0], roomy[0].slotNo, &staged);
+    STRESS_CHECK(e == eNOERROR && !staged, "page with room compacted wrong");
+    e = stress_CompactCopy(&oids[0], NIL, &staged);
+    STRESS_CHECK(e == eNOERROR, "full page compacted wrong without an object to move");
+
+    return(TRUE);
+
+}  /* stress_CompactPage() */
+
+
+
+/*@================================
+ * stress_Churn()
+ *================================*/
+/*
+ * Function: static Four stress_Churn(ObjectID*, ObjectID*, Four*)
+ *
+ * Description:
+ *  Create STRESS_NCHURN objects of various lengths in a file, destroy
+ *  some one by one and a run of them in one call, and update the others
+ *  to new lengths, which moves some of them. The length of each object
+ *  is set in 'lengths', or to -1 if it was destroyed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four stress_Churn(
+    ObjectID	*catObj,	/* IN catalog object of the file */
+    ObjectID	*oids,		/* OUT objects created */
+    Four	*lengths)	/* OUT length of each object, or -1 */
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    ObjectHdr	objHdr;		/* header of the objects created */
+
+
+    objHdr.properties = P_CLEAR;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+
+    for (i = 0; i < STRESS_NCHURN; i++) {
+        lengths[i] = 20 + i * 37 % 400;
+        e = EduOM_CreateObject(catObj, NULL, &objHdr, lengths[i], &stress_data[i], &oids[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    for (i = 0; i < STRESS_NCHURN / 2; i += 2) {
+        e = EduOM_DestroyObject(catObj, &oids[i], &dlPool, &dlHead);
+        if (e < eNOERROR) ERR(e);
+        lengths[i] = -1;
+    }
+
+    e = EduOM_DestroyObjects(catObj, STRESS_NCHURN / 4, &oids[STRESS_NCHURN - STRESS_NCHURN / 4], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    for (i = STRESS_NCHURN - STRESS_NCHURN / 4; i < STRESS_NCHURN; i++) lengths[i] = -1;
+
+    for (i = 0; i < STRESS_NCHURN; i++) {
+        if (lengths[i] < 0) continue;
+        lengths[i] = 10 + i * 53 % 800;
+        e = EduOM_UpdateObject(catObj, &oids[i], lengths[i], &stress_data[i], &dlPool, &dlHead);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* stress_Churn() */
+
+
+
+/*@================================
+ * stress_OpenFile()
+ *================================*/
+/*
+ * Function: static Boolean stress_OpenFile(void)
+ *
+ * Description:
+ *  Run the same creates, destroys and updates twice on a file not open,
+ *  and on a file opened twice by EduOM_OpenFile() and closed once between
+ *  them. After the open file is closed again, the available space lists written back to its catalog
+ *  object must be right and as long as those of the other file, the
+ *  objects must have their data, and the file must be usable again.
+ *
+ * Returns:
+ *  TRUE if the test passed
+ */
+static Boolean stress_OpenFile(void)
+{
+    Four	e;		/* for errors */
+    Four	i;		/* loop index */
+    Four	m;		/* 0 for the file not open, 1 for the open one */
+    Four	n;		/* # of objects left */
+    Four	nListed[2];	/* # of pages listed in each file */
+    ObjectID	catObj[2];	/* catalog objects of the files */
+    ObjectID	oids[STRESS_NCHURN]; /* objects of a file */
+    ObjectID	oid;		/* object created after the close */
+    Four	lengths[STRESS_NCHURN]; /* length of each object, or -1 */
+    ObjectHdr	objHdr;		/* header of the object created after the close */
+
+
+    for (m = 0; m < 2; m++) {
+        e = stress_CreateFile(&catObj[m]);
+        STRESS_CHECK(e == eNOERROR, "create file");
+
+        if (m == 1) {
+            e = EduOM_OpenFile(&catObj[m]);
+            STRESS_CHECK(e == eNOERROR, "open");
+            e = EduOM_OpenFile(&catObj[m]);
+            STRESS_CHECK(e == eNOERROR, "open again");
+        }
+
+        e = stress_Churn(&catObj[m], oids, lengths);
+        STRESS_CHECK(e == eNOERROR, "creates, destroys and updates");
+
+        if (m == 1) {
+            e = EduOM_CloseFile(&catObj[m]);
+            STRESS_CHECK(e == eNOERROR, "close");
+        }
+
+        e = stress_Churn(&catObj[m], oids, lengths);
+        STRESS_CHECK(e == eNOERROR, "creates, destroys and updates again");
+
+        if (m == 1) {
+            e = EduOM_CloseFile(&catObj[m]);
+            STRESS_CHECK(e == eNOERROR, "close again");
+            e = EduOM_CloseFile(&catObj[m]);
+            STRESS_CHECK(e == eBADCATALOGOBJECT_OM, "closed more times than opened");
+        }
+
+        nListed[m] = stress_CheckLists(&catObj[m]);
+        STRESS_CHECK(nListed[m] >= 0, "available space lists wrong");
+
+        for (n = 0, i = 0; i < STRESS_NCHURN; i++)
+            if (lengths[i] >= 0) {
+                STRESS_CHECK(stress_Matches(&oids[i], 0, lengths[i], &stress_data[i]), "wrong data");
+                n++;
+            }
+    }
+    STRESS_CHECK(nListed[0] == nListed[1], "files with different available space lists");
+    STRESS_CHECK(stress_Count(&catObj[0]) == stress_Count(&catObj[1]), "files with different # of objects");
+
+    objHdr.properties = P_CLEAR;
+    objHdr.tag = 0;
+    objHdr.length = 0;
+    e = EduOM_CreateObject(&catObj[1], NULL, &objHdr, STRESS_SMALLLENGTH, stress_data, &oid);
+    STRESS_CHECK(e == eNOERROR, "create after the close");
+    STRESS_CHECK(stress_CheckLists(&catObj[1]) >= 0, "available space lists wrong after the close");
+
+    return(TRUE);
+
+}  /* stress_OpenFile() */
+
+
+
+/*@================================
+ * stress_Run()
+ *================================*/
+/*
+ * Function: static Four stress_Run(char*, Boolean (*)(void))
+ *
+ * Description:
+ *  Run a test and print its result.
+ *
+ * Returns:
+ *  1 if the test failed, 0 otherwise
+ */
+static Four stress_Run(
+    char	*name,		/* IN name of the test */
+    Boolean	(*test)(void))	/* IN test to run */
+{
+    Boolean	passed;		/* TRUE if the test passed */
+
+
+    printf("%s:\n", name);
+    passed = test();
+    if (passed) printf("    ok\n");
+
+    return(passed ? 0 : 1);
+
+}  /* stress_Run() */
+
+
+
+/*@================================
+ * EduOM_Test()
+ *================================*/
+/*
+ * Function: Four EduOM_Test(Four, Four)
+ *
+ * Description:
+ *  Run the stress tests and print their results. If some test failed,
+ *  the process exits with status 1 so that 'make check' fails.
+ *
+ * Returns:
+ *  error code
+ */
+Four EduOM_Test(
+    Four	volId,		/* IN volume of the files */
+    Four	handle)		/* IN handle of the volume */
+{
+    Four	i;		/* loop index */
+    Four	nFailed = 0;	/* # of tests failed */
+
+
+    stress_volId = volId;
+    for (i = 0; i < STRESS_LRGLENGTH; i++) stress_data[i] = (i * 7 + i / PAGESIZE) % 251;
+
+    nFailed += stress_Run("large objects appended to and written", stress_LargeObjects);
+    nFailed += stress_Run("moved object grown into a large object", stress_MovedToLarge);
+    nFailed += stress_Run("object moved by updates and destroyed", stress_Forwarded);
+    nFailed += stress_Run("stale ObjectIDs and forwarded records", stress_StaleObjectIDs);
+    nFailed += stress_Run("objects of several pages destroyed in one call", stress_DestroyObjects);
+    nFailed += stress_Run("pages compacted with an object moved to the end", stress_CompactPage);
+    nFailed += stress_Run("available space lists of an open file written back", stress_OpenFile);
+
+    printf("%ld test(s) failed\n", (long)nFailed);
+    if (nFailed > 0) exit(1);
+
+    return(eNOERROR);
+
+}  /* EduOM_Test() */
@@ -0,0 +1,321 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_UpdateObject.c
+ *
+ * Description :
+ *  EduOM_UpdateObject() replaces the data of an object, keeping its
+ *  ObjectID.
+ *
+ * Exports:
+ *  Four EduOM_UpdateObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * eduom_ReplaceInPage()
+ *================================*/
+/*
+ * Function: static Four eduom_ReplaceInPage(SlottedPage*, Two, ObjectHdr*, Four, char*, Boolean*)
+ *
+ * Description :
+ *  Replace the object in the slot 'slotNo' of the page by the header
+ *  'objHdr' followed by the 'length' bytes of 'data', if they fit in the
+ *  page. An object which shrinks, or which is the last one of the data
+ *  area and grows into the contiguous free space, stays where it is;
+ *  otherwise the page is compacted with the object moved to the end of
+ *  the data area, where it grows.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter done
+ *     'done' is set to TRUE if the object has been replaced, and to FALSE
+ *     if it does not fit in the page, which is then not changed.
+ */
+static Four eduom_ReplaceInPage(
+    SlottedPage	*apage,		/* INOUT page holding the object */
+    Two         slotNo,		/* IN slot of the object */
+    ObjectHdr	*objHdr,	/* IN new header of the object */
+    Four        length,		/* IN amount of new data */
+    char        *data,		/* IN new data */
+    Boolean     *done)		/* OUT TRUE if the object has been replaced */
+{
+    Four        e;		/* error code */
+    Object      *obj;		/* pointer to the object in the slotted page */
+    Four        oldLen;		/* length of the object in the page */
+    Four        newLen;		/* length of the new object in the page */
+    Boolean     last;		/* TRUE if the object is the last one of the data area */
+
+
+    obj = (Object*)&(apage->data[apage->slot[-slotNo].offset]);
+    oldLen = OBJ_LENGTH_IN_PAGE(obj);
+    newLen = sizeof(ObjectHdr) + ALIGNED_LENGTH(length);
+
+    *done = FALSE;
+    if (newLen - oldLen > (Four)SP_FREE(apage)) return(eNOERROR);
+
+    last = (apage->slot[-slotNo].offset + oldLen == apage->header.free) ? TRUE : FALSE;
+
+    if (newLen <= oldLen) {
+        if (last)
+            apage->header.free -= oldLen - newLen;
+        else
+            apage->header.unused += oldLen - newLen;
+    }
+    else {
+        if (!last || newLen - oldLen > (Four)SP_CFREE(apage)) {
+            e = EduOM_CompactPage(apage, slotNo);
+            if (e < 0) ERR(e);
+            obj = (Object*)&(apage->data[apage->slot[-slotNo].offset]);
+        }
+        apage->header.free += newLen - oldLen;
+    }
+
+    obj->header = *objHdr;
+    memcpy(obj->data, data, length);
+    *done = TRUE;
+
+    return(eNOERROR);
+
+} /* eduom_ReplaceInPage() */
+
+
+
+/*@================================
+ * EduOM_UpdateObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UpdateObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  (1) What to do?
+ *  EduOM_UpdateObject() replaces the data of the object identified by
+ *  'oid' with the 'length' bytes of 'data'; the tag of the object is kept.
+ *  The object is updated in its page when it fits there, compacting the
+ *  page if needed. Otherwise it is moved to another page as a forwarded
+ *  record and its slot keeps a stub pointing at the record (see the
+ *  forwarded objects section of EduOM_Internal.h), so the ObjectID, and
+ *  the index entries holding it, stay valid.
+ *  Large objects are not updated by this function; they are changed by
+ *  EduOM_WriteObject() and EduOM_AppendToObject().
+ *
+ *  (2) How to do?
+ *  a. Read in the slotted page
+ *  b. Remove this page from the 'availSpaceList'
+ *  c. IF the new data fits in the slot of the object THEN
+ *	   replace the object, or the stub of a moved object, with the data
+ *	   destroy the forwarded record of a moved object
+ *     ELSE IF moved object and the new data fits in the forwarded record THEN
+ *	   replace the forwarded record with the data
+ *     ELSE
+ *	   create a new forwarded record holding the data
+ *	   destroy the old forwarded record of a moved object
+ *	   replace the object with a stub pointing at the new record
+ *     ENDIF
+ *  d. Put this page into the proper 'availSpaceList'
+ *  e. Free the buffer page
+ *  f. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    eNOSPACEFORSTUB_EDUOM - the page has no room even for the stub
+ *    some errors caused by function calls
+ */
+Four EduOM_UpdateObject(
+    ObjectID 	*catObjForFile,	/* IN file containing the object */
+    ObjectID 	*oid,		/* IN object to update */
+    Four     	length,		/* IN amount of new data */
+    char     	*data,		/* IN new data of the object */
+    Pool     	*dlPool,	/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four     	e;              /* error code */
+    PageID 	pid;		/* page containing object specified by 'oid' */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ObjectHdr	objHdr;		/* header of the object, the stub, or the record written */
+    Boolean	moved;		/* TRUE if the object was moved before */
+    Boolean	done;		/* TRUE if the data has been written */
+    ObjectID	fwdOid;		/* forwarded record of the moved object */
+    ObjectID	newFwdOid;	/* forwarded record created */
+    PageID	fwdPid;		/* page containing the forwarded record */
+    SlottedPage	*fwdPage;	/* pointer to the buffer of the forwarded record's page */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRBC2(eBADOBJECTID_OM, &pid, PAGE_BUF, catObjForFile);
+
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    if (obj->header.properties & P_FORWARDED)
+        ERRBC2(eBADOBJECTID_OM, &pid, PAGE_BUF, catObjForFile);
+
+    if (obj->header.properties & P_LRGOBJ)
+        ERRBC2(eNOTSUPPORTED_EDUOM, &pid, PAGE_BUF, catObjForFile);
+
+    moved = (obj->header.properties & P_MOVED) ? TRUE : FALSE;
+    if (moved) fwdOid = *(ObjectID*)obj->data;
+
+    e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    objHdr.properties = 0;
+    objHdr.tag = obj->header.tag;
+    objHdr.length = length;
+
+    /*@ update the object in its slot; a moved object comes back to it */
+    e = eduom_ReplaceInPage(apage, oid->slotNo, &objHdr, length, data, &done);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    if (done) {
+        if (moved) {
+            e = eduom_DestroyObject(catObjForFile, &fwdOid, TRUE, dlPool, dlHead);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+        }
+    }
+    else {
+        objHdr.properties = P_FORWARDED;
+
+        /*@ update the forwarded record in its page */
+        if (moved) {
+            MAKE_PAGEID(fwdPid, fwdOid.volNo, fwdOid.pageNo);
+            e = BfM_GetTrain((TrainID*)&fwdPid, (char**)&fwdPage, PAGE_BUF);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+            e = eduom_RemoveFromAvailSpace(catObjForFile, &fwdPid, fwdPage);
+            if (e >= 0)
+                e = eduom_ReplaceInPage(fwdPage, fwdOid.slotNo, &objHdr, length, data, &done);
+            if (e >= 0) {
+                e = eduom_PutInAvailSpace(catObjForFile, catEntry, &fwdPid, fwdPage);
+            }
+            if (e >= 0 && done)
+                e = BfM_SetDirty((TrainID*)&fwdPid, PAGE_BUF);
+            if (e < 0) {
+                (Four) BfM_FreeTrain((TrainID*)&fwdPid, PAGE_BUF);
+                ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+            }
+
+            e = BfM_FreeTrain((TrainID*)&fwdPid, PAGE_BUF);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+            if (done) obj->header.length = length;
+        }
+        else if (OM_STUB_LENGTH > OBJ_LENGTH_IN_PAGE(obj) &&
+                 OM_STUB_LENGTH - OBJ_LENGTH_IN_PAGE(obj) > SP_FREE(apage))
+            ERRBC2(eNOSPACEFORSTUB_EDUOM, &pid, PAGE_BUF, catObjForFile);
+
+        /*@ move the object to a new forwarded record */
+        if (!done) {
+            e = eduom_CreateObject(catObjForFile, NULL, &objHdr, length, data, &newFwdOid);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+            if (moved) {
+                e = eduom_DestroyObject(catObjForFile, &fwdOid, TRUE, dlPool, dlHead);
+                if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+            }
+
+            objHdr.properties = P_MOVED;
+            e = eduom_ReplaceInPage(apage, oid->slotNo, &objHdr, sizeof(ObjectID), (char*)&newFwdOid, &done);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+        }
+    }
+
+    e = eduom_PutInAvailSpace(catObjForFile, catEntry, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    e = BfM_SetDirty((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    e = eduom_FreeCatalogEntry(catObjForFile);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_UpdateObject() */
@@ -0,0 +1,165 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_WriteObject.c
+ *
+ * Description :
+ *  EduOM_WriteObject() overwrites a byte range of the object identified
+ *  by 'oid' with the user specified data.
+ *
+ * Exports:
+ *  Four EduOM_WriteObject(ObjectID*, Four, Four, char*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_WriteObject()
+ *================================*/
+/*
+ * Function: Four EduOM_WriteObject(ObjectID*, Four, Four, char*)
+ *
+ * Description :
+ *  (1) What to do?
+ *  EduOM_WriteObject() overwrites the 'length' bytes from 'start' of the
+ *  object identified by 'oid' with 'data'. If 'length' is REMAINDER, the
+ *  data from 'start' to the end of the object are overwritten. The length
+ *  of the object is not changed; use EduOM_AppendToObject() to extend it.
+ *  This routine returns the number of bytes written.
+ *
+ *  (2) How to do?
+ *  a. Read in the slotted page
+ *  b. See the object header
+ *  c. IF moved object THEN
+ *	   call this routine recursively with the forwarded object's identifier
+ *     ELSE IF large object THEN
+ *	   call the large object manager's LOT_WriteObject()
+ *     ELSE
+ *	   copy the data into the object and set the page dirty
+ *     ENDIF
+ *  d. Free the buffer page
+ *  e. Return
+ *
+ * Returns:
+ *  1) number of bytes actually written (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADSTART_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_WriteObject(
+    ObjectID 	*oid,		/* IN object to write */
+    Four     	start,		/* IN starting offset of write */
+    Four     	length,		/* IN amount of data to write */
+    char     	*data)		/* IN user buffer holding the data to write */
+{
+    Four     	e;              /* error code */
+    PageID 	pid;		/* page containing object specified by 'oid' */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ObjectID	fwdOid;		/* forwarded record of a moved object */
+
+
+    /*@ check parameters */
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (data == NULL) ERR(eBADUSERBUF_OM);
+
+    if (start < 0) ERR(eBADSTART_OM);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    obj = (Object*)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    /* a moved object is written in its forwarded record */
+    if (obj->header.properties & P_MOVED) {
+        fwdOid = *(ObjectID*)obj->data;
+        e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+        return(EduOM_WriteObject(&fwdOid, start, length, data));
+    }
+
+    if (length == REMAINDER)
+        length = obj->header.length - start;
+    if (length < 0 || obj->header.length < start + length)
+        ERRB1(eBADLENGTH_OM, &pid, PAGE_BUF);
+
+    /* the data of a large object is kept in the leaves of its LOT tree */
+    if (obj->header.properties & P_LRGOBJ) {
+        e = LOT_WriteObject(&pid, oid->slotNo, start, length, data);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+    else {
+        memcpy(&(obj->data[start]), data, length);
+
+        e = BfM_SetDirty((TrainID*)&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(length);
+
+} /* EduOM_WriteObject() */
@@ -60,11 +60,28 @@
  */
 /* Interface Function Prototypes */
 Four EduOM_CompactPage(SlottedPage*, Two);
-Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*);
+Four EduOM_CompactPageIfNeeded(SlottedPage*, Four, Boolean*);
+Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*);
+Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*);
 Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
+Four EduOM_DestroyObjects(ObjectID*, Four, ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_FetchObjects(Four, ObjectID*, Boolean, EduOM_FetchFunc, void*);
+Four EduOM_WriteObject(ObjectID*, Four, Four, char*);
+Four EduOM_UpdateObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*);
+Four EduOM_PinObject(ObjectID*, char**, Four*, EduOM_PinHandle*);
+Four EduOM_UnpinObject(EduOM_PinHandle*);
+Four EduOM_OpenFile(ObjectID*);
+Four EduOM_CloseFile(ObjectID*);
+Four EduOM_OpenScan(ObjectID*, EduOM_ScanCursor*);
+Four EduOM_SetScanFilter(EduOM_ScanCursor*, EduOM_ScanFilter*);
+Four EduOM_ScanNext(EduOM_ScanCursor*, ObjectID*, ObjectHdr*);
+Four EduOM_NextObjects(EduOM_ScanCursor*, Four, ObjectID*, ObjectHdr*, char**, Four*);
+Four EduOM_ParallelScan(ObjectID*, Four, EduOM_ScanFunc, void**, Four*);
+Four EduOM_CloseScan(EduOM_ScanCursor*);
 
 Four OM_DumpObject(ObjectID *);
 
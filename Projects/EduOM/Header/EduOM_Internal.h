@@ -50,6 +50,9 @@
 #define _EDUOM_INTERNAL_H_
 
 
+#include "Util_pool.h"		/* to get Pool */
+
+
 /*@
  * Type Definitions
  */
@@ -145,6 +148,31 @@ typedef struct {
 
 #define LRGOBJ_THRESHOLD (PAGESIZE - SP_FIXED - sizeof(ObjectHdr))
 
+/* Macro: OBJ_LENGTH_IN_PAGE(obj)
+ * Description: get the number of bytes the object takes in the data area of its page,
+ *  which is the root of its LOT tree for a large object (needs LOT.h)
+ *  and the stub for a moved object
+ * Parameters:
+ *  Object *obj         : pointer to the object in the slotted page
+ * Returns: length of the object in the page including its ObjectHdr
+ */
+#define OBJ_LENGTH_IN_PAGE(obj) \
+	(((obj)->header.properties & P_LRGOBJ) ? LOT_GetLengthWithHdr(obj) : \
+	 ((obj)->header.properties & P_MOVED) ? OM_STUB_LENGTH : \
+	 ALIGNED_LENGTH((obj)->header.length) + sizeof(ObjectHdr))
+
+/* Macro: IS_SCANNED_SLOT(s_page, i)
+ * Description: check whether the slot holds an object returned by the scans,
+ *  i.e., it is neither empty nor a forwarded record, which is reached through its stub
+ * Parameters:
+ *  SlottedPage *s_page : pointer to the slotted page
+ *  Two i               : slot number
+ * Returns: TRUE(1) if the object in the slot is scanned, otherwise FALSE(0)
+ */
+#define IS_SCANNED_SLOT(s_page, i) \
+	(((s_page)->slot[-(i)].offset != EMPTYSLOT) && \
+	 !(((Object*)&((s_page)->data[(s_page)->slot[-(i)].offset]))->header.properties & P_FORWARDED))
+
 /* Macro: GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry)
  * Description: get the information about the data file(sm_CatOverlayForData) residing in the catalog object for data file
  * Parameters:
@@ -160,11 +188,224 @@ typedef struct {
 }
 
 
+/*
+ * Open files
+ *
+ * A data file opened by EduOM_OpenFile() keeps a copy of its catalog
+ * entry in memory until it is closed, so the object manager does not fix
+ * the catalog page to look the entry up on each call. The heads of the
+ * available space lists are kept in the copy only: the pages are linked
+ * into and out of the lists as usual, but the catalog object is not
+ * fixed, and the heads are written back to it when the file is closed,
+ * so until then those in the catalog object are stale. The copy is read
+ * again, keeping its heads, whenever a page is added to or removed from
+ * the file by the file map routines.
+ */
+typedef struct eduom_OpenFile_T_tag {
+    ObjectID    catObjForFile;  /* catalog object of the file */
+    sm_CatOverlayForData catEntry;  /* copy of the catalog entry */
+    Four        nOpens;         /* # of times the file is opened */
+    struct eduom_OpenFile_T_tag *next;  /* next open file */
+} eduom_OpenFile_T;
+
+/* Macro: ERRBC1(e, catObjForFile)
+ * Description: as ERR(e), releasing the catalog entry got by eduom_GetCatalogEntry()
+ */
+#define ERRBC1(e, catObjForFile) \
+BEGIN_MACRO \
+    PRTERR(e); \
+    (Four) eduom_FreeCatalogEntry(catObjForFile); \
+    if (1) return(e); \
+END_MACRO
+
+/* Macro: ERRBC2(e, pid, t, catObjForFile)
+ * Description: as ERRB1(e, pid, t), releasing the catalog entry got by eduom_GetCatalogEntry()
+ */
+#define ERRBC2(e, pid, t, catObjForFile) \
+BEGIN_MACRO \
+    PRTERR(e); \
+    (Four) BfM_FreeTrain((pid),(t)); \
+    (Four) eduom_FreeCatalogEntry(catObjForFile); \
+    if (1) return(e); \
+END_MACRO
+
+
+/*
+ * Empty slot list
+ *
+ * The empty slots below nSlots of a slotted page are linked in ascending
+ * order through their 'unique' fields, which are not used while a slot
+ * is empty, and 'reserved' of the page header holds the first one. So a
+ * new object takes the lowest empty slot, as before, without scanning
+ * the slot array. The list is valid only if SP_EMPTYSLOTLIST is set in
+ * 'flags'; it is built by one scan of the slots for the pages written
+ * before, and for the pages whose flags are reset.
+ */
+#define SP_EMPTYSLOTLIST        0x1000  /* 'reserved' holds the first empty slot */
+
+
+/*
+ * Batched object creation
+ *
+ * EduOM_CreateObjects() allocates the new pages it needs in chunks of
+ * at most OM_CREATEOBJECTS_MAXPAGES pages, an extent of the volumes made
+ * by the test modules.
+ */
+#define OM_CREATEOBJECTS_MAXPAGES   16  /* max # of pages allocated at a time */
+
+
+/*
+ * Forwarded objects
+ *
+ * An object updated by EduOM_UpdateObject() to a size which no longer
+ * fits in its page is moved to another page as a forwarded record
+ * (P_FORWARDED), and its slot keeps a stub (P_MOVED) holding the ObjectID
+ * of the record, so the ObjectID of the object does not change. The
+ * header of the stub keeps the tag and the length of the object. A stub
+ * always points at the record itself: the record is updated in its page,
+ * moved again with the stub changed, or brought back into the slot of the
+ * stub when it fits there, so an object is reached in at most one extra
+ * hop. The scans skip the records and return the objects at their stubs.
+ * A moved object which grows into a large object is brought back into the
+ * slot of its stub by EduOM_AppendToObject(), and the tree is rooted there.
+ */
+#define OM_STUB_LENGTH  (sizeof(ObjectHdr) + ALIGNED_LENGTH(sizeof(ObjectID)))  /* length of a stub in the page */
+
+
+/*
+ * Scan filter
+ *
+ * A filter set on a scan cursor by EduOM_SetScanFilter() is evaluated on
+ * the objects in the buffer of the page the cursor is on, and the objects
+ * it rejects are skipped without being returned. It is the conjunction of
+ * up to OM_FILTER_MAXCONDS conditions, each comparing the tag, the length,
+ * a Four or a byte string at a fixed offset of the data with a constant,
+ * and of an optional function of the caller. The data of a large or a
+ * moved object, which is not in the page, is read for the conditions.
+ */
+#define OM_FILTER_MAXCONDS      8       /* max # of conditions of a filter */
+#define OM_FILTER_MAXBYTES      64      /* max # of bytes compared by a condition */
+
+/* field compared by a condition */
+#define OM_FILTER_TAG           0       /* tag of the object */
+#define OM_FILTER_LENGTH        1       /* length of the object */
+#define OM_FILTER_FOUR          2       /* Four at 'start' of the data */
+#define OM_FILTER_BYTES         3       /* 'length' bytes at 'start' of the data, compared by memcmp() */
+
+/* comparison of a condition: field op constant */
+#define OM_FILTER_EQ            0
+#define OM_FILTER_NE            1
+#define OM_FILTER_LT            2
+#define OM_FILTER_LE            3
+#define OM_FILTER_GT            4
+#define OM_FILTER_GE            5
+
+typedef struct {
+    Two         field;          /* OM_FILTER_TAG, OM_FILTER_LENGTH, OM_FILTER_FOUR or OM_FILTER_BYTES */
+    Two         op;             /* OM_FILTER_EQ, ..., OM_FILTER_GE */
+    Four        start;          /* offset in the data of OM_FILTER_FOUR and OM_FILTER_BYTES */
+    Four        length;         /* # of bytes of OM_FILTER_BYTES */
+    Four        value;          /* constant of OM_FILTER_TAG, OM_FILTER_LENGTH and OM_FILTER_FOUR */
+    char        *bytes;         /* constant of OM_FILTER_BYTES */
+} EduOM_FilterCond;
+
+/* function called on each object satisfying the conditions; returns TRUE to take it, FALSE to skip it, or an error code */
+typedef Four (*EduOM_FilterFunc)(void*, ObjectID*, ObjectHdr*, char*);
+
+typedef struct {
+    Four        nConds;         /* # of conditions */
+    EduOM_FilterCond conds[OM_FILTER_MAXCONDS];  /* conditions, all of which must hold */
+    EduOM_FilterFunc func;      /* function evaluated last; may be NULL */
+    void        *arg;           /* argument to the function */
+} EduOM_ScanFilter;
+
+
+/*
+ * Scan cursor
+ *
+ * A cursor opened by EduOM_OpenScan() goes through the objects of a data
+ * file in the order of its pages and slots. The catalog entry is read
+ * once when it is opened, and the page the cursor is on stays fixed
+ * between the calls until the cursor moves off it or is closed.
+ */
+typedef struct {
+    ObjectID    catObjForFile;  /* catalog object of the file scanned */
+    PageID      pid;            /* page the cursor is on; pageNo is NIL before the first or after the last page */
+    SlottedPage *apage;         /* buffer holding the page, fixed while the cursor is on it */
+    Two         slotNo;         /* slot of the object last returned; NIL before the first object of the page */
+    PageNo      firstPage;      /* first page of the file */
+    Boolean     started;        /* TRUE once the cursor has been on the first page */
+    EduOM_ScanFilter *filter;   /* filter of the objects returned; NULL for none */
+} EduOM_ScanCursor;
+
+
+/*
+ * Pinned object
+ *
+ * EduOM_PinObject() returns a pointer to an object in the buffer of its
+ * page, which stays fixed until EduOM_UnpinObject() is called with the
+ * handle returned.
+ */
+typedef struct {
+    PageID      pid;            /* page fixed for the pinned object */
+} EduOM_PinHandle;
+
+
+/*
+ * Parallel scan
+ *
+ * EduOM_ParallelScan() hands the pages of a data file out to worker
+ * threads, which call a function of the caller on each object. The
+ * buffer manager is not thread safe, so the pages are fixed and unfixed
+ * by the calling thread only: it walks the page list, running ahead of
+ * the workers by up to OM_PARALLELSCAN_QUEUESIZE fixed pages, and the
+ * workers take the pages from the queue as they become free.
+ */
+#define OM_PARALLELSCAN_MAXWORKERS  16  /* max # of worker threads */
+#define OM_PARALLELSCAN_QUEUESIZE   16  /* max # of pages fixed for the workers */
+
+/* function called on each object; a negative return value stops the scan */
+typedef Four (*EduOM_ScanFunc)(void*, ObjectID*, ObjectHdr*, char*);
+
+
+/*
+ * Fetching a list of objects
+ *
+ * EduOM_FetchObjects() reads the objects of an ObjectID list, such as the
+ * result of an index scan, fixing their pages in the physical order of
+ * the pages rather than in the order of the list. Given in page order,
+ * the objects of a page are all handed out while it is fixed. Given in
+ * the order of the list, the objects are copied out while their page is
+ * fixed, and handed out from the copies after the last page is freed, so
+ * that each page is still fixed once.
+ */
+#define OM_FETCHOBJECTS_STAGESIZE   PAGESIZE  /* initial size of the copies of the objects */
+
+/* function called on each object fetched, with its index in the list; a negative return value stops the fetch */
+typedef Four (*EduOM_FetchFunc)(void*, Four, ObjectID*, ObjectHdr*, char*);
+
+
 /*@
  * Function Prototypes
  */
 /* internal function prototypes */
 Four eduom_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four eduom_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*);
+Four eduom_DestroyObject(ObjectID*, ObjectID*, Boolean, Pool*, DeallocListElem*);
+Four eduom_DestroyObjectInPage(ObjectID*, PageID*, SlottedPage*, Two, Pool*, DeallocListElem*);
+Four eduom_OpenFile(ObjectID*);
+Four eduom_CloseFile(ObjectID*);
+eduom_OpenFile_T *eduom_FindOpenFile(ObjectID*);
+Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**);
+Four eduom_FreeCatalogEntry(ObjectID*);
+Four eduom_RemoveFromAvailSpace(ObjectID*, PageID*, SlottedPage*);
+Four eduom_PutInAvailSpace(ObjectID*, sm_CatOverlayForData*, PageID*, SlottedPage*);
+Four eduom_FileMapAddPage(ObjectID*, PageID*, PageID*);
+Four eduom_FileMapDeletePage(ObjectID*, sm_CatOverlayForData*, PageID*);
+Two eduom_AllocSlot(SlottedPage*);
+void eduom_FreeSlot(SlottedPage*, Two);
+Four eduom_ScanNextSlot(EduOM_ScanCursor*);
+Four eduom_ScanFindSlot(EduOM_ScanCursor*, Two, Two*);
 
 Four om_FileMapAddPage(ObjectID*, PageID*, PageID*);
 Four om_FileMapDeletePage(ObjectID*, PageID*);
@@ -62,6 +62,7 @@
 #include "RDsM.h"		/* for the raw disk manager call */
 #include "BfM.h"		/* for the buffer manager call */
 #include "EduOM_Internal.h"
+#include "EduOM.h"
 
 
 
@@ -109,12 +110,11 @@ Four eduom_CreateObject(
     Boolean     needToAllocPage;/* Is there a need to alloc a new page? */
     PageID      pid;            /* PageID in which new object to be inserted */
     PageID      nearPid;
-    PageNo      *availPage = NIL;
+    PageNo      availPage = NIL;
     Four        firstExt;	/* first Extent No of the file */
     Object      *obj;		/* point to the newly created object */
     Two         i;		/* index variable */
     sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
-    SlottedPage *catPage;	/* pointer to buffer containing the catalog */
     FileID      fid;		/* ID of file where the new object is placed */
     Two         eff;		/* extent fill factor of file */
     Boolean     isTmp;
@@ -134,9 +134,8 @@ Four eduom_CreateObject(
     alignedLen = ALIGNED_LENGTH(length);
     neededSpace = sizeof(ObjectHdr) + alignedLen + sizeof(SlottedPageSlot);
 
-    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
     if(e < 0) ERR(e);
-    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
     e = RDsM_PageIdToExtNo((PageID*)&pFid, &firstExt);
     if(e < 0) ERR(e);
@@ -147,7 +146,7 @@ Four eduom_CreateObject(
         if(e < 0) ERR(e);
         if(neededSpace <= SP_FREE(apage)) {
             pid = nearPid;
-            e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+            e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
             if(e < 0) ERRB1(e, &pid, PAGE_BUF);
             if(neededSpace > SP_CFREE(apage)) {
                 e = EduOM_CompactPage(apage, nearObj->slotNo);
@@ -158,14 +157,16 @@ Four eduom_CreateObject(
             e = BfM_FreeTrain((TrainID*)&nearPid, PAGE_BUF);
             if(e < 0) ERR(e);
             e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
-            if(e < 0) ERR(e);
+            if(e < 0) ERRBC1(e, catObjForFile);
             e = BfM_GetNewTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
             if(e < 0) ERR(e);
-            apage->header.flags = 0x2;
+            apage->header.pid = pid;
+            apage->header.flags = SLOTTED_PAGE_TYPE;
+            apage->header.reserved = NIL;
             apage->header.free = 0;
             apage->header.unused = 0;
             apage->header.fid = catEntry->fid;
-            e = om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+            e = eduom_FileMapAddPage(catObjForFile, &nearPid, &pid);
             if(e < 0) ERRB1(e, &pid, PAGE_BUF);
         }
     }
@@ -183,12 +184,12 @@ Four eduom_CreateObject(
 
         if(availPage != NIL) {
             MAKE_PAGEID(pid, pFid.volNo, availPage);
-            e = BfM_GetNewTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+            e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
             if(e < 0) ERR(e);
-            e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+            e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
             if(e < 0) ERR(e);
             if(neededSpace > SP_CFREE(apage)) {
-                e = EduOM_CompactPage(apage, nearObj->slotNo);
+                e = EduOM_CompactPage(apage, NIL);
                 if(e < 0) ERR(e);
             }
         }
@@ -197,10 +198,10 @@ Four eduom_CreateObject(
             e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
             if(e < 0) ERR(e);
             if(neededSpace <= SP_FREE(apage)) {
-                e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+                e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
                 if(e < 0) ERR(e);
                 if(neededSpace > SP_CFREE(apage)) {
-                    e = EduOM_CompactPage(apage, nearObj->slotNo);
+                    e = EduOM_CompactPage(apage, NIL);
                     if(e < 0) ERR(e);
                 }
 
@@ -210,24 +211,21 @@ Four eduom_CreateObject(
                 if(e < 0) ERR(e);
                 MAKE_PAGEID(nearPid, pFid.volNo, catEntry->lastPage);
                 e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
-                if(e < 0) ERR(e);
+                if(e < 0) ERRBC1(e, catObjForFile);
                 e = BfM_GetNewTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
                 if(e < 0) ERR(e);
-                apage->header.flags = 0x2;
+                apage->header.pid = pid;
+                apage->header.flags = SLOTTED_PAGE_TYPE;
+                apage->header.reserved = NIL;
                 apage->header.free = 0;
                 apage->header.unused = 0;
                 apage->header.fid = catEntry->fid;
-                e = om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+                e = eduom_FileMapAddPage(catObjForFile, &nearPid, &pid);
                 if(e < 0) ERRB1(e, &pid, PAGE_BUF);
             }
         }
     }
-    i=0;
-    while(i < apage->header.nSlots) {
-        if(apage->slot[-i].offset == EMPTYSLOT)
-            break;
-        i++;
-    }
+    i = eduom_AllocSlot(apage);
     pslot = (SlottedPageSlot*)&(apage->slot[-i]);
     pslot->offset = apage->header.free;
     apage->header.free += sizeof(ObjectHdr) + alignedLen;
@@ -247,10 +245,10 @@ Four eduom_CreateObject(
     e = BfM_FreeTrain((TrainID*)&pid, PAGE_BUF);
     if(e < 0) ERR(e);
 
-    e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    e = eduom_PutInAvailSpace(catObjForFile, catEntry, &pid, apage);
     if(e < 0) ERRB1(e, &pid, PAGE_BUF);
 
-    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    e = eduom_FreeCatalogEntry(catObjForFile);
     if(e < 0) ERR(e);
 
     return(eNOERROR);
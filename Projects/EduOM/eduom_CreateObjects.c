@@ -0,0 +1,274 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_CreateObjects.c
+ *
+ * Description :
+ *  eduom_CreateObjects() creates new objects in a row, filling the pages
+ *  one after another.
+ *
+ * Exports:
+ *  Four eduom_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"		/* for the raw disk manager call */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: OM_NEEDEDSPACE(length)
+ * Description: return the space needed to put an object of the given length
+ */
+#define OM_NEEDEDSPACE(length) \
+    (sizeof(ObjectHdr) + ALIGNED_LENGTH(length) + sizeof(SlottedPageSlot))
+
+/* Macro: OM_EMPTYPAGESPACE
+ * Description: free space of an empty slotted page
+ */
+#define OM_EMPTYPAGESPACE   (PAGESIZE - sizeof(SlottedPageHdr))
+
+
+
+/*@================================
+ * eduom_ReleasePage()
+ *================================*/
+/*
+ * Function: static Four eduom_ReleasePage(ObjectID*, sm_CatOverlayForData*, PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Put a page filled by eduom_CreateObjects() back into the available
+ *  space list, and free its buffer.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_ReleasePage(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID      *pid,		/* IN page filled */
+    SlottedPage *apage)		/* IN buffer holding the page */
+{
+    Four        e;		/* error number */
+
+
+    e = BfM_SetDirty((TrainID*)pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = eduom_PutInAvailSpace(catObjForFile, catEntry, pid, apage);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID*)pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_ReleasePage() */
+
+
+
+/*@================================
+ * eduom_CreateObjects()
+ *================================*/
+/*
+ * Function: Four eduom_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ *
+ * Description :
+ *  eduom_CreateObjects() creates the given objects in a row. They are put
+ *  into the page holding the near object, or into the last page of the
+ *  file if 'nearObj' is NULL, and then into new pages linked one after
+ *  another behind it.
+ *  Each page is fixed once, and is taken out of and put back into the
+ *  available space list once, however many objects go into it. The new
+ *  pages are allocated in chunks, as many as the remaining objects surely
+ *  need, up to OM_CREATEOBJECTS_MAXPAGES at a time. The unique numbers
+ *  are taken from the page header while it has any left.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oids
+ *     oids[i] is set to the ObjectID of the i-th object created.
+ */
+Four eduom_CreateObjects(
+    ObjectID	*catObjForFile,	/* IN file in which objects are to be placed */
+    ObjectID 	*nearObj,	/* IN create the new objects near this object */
+    Four        nObjects,	/* IN # of objects to create */
+    ObjectHdr	*objHdrs,	/* IN objHdrs[i].tag is set to the i-th object; NULL for 0 */
+    Four	*lengths,	/* IN amount of data of each object */
+    char	**data,		/* IN the initial data of each object */
+    ObjectID	*oids)		/* OUT the ObjectIDs of the objects */
+{
+    Four        e;		/* error number */
+    sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+    PhysicalFileID pFid;	/* physical ID of the file */
+    Four        firstExt;	/* first Extent No of the file */
+    PageID      pid;		/* page being filled */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    PageID      newPages[OM_CREATEOBJECTS_MAXPAGES]; /* pages allocated not yet used */
+    Four        nNewPages;	/* # of pages in newPages[] */
+    Four        nextNewPage;	/* next page to use in newPages[] */
+    Four        restSpace;	/* space needed by the objects not yet created */
+    Four        neededSpace;	/* space needed to put the object */
+    Object      *obj;		/* points to the object created */
+    Two         slotNo;		/* slot of the object created */
+    Unique      unique;		/* unique number of the object created */
+    Four        k;		/* index variable */
+
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+    MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+    e = RDsM_PageIdToExtNo((PageID*)&pFid, &firstExt);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    if (nearObj != NULL)
+        MAKE_PAGEID(pid, nearObj->volNo, nearObj->pageNo);
+    else
+        MAKE_PAGEID(pid, pFid.volNo, catEntry->lastPage);
+
+    e = BfM_GetTrain((TrainID*)&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    e = eduom_RemoveFromAvailSpace(catObjForFile, &pid, apage);
+    if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+
+    for (restSpace = 0, k = 0; k < nObjects; k++)
+        restSpace += OM_NEEDEDSPACE(lengths[k]);
+
+    nNewPages = nextNewPage = 0;
+
+    for (k = 0; k < nObjects; k++) {
+
+        neededSpace = OM_NEEDEDSPACE(lengths[k]);
+
+        /*@ go on to the next page */
+        if (neededSpace > SP_FREE(apage)) {
+            e = eduom_ReleasePage(catObjForFile, catEntry, &pid, apage);
+            if (e < 0) ERRBC1(e, catObjForFile);
+
+            if (nextNewPage == nNewPages) {
+                nNewPages = (restSpace + OM_EMPTYPAGESPACE - 1) / OM_EMPTYPAGESPACE;
+                if (nNewPages > OM_CREATEOBJECTS_MAXPAGES) nNewPages = OM_CREATEOBJECTS_MAXPAGES;
+
+                e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &pid, catEntry->eff,
+                                     nNewPages, PAGESIZE2, newPages);
+                if (e < 0) ERRBC1(e, catObjForFile);
+                nextNewPage = 0;
+            }
+
+            e = BfM_GetNewTrain((TrainID*)&newPages[nextNewPage], (char**)&apage, PAGE_BUF);
+            if (e < 0) ERRBC1(e, catObjForFile);
+
+            apage->header.pid = newPages[nextNewPage];
+            apage->header.flags = SLOTTED_PAGE_TYPE;
+            apage->header.reserved = NIL;
+            apage->header.nSlots = 0;
+            apage->header.free = 0;
+            apage->header.unused = 0;
+            apage->header.fid = catEntry->fid;
+            apage->header.unique = 0;
+            apage->header.uniqueLimit = 0;
+            apage->header.spaceListPrev = NIL;
+            apage->header.spaceListNext = NIL;
+
+            e = eduom_FileMapAddPage(catObjForFile, &pid, &newPages[nextNewPage]);
+            pid = newPages[nextNewPage++];
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+        }
+
+        if (neededSpace > SP_CFREE(apage)) {
+            e = EduOM_CompactPage(apage, NIL);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+        }
+
+        /*@ put the object into the page */
+        slotNo = eduom_AllocSlot(apage);
+        apage->slot[-slotNo].offset = apage->header.free;
+
+        obj = (Object*)&(apage->data[apage->header.free]);
+        obj->header.properties = 0;
+        obj->header.tag = (objHdrs != NULL) ? objHdrs[k].tag : 0;
+        obj->header.length = lengths[k];
+        if (lengths[k] > 0) memcpy(obj->data, data[k], lengths[k]);
+
+        apage->header.free += sizeof(ObjectHdr) + ALIGNED_LENGTH(lengths[k]);
+        apage->header.nSlots = MAX(apage->header.nSlots, slotNo+1);
+
+        if (apage->header.unique < apage->header.uniqueLimit)
+            unique = apage->header.unique++;
+        else {
+            e = om_GetUnique(&pid, &unique);
+            if (e < 0) ERRBC2(e, &pid, PAGE_BUF, catObjForFile);
+        }
+        apage->slot[-slotNo].unique = unique;
+
+        MAKE_OBJECTID(oids[k], pid.volNo, pid.pageNo, slotNo, unique);
+
+        restSpace -= neededSpace;
+    }
+
+    e = eduom_ReleasePage(catObjForFile, catEntry, &pid, apage);
+    if (e < 0) ERRBC1(e, catObjForFile);
+
+    e = eduom_FreeCatalogEntry(catObjForFile);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_CreateObjects() */
@@ -0,0 +1,132 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_DestroyObjectInPage.c
+ *
+ * Description :
+ *  eduom_DestroyObjectInPage() removes an object from a slotted page
+ *  fixed by the caller.
+ *
+ * Exports:
+ *  Four eduom_DestroyObjectInPage(ObjectID*, PageID*, SlottedPage*, Two, Pool*, DeallocListElem*)
+ */
+
+
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * eduom_DestroyObjectInPage()
+ *================================*/
+/*
+ * Function: Four eduom_DestroyObjectInPage(ObjectID*, PageID*, SlottedPage*, Two, Pool*, DeallocListElem*)
+ *
+ * Description :
+ *  eduom_DestroyObjectInPage() deletes the object in the slot 'slotNo' of
+ *  the given page, dropping the LOT tree of a large object or the
+ *  forwarded record of a moved object, and updates 'unused', 'free' and
+ *  the slot array. The page must be fixed and taken out of the available
+ *  space list by the caller, who also decides what to do with the page
+ *  afterwards.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_DestroyObjectInPage(
+    ObjectID    *catObjForFile,	/* IN file containing the object */
+    PageID      *pid,		/* IN page holding the object */
+    SlottedPage *apage,		/* INOUT buffer holding the page */
+    Two         slotNo,		/* IN slot of the object */
+    Pool        *dlPool,	/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    Four        offset;		/* start offset of object in data area */
+    Object      *obj;		/* points to the object in data area */
+    Four        len;		/* length of object in the page including ObjectHdr */
+    ObjectID    fwdOid;		/* forwarded record of a moved object */
+
+
+    offset = apage->slot[-slotNo].offset;
+    obj = (Object*)&(apage->data[offset]);
+    len = OBJ_LENGTH_IN_PAGE(obj);
+
+    if (obj->header.properties & P_LRGOBJ) {
+        /* LOT_DestroyObject() also gives the space of the root back to the page */
+        e = LOT_DestroyObject(pid, slotNo, dlPool, dlHead);
+        if (e < 0) ERR(e);
+        len = 0;
+    }
+    else if (obj->header.properties & P_MOVED) {
+        fwdOid = *(ObjectID*)obj->data;
+        e = eduom_DestroyObject(catObjForFile, &fwdOid, TRUE, dlPool, dlHead);
+        if (e < 0) ERR(e);
+    }
+
+    apage->slot[-slotNo].offset = EMPTYSLOT;
+    if (slotNo == apage->header.nSlots - 1)
+        apage->header.nSlots -= 1;
+    else
+        eduom_FreeSlot(apage, slotNo);
+
+    /* a reused slot may hold an object which is not the last one in the data area */
+    if (offset + len == apage->header.free)
+        apage->header.free -= len;
+    else
+        apage->header.unused += len;
+
+    return(eNOERROR);
+
+} /* eduom_DestroyObjectInPage() */
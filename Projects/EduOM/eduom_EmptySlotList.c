@@ -0,0 +1,217 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_EmptySlotList.c
+ *
+ * Description :
+ *  Keep the list of the empty slots of a slotted page (see the empty slot
+ *  list section of EduOM_Internal.h).
+ *
+ * Exports:
+ *  Two eduom_AllocSlot(SlottedPage*)
+ *  void eduom_FreeSlot(SlottedPage*, Two)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: NEXT_EMPTYSLOT(p, i)
+ * Description: the empty slot following the empty slot 'i' in the list
+ */
+#define NEXT_EMPTYSLOT(p, i)    ((p)->slot[-(i)].unique)
+
+/* Macro: EMPTYSLOT_LINK_OK(p, prev, next)
+ * Description: TRUE if 'next' may follow 'prev' in the list, i.e. it ends
+ *              the list or is an empty slot below nSlots after 'prev'.
+ *              The list is ascending, so no valid list has a cycle.
+ */
+#define EMPTYSLOT_LINK_OK(p, prev, next) \
+    ((next) == NIL || \
+     ((next) > (prev) && (next) < (p)->header.nSlots && (p)->slot[-(next)].offset == EMPTYSLOT))
+
+
+
+/*@================================
+ * eduom_BuildEmptySlotList()
+ *================================*/
+/*
+ * Function: static void eduom_BuildEmptySlotList(SlottedPage*)
+ *
+ * Description :
+ *  Build the list of the empty slots by scanning the slot array.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_BuildEmptySlotList(
+    SlottedPage *apage)		/* INOUT page whose list is built */
+{
+    Two         head;		/* first empty slot */
+    Two         i;		/* index variable */
+
+
+    head = NIL;
+    for (i = apage->header.nSlots - 1; i >= 0; i--)
+        if (apage->slot[-i].offset == EMPTYSLOT) {
+            NEXT_EMPTYSLOT(apage, i) = (Unique)head;
+            head = i;
+        }
+
+    apage->header.reserved = head;
+    apage->header.flags |= SP_EMPTYSLOTLIST;
+
+} /* eduom_BuildEmptySlotList() */
+
+
+
+/*@================================
+ * eduom_AllocSlot()
+ *================================*/
+/*
+ * Function: Two eduom_AllocSlot(SlottedPage*)
+ *
+ * Description :
+ *  Take the lowest empty slot of the page off the list. If there is no
+ *  empty slot, the slot following the last one is returned; the caller
+ *  adjusts nSlots when it uses the slot.
+ *
+ * Returns:
+ *  slot number
+ */
+Two eduom_AllocSlot(
+    SlottedPage *apage)		/* INOUT page where a slot is needed */
+{
+    Two         i;		/* slot taken */
+
+
+    if (!(apage->header.flags & SP_EMPTYSLOTLIST))
+        eduom_BuildEmptySlotList(apage);
+
+    i = (Two)apage->header.reserved;
+
+    /*@ rebuild the list if the page was changed behind it */
+    if (!EMPTYSLOT_LINK_OK(apage, -1, i) ||
+        (i != NIL && !EMPTYSLOT_LINK_OK(apage, i, (Two)NEXT_EMPTYSLOT(apage, i)))) {
+        eduom_BuildEmptySlotList(apage);
+        i = (Two)apage->header.reserved;
+    }
+
+    if (i == NIL) return(apage->header.nSlots);
+
+    apage->header.reserved = (Two)NEXT_EMPTYSLOT(apage, i);
+
+    return(i);
+
+} /* eduom_AllocSlot() */
+
+
+
+/*@================================
+ * eduom_FreeSlot()
+ *================================*/
+/*
+ * Function: void eduom_FreeSlot(SlottedPage*, Two)
+ *
+ * Description :
+ *  Put a slot which was emptied below nSlots into the list, keeping the
+ *  list in ascending order. Only the empty slots below the given one are
+ *  visited. If a link on the way is not valid, the list is dropped and
+ *  built again from the slot array, which already has the given slot
+ *  empty.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FreeSlot(
+    SlottedPage *apage,		/* INOUT page of the slot */
+    Two         slotNo)		/* IN slot emptied */
+{
+    Two         prev;		/* empty slot preceding the given one */
+    Two         next;		/* empty slot following 'prev' */
+
+
+    if (!(apage->header.flags & SP_EMPTYSLOTLIST)) {
+        eduom_BuildEmptySlotList(apage);
+        return;
+    }
+
+    next = (Two)apage->header.reserved;
+    if (!EMPTYSLOT_LINK_OK(apage, -1, next) || next == slotNo) {
+        apage->header.flags &= ~SP_EMPTYSLOTLIST;
+        eduom_BuildEmptySlotList(apage);
+        return;
+    }
+
+    if (next == NIL || next > slotNo) {
+        NEXT_EMPTYSLOT(apage, slotNo) = (Unique)next;
+        apage->header.reserved = slotNo;
+        return;
+    }
+
+    do {
+        prev = next;
+        next = (Two)NEXT_EMPTYSLOT(apage, prev);
+
+        /*@ drop the list if the page was changed behind it */
+        if (!EMPTYSLOT_LINK_OK(apage, prev, next) || next == slotNo) {
+            apage->header.flags &= ~SP_EMPTYSLOTLIST;
+            eduom_BuildEmptySlotList(apage);
+            return;
+        }
+    } while (next != NIL && next < slotNo);
+
+    NEXT_EMPTYSLOT(apage, slotNo) = (Unique)next;
+    NEXT_EMPTYSLOT(apage, prev) = (Unique)slotNo;
+
+} /* eduom_FreeSlot() */
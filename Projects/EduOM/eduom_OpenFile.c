@@ -0,0 +1,705 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_OpenFile.c
+ *
+ * Description :
+ *  Keep the open data files, get their catalog entries, and record the
+ *  free space of their pages in the available space lists, whose heads are
+ *  kept in memory while a file is open (see the open files section of
+ *  EduOM_Internal.h).
+ *
+ * Exports:
+ *  Four eduom_OpenFile(ObjectID*)
+ *  Four eduom_CloseFile(ObjectID*)
+ *  eduom_OpenFile_T *eduom_FindOpenFile(ObjectID*)
+ *  Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**)
+ *  Four eduom_FreeCatalogEntry(ObjectID*)
+ *  Four eduom_RemoveFromAvailSpace(ObjectID*, PageID*, SlottedPage*)
+ *  Four eduom_PutInAvailSpace(ObjectID*, sm_CatOverlayForData*, PageID*, SlottedPage*)
+ *  Four eduom_FileMapAddPage(ObjectID*, PageID*, PageID*)
+ *  Four eduom_FileMapDeletePage(ObjectID*, sm_CatOverlayForData*, PageID*)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: EQUAL_CATOBJ(x, y)
+ * Description: TRUE if the two catalog objects are the same
+ */
+#define EQUAL_CATOBJ(x, y) \
+    ((x).volNo == (y).volNo && (x).pageNo == (y).pageNo && (x).slotNo == (y).slotNo)
+
+
+/*@
+ * global variables
+ */
+/* open data files */
+static eduom_OpenFile_T *eduom_openFileList = NULL;
+
+
+
+/*@================================
+ * eduom_ReadCatalogEntry()
+ *================================*/
+/*
+ * Function: static Four eduom_ReadCatalogEntry(ObjectID*, sm_CatOverlayForData*)
+ *
+ * Description :
+ *  Copy the catalog entry of a data file from its catalog object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_ReadCatalogEntry(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    sm_CatOverlayForData *copy)	/* OUT copy of the catalog entry */
+{
+    Four        e;		/* error number */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    *copy = *catEntry;
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_ReadCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_RereadCatalogEntry()
+ *================================*/
+/*
+ * Function: static Four eduom_RereadCatalogEntry(eduom_OpenFile_T*)
+ *
+ * Description :
+ *  Copy the catalog entry of an open file again after its page list has
+ *  changed, keeping the heads of the available space lists of the copy,
+ *  which are newer than those in the catalog object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_RereadCatalogEntry(
+    eduom_OpenFile_T *f)	/* IN open file */
+{
+    Four        e;		/* error number */
+    sm_CatOverlayForData copy;	/* copy of the catalog entry */
+
+
+    e = eduom_ReadCatalogEntry(&f->catObjForFile, &copy);
+    if (e < 0) ERR(e);
+
+    copy.availSpaceList10 = f->catEntry.availSpaceList10;
+    copy.availSpaceList20 = f->catEntry.availSpaceList20;
+    copy.availSpaceList30 = f->catEntry.availSpaceList30;
+    copy.availSpaceList40 = f->catEntry.availSpaceList40;
+    copy.availSpaceList50 = f->catEntry.availSpaceList50;
+    f->catEntry = copy;
+
+    return(eNOERROR);
+
+} /* eduom_RereadCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_WriteAvailSpaceLists()
+ *================================*/
+/*
+ * Function: static Four eduom_WriteAvailSpaceLists(eduom_OpenFile_T*)
+ *
+ * Description :
+ *  Write the heads of the available space lists of an open file back to
+ *  its catalog object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_WriteAvailSpaceLists(
+    eduom_OpenFile_T *f)	/* IN open file */
+{
+    Four        e;		/* error number */
+    ObjectID    *catObjForFile;	/* catalog object of the file */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    catObjForFile = &f->catObjForFile;
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    catEntry->availSpaceList10 = f->catEntry.availSpaceList10;
+    catEntry->availSpaceList20 = f->catEntry.availSpaceList20;
+    catEntry->availSpaceList30 = f->catEntry.availSpaceList30;
+    catEntry->availSpaceList40 = f->catEntry.availSpaceList40;
+    catEntry->availSpaceList50 = f->catEntry.availSpaceList50;
+
+    e = BfM_SetDirty((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERRB1(e, catObjForFile, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_WriteAvailSpaceLists() */
+
+
+
+/*@================================
+ * eduom_AvailSpaceList()
+ *================================*/
+/*
+ * Function: static ShortPageID *eduom_AvailSpaceList(sm_CatOverlayForData*, SlottedPage*)
+ *
+ * Description :
+ *  Find the available space list a page belongs in by its free space, as
+ *  the storage manager does: the 10..40% lists for a page with at least
+ *  that fraction of its data area free, the 50% list above that.
+ *
+ * Returns:
+ *  the head of the list in the catalog entry, or NULL if the page has
+ *  less than 10% free and is not kept in any list
+ */
+static ShortPageID *eduom_AvailSpaceList(
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    SlottedPage *apage)		/* IN buffer holding the page */
+{
+    Four        ratio;		/* free space in tenths of the data area */
+
+
+    ratio = (10 * (Four)SP_FREE(apage)) / (Four)(PAGESIZE - SP_FIXED);
+
+    switch (ratio) {
+      case 0:
+        return(NULL);
+      case 1:
+        return(&catEntry->availSpaceList10);
+      case 2:
+        return(&catEntry->availSpaceList20);
+      case 3:
+        return(&catEntry->availSpaceList30);
+      case 4:
+        return(&catEntry->availSpaceList40);
+      default:
+        return(&catEntry->availSpaceList50);
+    }
+
+} /* eduom_AvailSpaceList() */
+
+
+
+/*@================================
+ * eduom_SetSpaceListLink()
+ *================================*/
+/*
+ * Function: static Four eduom_SetSpaceListLink(PageID*, ShortPageID, Boolean, ShortPageID)
+ *
+ * Description :
+ *  Set the previous or the next link in the available space list of a
+ *  page of the file which is not fixed by the caller.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_SetSpaceListLink(
+    PageID      *pid,		/* IN page of the file the list is in */
+    ShortPageID pageNo,		/* IN page whose link is set */
+    Boolean     next,		/* IN TRUE for the next link, FALSE for the previous one */
+    ShortPageID link)		/* IN new link */
+{
+    Four        e;		/* error number */
+    PageID      linkPid;	/* page whose link is set */
+    SlottedPage *linkPage;	/* buffer holding the page */
+
+
+    MAKE_PAGEID(linkPid, pid->volNo, pageNo);
+
+    e = BfM_GetTrain((TrainID*)&linkPid, (char**)&linkPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (next)
+        linkPage->header.spaceListNext = link;
+    else
+        linkPage->header.spaceListPrev = link;
+
+    e = BfM_SetDirty((TrainID*)&linkPid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &linkPid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID*)&linkPid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_SetSpaceListLink() */
+
+
+
+/*@================================
+ * eduom_FindOpenFile()
+ *================================*/
+/*
+ * Function: eduom_OpenFile_T *eduom_FindOpenFile(ObjectID*)
+ *
+ * Description :
+ *  Find the open file of the given catalog object.
+ *
+ * Returns:
+ *  the open file, or NULL if the file is not open
+ */
+eduom_OpenFile_T *eduom_FindOpenFile(
+    ObjectID    *catObjForFile)	/* IN catalog object of the file */
+{
+    eduom_OpenFile_T *f;	/* open file */
+
+
+    for (f = eduom_openFileList; f != NULL; f = f->next)
+        if (EQUAL_CATOBJ(f->catObjForFile, *catObjForFile)) break;
+
+    return(f);
+
+} /* eduom_FindOpenFile() */
+
+
+
+/*@================================
+ * eduom_OpenFile()
+ *================================*/
+/*
+ * Function: Four eduom_OpenFile(ObjectID*)
+ *
+ * Description :
+ *  Open a data file, or count one more open of a file already open, whose
+ *  catalog entry is copied.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCFAILED_EDUOM
+ *    some errors caused by function calls
+ */
+Four eduom_OpenFile(
+    ObjectID    *catObjForFile)	/* IN catalog object of the file */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T *f;	/* open file */
+
+
+    f = eduom_FindOpenFile(catObjForFile);
+    if (f != NULL) {
+        f->nOpens++;
+        return(eNOERROR);
+    }
+
+    f = (eduom_OpenFile_T*)malloc(sizeof(eduom_OpenFile_T));
+    if (f == NULL) ERR(eMEMALLOCFAILED_EDUOM);
+
+    f->catObjForFile = *catObjForFile;
+    f->nOpens = 1;
+
+    e = eduom_ReadCatalogEntry(catObjForFile, &f->catEntry);
+    if (e < 0) {
+        free(f);
+        ERR(e);
+    }
+
+    f->next = eduom_openFileList;
+    eduom_openFileList = f;
+
+    return(eNOERROR);
+
+} /* eduom_OpenFile() */
+
+
+
+/*@================================
+ * eduom_CloseFile()
+ *================================*/
+/*
+ * Function: Four eduom_CloseFile(ObjectID*)
+ *
+ * Description :
+ *  Close a data file. When it is closed as many times as it was opened,
+ *  the heads of the available space lists kept in its copy of the catalog
+ *  entry are written back to the catalog object and the copy is dropped.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four eduom_CloseFile(
+    ObjectID    *catObjForFile)	/* IN catalog object of the file */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T **prev;	/* link to the open file */
+    eduom_OpenFile_T *f;	/* open file */
+
+
+    for (prev = &eduom_openFileList; *prev != NULL; prev = &(*prev)->next)
+        if (EQUAL_CATOBJ((*prev)->catObjForFile, *catObjForFile)) break;
+
+    if ((f = *prev) == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (f->nOpens > 1) {
+        f->nOpens--;
+        return(eNOERROR);
+    }
+
+    e = eduom_WriteAvailSpaceLists(f);
+    if (e < 0) ERR(e);
+
+    *prev = f->next;
+    free(f);
+
+    return(eNOERROR);
+
+} /* eduom_CloseFile() */
+
+
+
+/*@================================
+ * eduom_GetCatalogEntry()
+ *================================*/
+/*
+ * Function: Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**)
+ *
+ * Description :
+ *  Get the catalog entry of a data file: the copy kept in memory if the
+ *  file is open, or else the entry in the catalog object, whose page is
+ *  fixed until eduom_FreeCatalogEntry() is called.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter catEntry
+ *     catEntry is set to point to the catalog entry
+ */
+Four eduom_GetCatalogEntry(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    sm_CatOverlayForData **catEntry) /* OUT catalog entry of the file */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T *f;	/* open file */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+
+
+    f = eduom_FindOpenFile(catObjForFile);
+    if (f != NULL) {
+        *catEntry = &f->catEntry;
+        return(eNOERROR);
+    }
+
+    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, *catEntry);
+
+    return(eNOERROR);
+
+} /* eduom_GetCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_FreeCatalogEntry()
+ *================================*/
+/*
+ * Function: Four eduom_FreeCatalogEntry(ObjectID*)
+ *
+ * Description :
+ *  Release the catalog entry got by eduom_GetCatalogEntry(), freeing the
+ *  catalog page unless the file is open.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FreeCatalogEntry(
+    ObjectID    *catObjForFile)	/* IN catalog object of the file */
+{
+    Four        e;		/* error number */
+
+
+    if (eduom_FindOpenFile(catObjForFile) != NULL) return(eNOERROR);
+
+    e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_FreeCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_RemoveFromAvailSpace()
+ *================================*/
+/*
+ * Function: Four eduom_RemoveFromAvailSpace(ObjectID*, PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Take a page out of the available space lists before it is changed. If
+ *  the file is open, the heads of the lists are those of its copy of the
+ *  catalog entry, so the catalog page is not fixed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_RemoveFromAvailSpace(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    PageID      *pid,		/* IN page to remove */
+    SlottedPage *apage)		/* IN buffer holding the page */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T *f;	/* open file */
+    ShortPageID *head;		/* head of the list the page is in */
+    ShortPageID prev;		/* previous page in the list */
+    ShortPageID next;		/* next page in the list */
+
+
+    f = eduom_FindOpenFile(catObjForFile);
+    if (f == NULL) {
+        e = om_RemoveFromAvailSpaceList(catObjForFile, pid, apage);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    if (eduom_AvailSpaceList(&f->catEntry, apage) == NULL) return(eNOERROR);
+
+    prev = apage->header.spaceListPrev;
+    next = apage->header.spaceListNext;
+
+    if (prev != NIL) {
+        e = eduom_SetSpaceListLink(pid, prev, TRUE, next);
+        if (e < 0) ERR(e);
+    }
+    else {
+        /* the first page of a list is the one its head points to */
+        if (f->catEntry.availSpaceList10 == pid->pageNo) head = &f->catEntry.availSpaceList10;
+        else if (f->catEntry.availSpaceList20 == pid->pageNo) head = &f->catEntry.availSpaceList20;
+        else if (f->catEntry.availSpaceList30 == pid->pageNo) head = &f->catEntry.availSpaceList30;
+        else if (f->catEntry.availSpaceList40 == pid->pageNo) head = &f->catEntry.availSpaceList40;
+        else if (f->catEntry.availSpaceList50 == pid->pageNo) head = &f->catEntry.availSpaceList50;
+        else return(eNOERROR);	/* not in any list */
+
+        *head = next;
+    }
+
+    if (next != NIL) {
+        e = eduom_SetSpaceListLink(pid, next, FALSE, prev);
+        if (e < 0) ERR(e);
+    }
+
+    apage->header.spaceListPrev = NIL;
+    apage->header.spaceListNext = NIL;
+
+    e = BfM_SetDirty((TrainID*)pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_RemoveFromAvailSpace() */
+
+
+
+/*@================================
+ * eduom_PutInAvailSpace()
+ *================================*/
+/*
+ * Function: Four eduom_PutInAvailSpace(ObjectID*, sm_CatOverlayForData*, PageID*, SlottedPage*)
+ *
+ * Description :
+ *  Record the free space of a page after it is changed in the available
+ *  space lists. If the file is open, the page is put at the head of a list
+ *  in its copy of the catalog entry, which is written back to the catalog
+ *  object when the file is closed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_PutInAvailSpace(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID      *pid,		/* IN page changed */
+    SlottedPage *apage)		/* IN buffer holding the page */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T *f;	/* open file */
+    ShortPageID *head;		/* head of the list the page belongs in */
+
+
+    f = eduom_FindOpenFile(catObjForFile);
+    if (f == NULL) {
+        e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    head = eduom_AvailSpaceList(&f->catEntry, apage);
+    if (head == NULL) return(eNOERROR);
+
+    apage->header.spaceListPrev = NIL;
+    apage->header.spaceListNext = *head;
+    *head = pid->pageNo;
+
+    e = BfM_SetDirty((TrainID*)pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (apage->header.spaceListNext != NIL) {
+        e = eduom_SetSpaceListLink(pid, apage->header.spaceListNext, FALSE, pid->pageNo);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_PutInAvailSpace() */
+
+
+
+/*@================================
+ * eduom_FileMapAddPage()
+ *================================*/
+/*
+ * Function: Four eduom_FileMapAddPage(ObjectID*, PageID*, PageID*)
+ *
+ * Description :
+ *  Link a new page into the page list of a data file after the given page,
+ *  reading the copy of the catalog entry again if the file is open.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FileMapAddPage(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    PageID      *prevPid,	/* IN page after which the new page is linked */
+    PageID      *newPid)	/* IN new page */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T *f;	/* open file */
+
+
+    e = om_FileMapAddPage(catObjForFile, prevPid, newPid);
+    if (e < 0) ERR(e);
+
+    f = eduom_FindOpenFile(catObjForFile);
+    if (f != NULL) {
+        e = eduom_RereadCatalogEntry(f);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_FileMapAddPage() */
+
+
+
+/*@================================
+ * eduom_FileMapDeletePage()
+ *================================*/
+/*
+ * Function: Four eduom_FileMapDeletePage(ObjectID*, sm_CatOverlayForData*, PageID*)
+ *
+ * Description :
+ *  Unlink a page to be deallocated from the page list of a data file,
+ *  reading the copy of the catalog entry again if the file is open.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FileMapDeletePage(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID      *pid)		/* IN page to unlink */
+{
+    Four        e;		/* error number */
+    eduom_OpenFile_T *f;	/* open file */
+
+
+    e = om_FileMapDeletePage(catObjForFile, pid);
+    if (e < 0) ERR(e);
+
+    f = eduom_FindOpenFile(catObjForFile);
+    if (f != NULL) {
+        e = eduom_RereadCatalogEntry(f);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_FileMapDeletePage() */
@@ -0,0 +1,308 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_ScanCursor.c
+ *
+ * Description :
+ *  Move a scan cursor (see the scan cursor section of EduOM_Internal.h).
+ *
+ * Exports:
+ *  Four eduom_ScanFindSlot(EduOM_ScanCursor*, Two, Two*)
+ *  Four eduom_ScanNextSlot(EduOM_ScanCursor*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: OM_FILTER_COMPARE(a, b)
+ * Description: return -1, 0 or 1 as 'a' is less than, equal to or greater than 'b'
+ */
+#define OM_FILTER_COMPARE(a, b)     (((a) < (b)) ? -1 : ((a) > (b)))
+
+
+
+/*@================================
+ * eduom_FilterHolds()
+ *================================*/
+/*
+ * Function: static Boolean eduom_FilterHolds(Four, Two)
+ *
+ * Description :
+ *  Tell whether a comparison holds, given the result of comparing the
+ *  field with the constant as memcmp() returns it.
+ *
+ * Returns:
+ *  TRUE if the comparison holds
+ */
+static Boolean eduom_FilterHolds(
+    Four        cmp,		/* IN negative, zero or positive as the field is less than, equal to or greater than the constant */
+    Two         op)		/* IN comparison */
+{
+    switch (op) {
+      case OM_FILTER_EQ: return(cmp == 0);
+      case OM_FILTER_NE: return(cmp != 0);
+      case OM_FILTER_LT: return(cmp < 0);
+      case OM_FILTER_LE: return(cmp <= 0);
+      case OM_FILTER_GT: return(cmp > 0);
+      default:           return(cmp >= 0);
+    }
+
+} /* eduom_FilterHolds() */
+
+
+
+/*@================================
+ * eduom_FilterObject()
+ *================================*/
+/*
+ * Function: static Four eduom_FilterObject(EduOM_ScanFilter*, PageID*, SlottedPage*, Two)
+ *
+ * Description :
+ *  Evaluate the filter on an object of the fixed page. The conditions are
+ *  evaluated on the page, except that the bytes of a large or a moved
+ *  object compared by a condition are read by EduOM_ReadObject(); a
+ *  condition on the data fails if the object is too short for it. The
+ *  function of the filter is called last, only if all the conditions hold.
+ *
+ * Returns:
+ *  TRUE if the object is taken, FALSE if it is skipped, or an error code
+ *    some errors caused by function calls
+ */
+static Four eduom_FilterObject(
+    EduOM_ScanFilter *filter,	/* IN filter to evaluate */
+    PageID      *pid,		/* IN page of the object */
+    SlottedPage *apage,		/* IN buffer holding the page */
+    Two         slotNo)		/* IN slot of the object */
+{
+    Four        e;		/* error number */
+    Object      *obj;		/* object filtered */
+    ObjectID    oid;		/* ID of the object */
+    EduOM_FilterCond *cond;	/* condition evaluated */
+    Four        k;		/* index variable */
+    Four        len;		/* # of bytes of the data compared */
+    Four        cmp;		/* result of the comparison */
+    Four        v;		/* Four in the data */
+    char        *p;		/* bytes of the data compared */
+    char        buf[OM_FILTER_MAXBYTES]; /* bytes read from a large or a moved object */
+    Boolean     inPage;		/* TRUE if the data is in the page */
+
+
+    obj = (Object*)&(apage->data[apage->slot[-slotNo].offset]);
+    MAKE_OBJECTID(oid, pid->volNo, pid->pageNo, slotNo, apage->slot[-slotNo].unique);
+    inPage = !(obj->header.properties & (P_LRGOBJ | P_MOVED));
+
+    for (k = 0; k < filter->nConds; k++) {
+        cond = &filter->conds[k];
+
+        if (cond->field == OM_FILTER_TAG)
+            cmp = OM_FILTER_COMPARE(obj->header.tag, cond->value);
+        else if (cond->field == OM_FILTER_LENGTH)
+            cmp = OM_FILTER_COMPARE(obj->header.length, cond->value);
+        else {
+            len = (cond->field == OM_FILTER_FOUR) ? sizeof(Four) : cond->length;
+            if (cond->start + len > obj->header.length) return(FALSE);
+
+            if (inPage)
+                p = &(obj->data[cond->start]);
+            else {
+                e = EduOM_ReadObject(&oid, cond->start, len, buf);
+                if (e < 0) ERR(e);
+                p = buf;
+            }
+
+            if (cond->field == OM_FILTER_FOUR) {
+                memcpy(&v, p, sizeof(Four));
+                cmp = OM_FILTER_COMPARE(v, cond->value);
+            }
+            else
+                cmp = memcmp(p, cond->bytes, len);
+        }
+
+        if (!eduom_FilterHolds(cmp, cond->op)) return(FALSE);
+    }
+
+    if (filter->func == NULL) return(TRUE);
+
+    e = filter->func(filter->arg, &oid, &(obj->header), inPage ? obj->data : NULL);
+    if (e < 0) ERR(e);
+
+    return(e ? TRUE : FALSE);
+
+} /* eduom_FilterObject() */
+
+
+
+/*@================================
+ * eduom_ScanFindSlot()
+ *================================*/
+/*
+ * Function: Four eduom_ScanFindSlot(EduOM_ScanCursor*, Two, Two*)
+ *
+ * Description :
+ *  Find the first slot from 'from' on in the page the cursor is on which
+ *  holds an object to be returned by the scan: the empty slots and the
+ *  forwarded records are skipped, and so are the objects rejected by the
+ *  filter of the cursor, if any. The cursor is not moved.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter slotNo
+ *     the slot found; nSlots of the page if there is none
+ */
+Four eduom_ScanFindSlot(
+    EduOM_ScanCursor *cursor,	/* IN cursor of the scan */
+    Two         from,		/* IN first slot to look at */
+    Two         *slotNo)	/* OUT slot found */
+{
+    Four        e;		/* error number */
+    SlottedPage *apage;		/* page the cursor is on */
+    Two         i;		/* slot index */
+
+
+    apage = cursor->apage;
+
+    for (i = from; i < apage->header.nSlots; i++) {
+        if (!IS_SCANNED_SLOT(apage, i)) continue;
+
+        if (cursor->filter == NULL) break;
+
+        e = eduom_FilterObject(cursor->filter, &cursor->pid, apage, i);
+        if (e < 0) ERR(e);
+        if (e == TRUE) break;
+    }
+
+    *slotNo = i;
+
+    return(eNOERROR);
+
+} /* eduom_ScanFindSlot() */
+
+
+
+/*@================================
+ * eduom_ScanNextSlot()
+ *================================*/
+/*
+ * Function: Four eduom_ScanNextSlot(EduOM_ScanCursor*)
+ *
+ * Description :
+ *  Move the cursor to the next object of the file. The empty slots, the
+ *  forwarded records and the objects rejected by the filter of the cursor
+ *  are skipped in one pass over the slot array; at the end of the
+ *  page the cursor goes on to the next page of the file, which is fixed
+ *  in place of the current one.
+ *
+ * Returns:
+ *  error code
+ *    EOS - there is no more object
+ *    some errors caused by function calls
+ */
+Four eduom_ScanNextSlot(
+    EduOM_ScanCursor *cursor)	/* INOUT cursor to move */
+{
+    Four        e;		/* error number */
+    PageNo      nextPage;	/* page following the current one */
+    Two         i;		/* slot index */
+
+
+    if (!cursor->started) {
+        cursor->started = TRUE;
+        cursor->pid.pageNo = cursor->firstPage;
+        cursor->slotNo = NIL;
+
+        e = BfM_GetTrain((TrainID*)&cursor->pid, (char**)&cursor->apage, PAGE_BUF);
+        if (e < 0) {
+            cursor->pid.pageNo = NIL;
+            ERR(e);
+        }
+    }
+
+    while (cursor->pid.pageNo != NIL) {
+
+        e = eduom_ScanFindSlot(cursor, cursor->slotNo + 1, &i);
+        if (e < 0) ERR(e);
+
+        if (i < cursor->apage->header.nSlots) {
+            cursor->slotNo = i;
+            return(eNOERROR);
+        }
+
+        /*@ go on to the next page */
+        nextPage = cursor->apage->header.nextPage;
+
+        e = BfM_FreeTrain((TrainID*)&cursor->pid, PAGE_BUF);
+        cursor->pid.pageNo = NIL;
+        if (e < 0) ERR(e);
+
+        if (nextPage != NIL) {
+            cursor->pid.pageNo = nextPage;
+            cursor->slotNo = NIL;
+
+            e = BfM_GetTrain((TrainID*)&cursor->pid, (char**)&cursor->apage, PAGE_BUF);
+            if (e < 0) {
+                cursor->pid.pageNo = NIL;
+                ERR(e);
+            }
+        }
+    }
+
+    return(EOS);
+
+} /* eduom_ScanNextSlot() */